@@ -0,0 +1,58 @@
+#include <SimpleCPP/async_reader.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t FILE_SIZE = 64 << 20;
+constexpr size_t READ_SIZE = 16384;
+constexpr size_t COUNT = FILE_SIZE / READ_SIZE;
+
+using Pool = simplecpp::BufferPool<READ_SIZE, 128>;
+using Reader = simplecpp::AsyncReader<Pool>;
+
+/**
+ * @brief Reads the whole file in READ_SIZE chunks, keeping queue_depth reads in flight.
+ */
+void bench(const char* name, int fd, Reader::Backend backend, unsigned queue_depth) {
+  Reader reader(queue_depth, backend);
+  run(name, COUNT, [&] {
+    size_t bytes = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      reader.read(fd, i * READ_SIZE, READ_SIZE, i);
+      if (reader.in_flight() == queue_depth) {
+        reader.poll([&](Reader::Completion&& c) { bytes += c.data.size(); }, 1);
+      }
+    }
+    while (reader.in_flight() != 0) {
+      reader.poll([&](Reader::Completion&& c) { bytes += c.data.size(); }, 1);
+    }
+    keep(bytes);
+  });
+}
+
+int main() {
+  char path[] = "/tmp/simplecpp_async_reader_XXXXXX";
+  const int fd = mkstemp(path);
+  unlink(path);
+  const std::string chunk(1 << 20, 'x');
+  for (size_t written = 0; written < FILE_SIZE; written += chunk.size()) {
+    keep(::write(fd, chunk.data(), chunk.size()));
+  }
+
+  std::vector<char> buffer(READ_SIZE);
+  run("blocking pread", COUNT, [&] {
+    size_t bytes = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      bytes += ::pread(fd, buffer.data(), READ_SIZE, static_cast<off_t>(i * READ_SIZE));
+    }
+    keep(bytes);
+  });
+  bench("simplecpp::AsyncReader io_uring (depth 32)", fd, Reader::Backend::kIoUring, 32);
+  bench("simplecpp::AsyncReader thread pool (depth 32)", fd, Reader::Backend::kThreadPool, 32);
+  ::close(fd);
+}
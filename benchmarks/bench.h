@@ -0,0 +1,36 @@
+#ifndef SIMPLECPP_BENCHMARKS_BENCH_H_
+#define SIMPLECPP_BENCHMARKS_BENCH_H_
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @brief Runs fn the given number of times and prints the best time per operation.
+ *
+ * @param name The label printed before the result
+ * @param ops The number of operations a single call of fn performs
+ */
+template <typename Fn>
+void run(const char* name, size_t ops, Fn&& fn, int repeats = 5) {
+  double best = 0;
+  for (int i = 0; i < repeats; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / ops;
+    if (i == 0 || ns < best) {
+      best = ns;
+    }
+  }
+  std::printf("%-48s %10.2f ns/op\n", name, best);
+}
+
+/**
+ * @brief Prevents the compiler from optimizing away value.
+ */
+template <typename T>
+void keep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif  // SIMPLECPP_BENCHMARKS_BENCH_H_
@@ -0,0 +1,96 @@
+#include <SimpleCPP/btree_map.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "bench.h"
+
+size_t std_map_bytes = 0;
+
+/**
+ * @brief Counts the bytes std::map allocates for its nodes.
+ */
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  CountingAllocator() = default;
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    std_map_bytes += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, size_t n) noexcept {
+    std_map_bytes -= n * sizeof(T);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  friend bool operator==(const CountingAllocator&, const CountingAllocator&) { return true; }
+};
+
+using StdMap = std::map<uint64_t, uint64_t, std::less<uint64_t>,
+                        CountingAllocator<std::pair<const uint64_t, uint64_t>>>;
+using BTree = simplecpp::BTreeMap<uint64_t, uint64_t>;
+
+uint64_t key_at(uint64_t i) { return (i * 0x9E3779B97F4A7C15ULL) >> 16; }
+
+int main() {
+  for (size_t n = 1000; n <= 10000000; n *= 10) {
+    std::printf("%zu keys\n", n);
+    StdMap tree{};
+    BTree btree{};
+    run("  std::map insert", n, [&] {
+      tree.clear();
+      for (uint64_t i = 0; i < n; ++i) {
+        tree.emplace(key_at(i), i);
+      }
+    }, 1);
+    run("  simplecpp::BTreeMap insert", n, [&] {
+      btree.clear();
+      for (uint64_t i = 0; i < n; ++i) {
+        btree.insert(key_at(i), i);
+      }
+    }, 1);
+    run("  std::map find", n, [&] {
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < n; ++i) {
+        sum += tree.find(key_at(i))->second;
+      }
+      keep(sum);
+    });
+    run("  simplecpp::BTreeMap find", n, [&] {
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < n; ++i) {
+        sum += btree.find(key_at(i)).value();
+      }
+      keep(sum);
+    });
+    run("  std::map scan", n, [&] {
+      uint64_t sum = 0;
+      for (const auto& [key, value] : tree) {
+        sum += value;
+      }
+      keep(sum);
+    });
+    run("  simplecpp::BTreeMap scan", n, [&] {
+      uint64_t sum = 0;
+      for (const auto [key, value] : btree) {
+        sum += value;
+      }
+      keep(sum);
+    });
+    std::printf("  %-46s %10.2f bytes/key\n", "std::map memory (without malloc overhead)",
+                static_cast<double>(std_map_bytes) / n);
+    std::printf("  %-46s %10.2f bytes/key\n", "simplecpp::BTreeMap memory",
+                static_cast<double>(btree.memory_usage()) / n);
+
+    simplecpp::BTreeMap<uint64_t, uint64_t> loaded{};
+    loaded.bulk_load(tree.begin(), tree.end());
+    std::printf("  %-46s %10.2f bytes/key\n", "simplecpp::BTreeMap memory after bulk_load",
+                static_cast<double>(loaded.memory_usage()) / n);
+  }
+}
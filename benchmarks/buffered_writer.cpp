@@ -0,0 +1,52 @@
+#include <SimpleCPP/buffered_writer.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t COUNT = 1 << 21;
+
+/**
+ * @brief Returns log records of 40 to 120 characters.
+ */
+std::vector<std::string> make_records(size_t count) {
+  std::vector<std::string> records(count);
+  for (size_t i = 0; i < count; ++i) {
+    records[i] = "2024-01-01T00:00:00 INFO request " + std::to_string(i) + " " +
+                 std::string(i % 80, 'x') + "\n";
+  }
+  return records;
+}
+
+int main() {
+  const auto records = make_records(1 << 12);
+  const int fd = ::open("/dev/null", O_WRONLY);
+
+  run("std::ofstream", COUNT, [&] {
+    std::ofstream out("/dev/null");
+    for (size_t i = 0; i < COUNT; ++i) {
+      out << records[i % records.size()];
+    }
+    out.flush();
+  });
+  run("simplecpp::BufferedWriter inline", COUNT, [&] {
+    simplecpp::BufferedWriter out(fd);
+    for (size_t i = 0; i < COUNT; ++i) {
+      out.write(records[i % records.size()]);
+    }
+    out.flush();
+  });
+  run("simplecpp::BufferedWriter background", COUNT, [&] {
+    simplecpp::BufferedWriter out(fd, simplecpp::BufferedWriter::Flush::kBackground);
+    for (size_t i = 0; i < COUNT; ++i) {
+      out.write(records[i % records.size()]);
+    }
+    out.flush();
+  });
+  ::close(fd);
+}
@@ -0,0 +1,114 @@
+#include <SimpleCPP/compact_pointer.h>
+#include <SimpleCPP/pointer.h>
+
+#include <cstdio>
+#include <memory>
+
+#include "bench.h"
+
+constexpr int DEPTH = 20;
+constexpr size_t COUNT = (size_t{1} << DEPTH) - 1;
+
+struct SharedNode {
+  int value;
+  std::shared_ptr<SharedNode> left;
+  std::shared_ptr<SharedNode> right;
+};
+
+struct PointerNode {
+  int value;
+  simplecpp::Pointer<PointerNode> left{nullptr};
+  simplecpp::Pointer<PointerNode> right{nullptr};
+};
+
+struct CompactNode {
+  int value;
+  simplecpp::CompactPointer<CompactNode> left{};
+  simplecpp::CompactPointer<CompactNode> right{};
+};
+
+std::shared_ptr<SharedNode> build_shared(int depth, int& next) {
+  auto node = std::make_shared<SharedNode>();
+  node->value = next++;
+  if (depth > 1) {
+    node->left = build_shared(depth - 1, next);
+    node->right = build_shared(depth - 1, next);
+  }
+  return node;
+}
+
+simplecpp::Pointer<PointerNode> build_pointer(int depth, int& next) {
+  simplecpp::Pointer<PointerNode> node(PointerNode{next++});
+  if (depth > 1) {
+    node->left = build_pointer(depth - 1, next);
+    node->right = build_pointer(depth - 1, next);
+  }
+  return node;
+}
+
+simplecpp::CompactPointer<CompactNode> build_compact(int depth, int& next) {
+  auto node = simplecpp::CompactPointer<CompactNode>::make(CompactNode{next++});
+  if (depth > 1) {
+    node->left = build_compact(depth - 1, next);
+    node->right = build_compact(depth - 1, next);
+  }
+  return node;
+}
+
+/**
+ * @brief Sums the values of a tree in depth first order.
+ */
+template <typename Ptr>
+long sum(const Ptr& node) {
+  if (!node) {
+    return 0;
+  }
+  return node->value + sum(node->left) + sum(node->right);
+}
+
+template <typename T, typename Arena>
+long sum(const simplecpp::CompactPointer<T, Arena>& node) {
+  if (!node.is_valid()) {
+    return 0;
+  }
+  return node->value + sum(node->left) + sum(node->right);
+}
+
+template <typename T>
+long sum(const simplecpp::Pointer<T>& node) {
+  if (!node.is_valid()) {
+    return 0;
+  }
+  return node->value + sum(node->left) + sum(node->right);
+}
+
+int main() {
+  std::printf("bytes per node: std::shared_ptr %zu, simplecpp::Pointer %zu, "
+              "simplecpp::CompactPointer %zu\n",
+              sizeof(SharedNode) + 16, sizeof(PointerNode) + sizeof(size_t),
+              sizeof(CompactNode) + sizeof(uint32_t));
+
+  run("std::shared_ptr build", COUNT, [] {
+    int next = 0;
+    keep(build_shared(DEPTH, next));
+  });
+  run("simplecpp::Pointer build", COUNT, [] {
+    int next = 0;
+    keep(build_pointer(DEPTH, next));
+  });
+  run("simplecpp::CompactPointer build", COUNT, [] {
+    int next = 0;
+    keep(build_compact(DEPTH, next));
+  });
+
+  int next = 0;
+  const auto shared_tree = build_shared(DEPTH, next);
+  next = 0;
+  const auto pointer_tree = build_pointer(DEPTH, next);
+  next = 0;
+  const auto compact_tree = build_compact(DEPTH, next);
+
+  run("std::shared_ptr traverse", COUNT, [&] { keep(sum(shared_tree)); });
+  run("simplecpp::Pointer traverse", COUNT, [&] { keep(sum(pointer_tree)); });
+  run("simplecpp::CompactPointer traverse", COUNT, [&] { keep(sum(compact_tree)); });
+}
@@ -0,0 +1,77 @@
+#include <SimpleCPP/concurrent_hash_map.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+
+constexpr uint64_t KEYS = 1 << 16;
+constexpr size_t OPS_PER_THREAD = 1 << 20;
+// One write for every WRITE_EVERY operations.
+constexpr size_t WRITE_EVERY = 20;
+
+using value = simplecpp::Pointer<uint64_t>;
+
+class LockedMap {
+ public:
+  value find(uint64_t key) {
+    std::lock_guard lock(_mutex);
+    const auto it = _map.find(key);
+    return (it == _map.end()) ? value(nullptr) : value(it->second);
+  }
+
+  void insert_or_assign(uint64_t key, value v) {
+    std::lock_guard lock(_mutex);
+    _map.insert_or_assign(key, std::move(v));
+  }
+
+ private:
+  std::mutex _mutex;
+  std::unordered_map<uint64_t, value> _map;
+};
+
+template <typename Map>
+void bench(const char* name, size_t threads) {
+  Map map{};
+  for (uint64_t key = 0; key < KEYS; ++key) {
+    map.insert_or_assign(key, value{key});
+  }
+  const std::string label = std::string(name) + " " + std::to_string(threads) + " threads";
+  run(label.c_str(), OPS_PER_THREAD * threads, [&] {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        uint64_t key = t * 7919;
+        uint64_t sum = 0;
+        for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+          key = (key * 6364136223846793005ULL + 1442695040888963407ULL);
+          const uint64_t k = (key >> 32) % KEYS;
+          if (i % WRITE_EVERY == 0) {
+            map.insert_or_assign(k, value{k});
+          } else {
+            sum += *map.find(k);
+          }
+        }
+        keep(sum);
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }, 3);
+}
+
+int main() {
+  const size_t max_threads = std::thread::hardware_concurrency();
+  std::printf("Total ns per operation across all threads, lower is better\n");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    bench<LockedMap>("std::mutex + std::unordered_map", threads);
+    bench<simplecpp::ConcurrentHashMap<uint64_t, uint64_t>>("simplecpp::ConcurrentHashMap",
+                                                             threads);
+  }
+}
@@ -0,0 +1,68 @@
+#include <SimpleCPP/flat_hash_map.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+
+/**
+ * @brief Returns count distinct pseudo random keys.
+ */
+std::vector<uint64_t> make_keys(size_t count, uint64_t seed) {
+  std::vector<uint64_t> keys(count);
+  for (auto& key : keys) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    key = seed;
+  }
+  return keys;
+}
+
+template <typename Map>
+void bench(const std::string& name, const std::vector<uint64_t>& keys,
+           const std::vector<uint64_t>& misses) {
+  const size_t n = keys.size();
+  Map map{};
+  run((name + " insert").c_str(), n, [&] {
+    map = Map{};
+    for (const auto key : keys) {
+      map[key] = key;
+    }
+  }, 1);
+  run((name + " lookup hit").c_str(), n, [&] {
+    uint64_t sum = 0;
+    for (const auto key : keys) {
+      sum += map.find(key)->second;
+    }
+    keep(sum);
+  });
+  run((name + " lookup miss").c_str(), n, [&] {
+    size_t found = 0;
+    for (const auto key : misses) {
+      found += map.find(key) != map.end();
+    }
+    keep(found);
+  });
+  run((name + " erase").c_str(), n, [&] {
+    for (const auto key : keys) {
+      map.erase(key);
+    }
+  }, 1);
+}
+
+int main(int argc, char** argv) {
+  // Pass a larger limit such as 100000000 to test beyond the last level cache.
+  const size_t limit = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  for (size_t n = 1000; n <= limit; n *= 10) {
+    const auto keys = make_keys(n, 88172645463325252ULL);
+    const auto misses = make_keys(n, 2463534242ULL);
+    std::printf("%zu keys\n", n);
+    bench<std::unordered_map<uint64_t, uint64_t>>("  std::unordered_map", keys, misses);
+    bench<simplecpp::FlatHashMap<uint64_t, uint64_t>>("  simplecpp::FlatHashMap", keys, misses);
+  }
+}
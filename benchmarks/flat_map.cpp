@@ -0,0 +1,70 @@
+#include <SimpleCPP/flat_map.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t LOOKUPS = 1 << 20;
+
+int main() {
+  for (size_t n = 1000; n <= 10000000; n *= 10) {
+    std::vector<uint32_t> keys(n);
+    simplecpp::Vector<std::pair<uint32_t, uint32_t>> entries{};
+    std::map<uint32_t, uint32_t> tree{};
+    for (size_t i = 0; i < n; ++i) {
+      keys[i] = static_cast<uint32_t>(i * 3);
+      entries.push_back({keys[i], static_cast<uint32_t>(i)});
+      tree.emplace(keys[i], static_cast<uint32_t>(i));
+    }
+    simplecpp::FlatMap<uint32_t, uint32_t> sorted(simplecpp::sorted_unique, entries);
+    simplecpp::FlatMap<uint32_t, uint32_t> frozen(simplecpp::sorted_unique, std::move(entries));
+    frozen.freeze();
+
+    std::vector<uint32_t> queries(LOOKUPS);
+    uint64_t state = 88172645463325252ULL;
+    for (auto& query : queries) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      query = static_cast<uint32_t>(state % (n * 3));
+    }
+
+    std::printf("%zu keys\n", n);
+    run("  std::map::lower_bound", LOOKUPS, [&] {
+      uint64_t sum = 0;
+      for (const auto query : queries) {
+        auto it = tree.lower_bound(query);
+        sum += (it == tree.end()) ? 0 : it->second;
+      }
+      keep(sum);
+    });
+    run("  std::lower_bound", LOOKUPS, [&] {
+      uint64_t sum = 0;
+      for (const auto query : queries) {
+        sum += std::lower_bound(keys.begin(), keys.end(), query) - keys.begin();
+      }
+      keep(sum);
+    });
+    run("  simplecpp::FlatMap::lower_bound", LOOKUPS, [&] {
+      uint64_t sum = 0;
+      for (const auto query : queries) {
+        auto it = sorted.lower_bound(query);
+        sum += (it == sorted.end()) ? 0 : it->second;
+      }
+      keep(sum);
+    });
+    run("  simplecpp::FlatMap::lower_bound frozen", LOOKUPS, [&] {
+      uint64_t sum = 0;
+      for (const auto query : queries) {
+        auto it = frozen.lower_bound(query);
+        sum += (it == frozen.end()) ? 0 : it->second;
+      }
+      keep(sum);
+    });
+  }
+}
@@ -0,0 +1,49 @@
+#include <SimpleCPP/iobuf.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <string_view>
+
+#include "bench.h"
+
+constexpr size_t COUNT = 1 << 16;
+
+/**
+ * @brief Builds responses from a fresh header and a cached body and writes them to /dev/null.
+ */
+void bench(size_t body_size, int fd) {
+  const std::string suffix = " (" + std::to_string(body_size) + " byte body)";
+  const std::string body_text(body_size, 'b');
+  const simplecpp::Bytes body(body_text);
+  const std::string_view header = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n";
+  const std::string_view trailer = "\r\n";
+
+  run(("concatenate + write" + suffix).c_str(), COUNT, [&] {
+    for (size_t i = 0; i < COUNT; ++i) {
+      std::string response{};
+      response.reserve(header.size() + body.size() + trailer.size());
+      response.append(header);
+      response.append(body.as_string());
+      response.append(trailer);
+      keep(::write(fd, response.data(), response.size()));
+    }
+  });
+  run(("simplecpp::IOBuf + writev" + suffix).c_str(), COUNT, [&] {
+    for (size_t i = 0; i < COUNT; ++i) {
+      simplecpp::IOBuf response(trailer.size(), header.size());
+      response.append(body);
+      response.prepend(header);
+      response.append(trailer);
+      keep(response.write_to(fd));
+    }
+  });
+}
+
+int main() {
+  const int fd = ::open("/dev/null", O_WRONLY);
+  for (const size_t body_size : {256, 16384, 262144}) {
+    bench(body_size, fd);
+  }
+  ::close(fd);
+}
@@ -0,0 +1,44 @@
+#include <SimpleCPP/mapped_vector.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t COUNT = 1 << 24;
+
+/**
+ * @brief Stands in for building an index entry.
+ */
+uint64_t entry(uint64_t i) { return (i * 0x9E3779B97F4A7C15ULL) >> 7; }
+
+int main() {
+  const char* path = "/tmp/simplecpp_mapped_vector_benchmark";
+  ::unlink(path);
+
+  run("std::vector rebuild", COUNT, [] {
+    std::vector<uint64_t> index;
+    for (uint64_t i = 0; i < COUNT; ++i) {
+      index.push_back(entry(i));
+    }
+    keep(index.data());
+  });
+  run("simplecpp::MappedVector push_back and sync", COUNT, [&] {
+    ::unlink(path);
+    simplecpp::MappedVector<uint64_t> index(path);
+    for (uint64_t i = 0; i < COUNT; ++i) {
+      index.push_back(entry(i));
+    }
+    index.sync();
+  });
+  run("simplecpp::MappedVector reopen", COUNT, [&] {
+    simplecpp::MappedVector<uint64_t> index(path);
+    keep(index.size());
+  });
+  run("simplecpp::MappedVector reopen without verify", COUNT, [&] {
+    simplecpp::MappedVector<uint64_t> index(path, false);
+    keep(index.size());
+  });
+  ::unlink(path);
+}
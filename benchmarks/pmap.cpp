@@ -0,0 +1,66 @@
+#include <SimpleCPP/pmap.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t VERSIONS = 100;
+
+template <typename Map>
+Map make_map(size_t size) {
+  Map map{};
+  for (size_t i = 0; i < size; ++i) {
+    map[i] = i;
+  }
+  return map;
+}
+
+// Every version copies the previous one and updates a single key, as a snapshot per write would.
+template <typename Map>
+void copy_versions(const std::string& name, size_t size) {
+  const Map base = make_map<Map>(size);
+  run((name + " copy + update").c_str(), VERSIONS, [&] {
+    std::vector<Map> versions{base};
+    for (size_t i = 0; i < VERSIONS; ++i) {
+      Map next = versions.back();
+      next[i % size] = i;
+      versions.push_back(std::move(next));
+    }
+    keep(versions.size());
+  });
+}
+
+void pmap_versions(const std::string& name, size_t size) {
+  using PMap = simplecpp::PMap<uint64_t, uint64_t>;
+  PMap base{};
+  for (size_t i = 0; i < size; ++i) {
+    base.set(i, i);
+  }
+  run((name + " with").c_str(), VERSIONS, [&] {
+    std::vector<PMap> versions{base};
+    for (size_t i = 0; i < VERSIONS; ++i) {
+      versions.push_back(versions.back().with(i % size, i));
+    }
+    keep(versions.size());
+  });
+  run((name + " lookup").c_str(), size, [&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+      sum += *base.find(i);
+    }
+    keep(sum);
+  });
+}
+
+int main() {
+  for (const size_t size : {1000, 10000, 30000}) {
+    const std::string suffix = " (" + std::to_string(size) + " entries)";
+    copy_versions<std::map<uint64_t, uint64_t>>("std::map" + suffix, size);
+    copy_versions<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map" + suffix, size);
+    pmap_versions("simplecpp::PMap" + suffix, size);
+  }
+}
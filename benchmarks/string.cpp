@@ -0,0 +1,58 @@
+#include <SimpleCPP/string.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t COUNT = 1 << 20;
+
+/**
+ * @brief Returns count words whose lengths cycle through 1 to max_length characters.
+ */
+std::vector<std::string> make_words(size_t count, size_t max_length) {
+  std::vector<std::string> words(count);
+  for (size_t i = 0; i < count; ++i) {
+    words[i].assign(1 + i % max_length, static_cast<char>('a' + i % 26));
+  }
+  return words;
+}
+
+template <typename String>
+void bench(const std::string& name, const std::vector<std::string>& words) {
+  std::vector<String> strings(words.size());
+  run((name + " construct").c_str(), words.size(), [&] {
+    for (size_t i = 0; i < words.size(); ++i) {
+      strings[i] = String(std::string_view(words[i]));
+    }
+    keep(strings.data());
+  });
+  run((name + " append").c_str(), words.size(), [&] {
+    String s{};
+    for (size_t i = 0; i < words.size(); ++i) {
+      s += std::string_view(words[i]);
+      if (s.size() > 100) {
+        s.clear();
+      }
+    }
+    keep(s.data());
+  });
+  run((name + " compare").c_str(), words.size(), [&] {
+    size_t equal = 0;
+    for (size_t i = 1; i < strings.size(); ++i) {
+      equal += strings[i] == strings[i - 1];
+      equal += strings[i] < strings[i - 1];
+    }
+    keep(equal);
+  });
+}
+
+int main() {
+  for (const size_t length : {15, 23, 40}) {
+    const auto words = make_words(COUNT, length);
+    const std::string suffix = " (<= " + std::to_string(length) + " chars)";
+    bench<std::string>("std::string" + suffix, words);
+    bench<simplecpp::String>("simplecpp::String" + suffix, words);
+  }
+}
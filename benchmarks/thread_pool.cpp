@@ -0,0 +1,151 @@
+#include <SimpleCPP/thread_pool.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+
+constexpr int FIB = 25;
+constexpr size_t FIB_TASKS = 121392;  // The number of calls with n >= 2, one task each.
+constexpr size_t COUNT = 1 << 18;
+
+/**
+ * @brief A thread pool with one std::function queue behind a mutex, for comparison.
+ */
+class NaiveThreadPool {
+ public:
+  class Group {
+   public:
+    explicit Group(NaiveThreadPool& pool) : _pool(pool), _pending(0) {}
+
+    void run(std::function<void()> fn) {
+      _pending.fetch_add(1);
+      _pool.submit([this, fn = std::move(fn)] {
+        fn();
+        _pending.fetch_sub(1);
+      });
+    }
+
+    // Runs the newest queued tasks while waiting, so tasks can wait for their children without
+    // nesting deeper than the recursion itself.
+    void wait() {
+      while (_pending.load() != 0) {
+        if (!_pool.run_one()) {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+   private:
+    NaiveThreadPool& _pool;
+    std::atomic<size_t> _pending;
+  };
+
+  explicit NaiveThreadPool(size_t threads) : _stop(false) {
+    for (size_t i = 0; i < threads; ++i) {
+      _threads.emplace_back([this] {
+        while (true) {
+          std::unique_lock lock(_mutex);
+          _ready.wait(lock, [&] { return _stop || !_tasks.empty(); });
+          if (_tasks.empty()) {
+            return;
+          }
+          auto task = std::move(_tasks.front());
+          _tasks.pop_front();
+          lock.unlock();
+          task();
+        }
+      });
+    }
+  }
+
+  ~NaiveThreadPool() {
+    {
+      std::lock_guard lock(_mutex);
+      _stop = true;
+    }
+    _ready.notify_all();
+    for (auto& thread : _threads) {
+      thread.join();
+    }
+  }
+
+  void submit(std::function<void()> fn) {
+    {
+      std::lock_guard lock(_mutex);
+      _tasks.push_back(std::move(fn));
+    }
+    _ready.notify_one();
+  }
+
+  bool run_one() {
+    std::unique_lock lock(_mutex);
+    if (_tasks.empty()) {
+      return false;
+    }
+    auto task = std::move(_tasks.back());
+    _tasks.pop_back();
+    lock.unlock();
+    task();
+    return true;
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _ready;
+  std::deque<std::function<void()>> _tasks;
+  std::vector<std::thread> _threads;
+  bool _stop;
+};
+
+template <typename Pool>
+long fib(Pool& pool, int n) {
+  if (n < 2) {
+    return n;
+  }
+  long left = 0;
+  typename Pool::Group group(pool);
+  group.run([&pool, &left, n] { left = fib(pool, n - 1); });
+  const long right = fib(pool, n - 2);
+  group.wait();
+  return left + right;
+}
+
+template <typename Pool>
+void fork_join(Pool& pool) {
+  long result = 0;
+  typename Pool::Group group(pool);
+  group.run([&] { result = fib(pool, FIB); });
+  group.wait();
+  keep(result);
+}
+
+template <typename Pool>
+void independent(Pool& pool) {
+  std::atomic<size_t> sum(0);
+  typename Pool::Group group(pool);
+  for (size_t i = 0; i < COUNT; ++i) {
+    group.run([&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+  }
+  group.wait();
+  keep(sum.load());
+}
+
+int main() {
+  const size_t threads = std::max(2u, std::thread::hardware_concurrency());
+  {
+    NaiveThreadPool pool(threads);
+    run("std::thread + mutex queue fork join", FIB_TASKS, [&] { fork_join(pool); });
+    run("std::thread + mutex queue independent", COUNT, [&] { independent(pool); });
+  }
+  {
+    simplecpp::ThreadPool pool(threads);
+    run("simplecpp::ThreadPool fork join", FIB_TASKS, [&] { fork_join(pool); });
+    run("simplecpp::ThreadPool independent", COUNT, [&] { independent(pool); });
+  }
+}
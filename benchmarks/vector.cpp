@@ -0,0 +1,44 @@
+#include <SimpleCPP/vector.h>
+
+#include <vector>
+
+#include "bench.h"
+
+constexpr size_t COUNT = 1 << 22;
+
+struct Particle {
+  double position[3];
+  double velocity[3];
+};
+
+template <typename Vec, typename T>
+void push_back(const char* name) {
+  run(name, COUNT, [] {
+    Vec v{};
+    for (size_t i = 0; i < COUNT; ++i) {
+      v.push_back(T{});
+    }
+    keep(v.data());
+  });
+}
+
+template <typename Vec>
+void iterate(const char* name) {
+  Vec v(COUNT, 1);
+  run(name, COUNT, [&] {
+    long sum = 0;
+    for (const auto& i : v) {
+      sum += i;
+    }
+    keep(sum);
+  });
+}
+
+int main() {
+  push_back<std::vector<int>, int>("std::vector<int> push_back");
+  push_back<simplecpp::Vector<int>, int>("simplecpp::Vector<int> push_back");
+  push_back<std::vector<Particle>, Particle>("std::vector<Particle> push_back");
+  push_back<simplecpp::Vector<Particle>, Particle>("simplecpp::Vector<Particle> push_back");
+  iterate<std::vector<int>>("std::vector<int> iterate");
+  iterate<simplecpp::Vector<int>>("simplecpp::Vector<int> iterate");
+}
@@ -0,0 +1,73 @@
+#ifndef SIMPLECPP_ALLOCATOR_H_
+#define SIMPLECPP_ALLOCATOR_H_
+
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+ * @brief Allocates size bytes with malloc.
+ *
+ * @throws std::bad_alloc If the memory could not be allocated.
+ */
+inline void* default_allocator(const size_t& size) {
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+/**
+ * @brief Frees memory returned by default_allocator or default_reallocator.
+ */
+inline void default_deallocator(void* ptr) noexcept { free(ptr); }
+
+/**
+ * @brief Resizes memory returned by default_allocator, possibly moving it.
+ *
+ * @note For large blocks glibc grows the mapping in place with mremap, so no bytes are copied.
+ *
+ * @throws std::bad_alloc If the memory could not be resized, ptr is left untouched.
+ */
+inline void* default_reallocator(void* ptr, const size_t& size) {
+  auto data = realloc(ptr, size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+using Allocator = void* (*)(const size_t&);
+using Deallocator = void (*)(void*) noexcept;
+
+/**
+ * @brief Checks if memory from alloc can be resized with default_reallocator.
+ *
+ * @note Custom allocators do not say how to grow a block so only the default pair qualifies.
+ */
+template <Allocator alloc, Deallocator dealloc>
+inline constexpr bool is_reallocatable =
+    alloc == default_allocator && dealloc == default_deallocator;
+
+/**
+ * @brief Trait for types that may be moved to a new address with memcpy and without running the
+ * destructor of the source.
+ *
+ * @note Specialize this for types that own resources but do not store their own address.
+ */
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename A, typename B>
+struct is_trivially_relocatable<std::pair<A, B>>
+    : std::bool_constant<is_trivially_relocatable<A>::value && is_trivially_relocatable<B>::value> {
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_ALLOCATOR_H_
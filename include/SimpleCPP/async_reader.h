@@ -0,0 +1,505 @@
+#ifndef SIMPLECPP_ASYNC_READER_H_
+#define SIMPLECPP_ASYNC_READER_H_
+
+#include <SimpleCPP/buffer_pool.h>
+#include <SimpleCPP/bytes.h>
+#include <SimpleCPP/deque.h>
+#include <SimpleCPP/futex.h>
+#include <SimpleCPP/pool.h>
+#include <SimpleCPP/vector.h>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace simplecpp {
+namespace detail {
+/**
+ * @brief A minimal io_uring set up with raw system calls, so liburing is not needed.
+ *
+ * @note The caller must not queue more entries than it has reaped completions for, so neither
+ * ring can overflow.
+ */
+class IoUring {
+ public:
+  IoUring() noexcept
+      : _fd(-1),
+        _sq_ring(nullptr),
+        _cq_ring(nullptr),
+        _sq_ring_size(0),
+        _cq_ring_size(0),
+        _sqes(nullptr),
+        _sq_entries(0),
+        _sq_tail(0),
+        _queued(0) {}
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  ~IoUring() noexcept { close(); }
+
+  /**
+   * @brief Creates a ring with room for entries submissions.
+   *
+   * @return 0, or the errno of the failed call, e.g. ENOSYS or EPERM if io_uring is unavailable.
+   */
+  int open(unsigned entries) noexcept {
+    io_uring_params params{};
+    const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      return errno;
+    }
+    _fd = static_cast<int>(fd);
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+    }
+    _sq_ring = map(_sq_ring_size, IORING_OFF_SQ_RING);
+    if (_sq_ring != nullptr) {
+      _cq_ring = single_mmap ? _sq_ring : map(_cq_ring_size, IORING_OFF_CQ_RING);
+    }
+    _sqes = static_cast<io_uring_sqe*>(
+        map(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+    if (_sq_ring == nullptr || _cq_ring == nullptr || _sqes == nullptr) {
+      const int error = errno;
+      close();
+      return error;
+    }
+    _sq_entries = params.sq_entries;
+    _sq_mask = field(_sq_ring, params.sq_off.ring_mask);
+    _sq_array = &field(_sq_ring, params.sq_off.array);
+    _sq_tail_ptr = &field(_sq_ring, params.sq_off.tail);
+    _sq_tail = *_sq_tail_ptr;
+    _cq_mask = field(_cq_ring, params.cq_off.ring_mask);
+    _cq_head_ptr = &field(_cq_ring, params.cq_off.head);
+    _cq_tail_ptr = &field(_cq_ring, params.cq_off.tail);
+    _cqes = reinterpret_cast<io_uring_cqe*>(static_cast<uint8_t*>(_cq_ring) + params.cq_off.cqes);
+    return 0;
+  }
+
+  bool is_open() const noexcept { return _fd >= 0; }
+  unsigned entries() const noexcept { return _sq_entries; }
+
+  /**
+   * @brief Registers region as fixed buffer 0.
+   *
+   * @return False if the kernel refused, e.g. because the region exceeds RLIMIT_MEMLOCK.
+   */
+  bool register_buffer(const iovec& region) noexcept {
+    return ::syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS, &region, 1) == 0;
+  }
+
+  /**
+   * @brief Returns a zeroed submission entry that is submitted by the next submit().
+   */
+  io_uring_sqe* queue() noexcept {
+    const uint32_t index = _sq_tail & _sq_mask;
+    io_uring_sqe* sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sq_array[index] = index;
+    ++_sq_tail;
+    ++_queued;
+    return sqe;
+  }
+
+  /**
+   * @brief Submits the queued entries with a single system call and waits for wait completions.
+   *
+   * @throws std::system_error If io_uring_enter fails.
+   */
+  void submit(unsigned wait) {
+    std::atomic_ref<uint32_t>(*_sq_tail_ptr).store(_sq_tail, std::memory_order_release);
+    while (_queued != 0 || wait != 0) {
+      const unsigned flags = (wait != 0) ? IORING_ENTER_GETEVENTS : 0;
+      const long result =
+          ::syscall(__NR_io_uring_enter, _fd, _queued, wait, flags, nullptr, 0);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+      }
+      _queued -= static_cast<unsigned>(result);
+      wait = 0;
+    }
+  }
+
+  /**
+   * @brief Calls fn(user_data, res) for every available completion.
+   */
+  template <typename Fn>
+  size_t reap(Fn&& fn) {
+    uint32_t head = *_cq_head_ptr;
+    const uint32_t tail = std::atomic_ref<uint32_t>(*_cq_tail_ptr).load(std::memory_order_acquire);
+    size_t count = 0;
+    for (; head != tail; ++head, ++count) {
+      const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+      fn(cqe.user_data, cqe.res);
+    }
+    std::atomic_ref<uint32_t>(*_cq_head_ptr).store(head, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  static uint32_t& field(void* ring, uint32_t offset) noexcept {
+    return *reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(ring) + offset);
+  }
+
+  void* map(size_t size, off_t offset) noexcept {
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                        offset);
+    return (data == MAP_FAILED) ? nullptr : data;
+  }
+
+  void close() noexcept {
+    if (_sqes != nullptr) {
+      ::munmap(_sqes, _sq_entries * sizeof(io_uring_sqe));
+    }
+    if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+      ::munmap(_cq_ring, _cq_ring_size);
+    }
+    if (_sq_ring != nullptr) {
+      ::munmap(_sq_ring, _sq_ring_size);
+    }
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+    _fd = -1;
+    _sq_ring = _cq_ring = nullptr;
+    _sqes = nullptr;
+  }
+
+  int _fd;
+  void* _sq_ring;
+  void* _cq_ring;
+  size_t _sq_ring_size;
+  size_t _cq_ring_size;
+  io_uring_sqe* _sqes;
+  unsigned _sq_entries;
+  uint32_t _sq_mask;
+  uint32_t* _sq_array;
+  uint32_t* _sq_tail_ptr;
+  uint32_t _sq_tail;
+  unsigned _queued;
+  uint32_t _cq_mask;
+  uint32_t* _cq_head_ptr;
+  uint32_t* _cq_tail_ptr;
+  io_uring_cqe* _cqes;
+};
+}  // namespace detail
+
+/**
+    @brief Reads files asynchronously into pooled buffers with io_uring, or with a pool of threads
+   calling pread where io_uring is unavailable
+
+    @tparam Pool A BufferPool whose buffers hold the data that was read
+
+    @note Reads are queued by read() and handed to the kernel or the threads in a single batch by
+   submit() or poll(). Every completion owns its data as BasicBytes backed by a Pool buffer, which
+   returns to the Pool when the last copy or slice is destroyed, so a steady stream of reads does
+   not allocate. With io_uring the Pool is registered once and reads use IORING_OP_READ_FIXED,
+   which saves the kernel from mapping the buffer on every read. A single AsyncReader must only be
+   used from one thread, the completions may be passed to others.
+*/
+template <typename Pool = BufferPool<>>
+class AsyncReader {
+ public:
+  using bytes = BasicBytes<Pool::allocate, Pool::deallocate>;
+
+  enum class Backend { kAuto, kIoUring, kThreadPool };
+
+  struct Completion {
+    uint64_t tag;
+    /**
+     * @brief 0, or the errno of the failed read.
+     */
+    int error;
+    /**
+     * @brief The bytes that were read, fewer than requested at the end of the file.
+     */
+    bytes data;
+  };
+
+  /**
+   * @param queue_depth The number of reads in flight at once
+   * @param backend kAuto uses io_uring if the kernel allows it and threads otherwise
+   * @param threads The number of threads of the thread pool backend
+   * @throws std::system_error If kIoUring is requested but unavailable.
+   */
+  explicit AsyncReader(unsigned queue_depth = 64, Backend backend = Backend::kAuto,
+                       unsigned threads = 4)
+      : _backend(Backend::kThreadPool),
+        _fixed(false),
+        _in_flight(0),
+        _depth(0),
+        _work(0),
+        _done(0),
+        _stop(false) {
+    if (backend != Backend::kThreadPool) {
+      const int error = _ring.open(queue_depth);
+      if (error == 0) {
+        _backend = Backend::kIoUring;
+        _fixed = _ring.register_buffer(Pool::region());
+        _slots.resize(_ring.entries());
+        for (uint32_t i = 0; i < _ring.entries(); ++i) {
+          _free_slots.push_back(i);
+        }
+        return;
+      }
+      if (backend == Backend::kIoUring) {
+        throw std::system_error(error, std::generic_category(), "io_uring_setup");
+      }
+    }
+    _depth = std::max(queue_depth, 1u);
+    for (unsigned i = 0; i < std::max(threads, 1u); ++i) {
+      _threads.emplace_back([this] { work(); });
+    }
+  }
+
+  AsyncReader(const AsyncReader&) = delete;
+  AsyncReader& operator=(const AsyncReader&) = delete;
+
+  /**
+   * @note Reads still in flight are waited for and their completions are dropped.
+   */
+  ~AsyncReader() noexcept {
+    if (_backend == Backend::kIoUring) {
+      try {
+        while (_free_slots.size() != _slots.size()) {
+          _ring.submit(1);
+          _ring.reap([&](uint64_t slot, int) { release(slot); });
+        }
+      } catch (...) {
+        // The ring is closed below, which cancels the remaining reads.
+      }
+      return;
+    }
+    {
+      std::lock_guard lock(_mutex);
+      _stop = true;
+      detail::epoch_notify(_work);
+    }
+    for (auto& thread : _threads) {
+      thread.join();
+    }
+  }
+
+  Backend backend() const noexcept { return _backend; }
+
+  /**
+   * @brief Returns the number of reads that were queued but whose completion was not delivered.
+   */
+  size_t in_flight() const noexcept { return _in_flight; }
+
+  /**
+   * @brief Queues a read of up to length bytes of fd starting at offset.
+   *
+   * @note If queue_depth reads are in flight this waits for one of them to complete, its
+   * completion is delivered by the next poll().
+   */
+  void read(int fd, uint64_t offset, size_t length, uint64_t tag) {
+    if (_backend == Backend::kIoUring) {
+      while (_free_slots.empty()) {
+        _ring.submit(1);
+        reap();
+      }
+      const uint32_t index = _free_slots.back();
+      Slot& slot = _slots[index];
+      slot.data = buffer::for_overwrite(length);
+      slot.tag = tag;
+      _free_slots.pop_back();
+
+      io_uring_sqe* sqe = _ring.queue();
+      const bool fixed = _fixed && Pool::owns(slot.data.get());
+      sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+      sqe->fd = fd;
+      sqe->off = offset;
+      sqe->addr = reinterpret_cast<uint64_t>(slot.data.get());
+      sqe->len = static_cast<uint32_t>(length);
+      sqe->buf_index = 0;
+      sqe->user_data = index;
+    } else {
+      while (_in_flight - _ready.size() >= _depth) {
+        submit();
+        wait_for_threads();
+      }
+      _batch.push_back(Request{fd, offset, length, tag});
+    }
+    ++_in_flight;
+  }
+
+  /**
+   * @brief Hands the queued reads to the kernel or the threads in a single batch.
+   */
+  void submit() {
+    if (_backend == Backend::kIoUring) {
+      _ring.submit(0);
+      return;
+    }
+    if (_batch.empty()) {
+      return;
+    }
+    {
+      std::lock_guard lock(_mutex);
+      for (auto& request : _batch) {
+        _requests.push_back(request);
+      }
+      detail::epoch_notify(_work);
+    }
+    _batch.clear();
+  }
+
+  /**
+   * @brief Submits the queued reads, waits until at least min_complete reads completed and calls
+   * fn(Completion&&) for every completed read.
+   *
+   * @return The number of delivered completions.
+   */
+  template <typename Fn>
+  size_t poll(Fn&& fn, size_t min_complete = 0) {
+    submit();
+    min_complete = std::min(min_complete, _in_flight);
+    if (_backend == Backend::kIoUring) {
+      reap();
+      if (_ready.size() < min_complete) {
+        _ring.submit(static_cast<unsigned>(min_complete - _ready.size()));
+        reap();
+      }
+    } else {
+      std::unique_lock lock(_mutex);
+      detail::epoch_wait(_done, lock,
+                         [&] { return _ready.size() + _completed.size() >= min_complete; });
+      for (auto& completion : _completed) {
+        _ready.push_back(std::move(completion));
+      }
+      _completed.clear();
+    }
+    size_t delivered = 0;
+    while (!_ready.empty()) {
+      Completion completion = std::move(_ready.front());
+      _ready.pop_front();
+      --_in_flight;
+      ++delivered;
+      fn(std::move(completion));
+    }
+    return delivered;
+  }
+
+ private:
+  using buffer = typename bytes::buffer;
+
+  struct Slot {
+    buffer data;
+    uint64_t tag;
+  };
+
+  struct Request {
+    int fd;
+    uint64_t offset;
+    size_t length;
+    uint64_t tag;
+  };
+
+  void release(uint64_t slot) noexcept {
+    _slots[slot].data = buffer();
+    _free_slots.push_back(static_cast<uint32_t>(slot));
+  }
+
+  void reap() {
+    _ring.reap([&](uint64_t index, int result) {
+      Slot& slot = _slots[index];
+      Completion completion{slot.tag, (result < 0) ? -result : 0, bytes()};
+      if (result > 0) {
+        completion.data = bytes(std::move(slot.data), 0, static_cast<size_t>(result));
+      }
+      _ready.push_back(std::move(completion));
+      release(index);
+    });
+  }
+
+  // Waits for a thread to finish a read and moves the finished reads to _ready.
+  void wait_for_threads() {
+    std::unique_lock lock(_mutex);
+    detail::epoch_wait(_done, lock, [&] { return !_completed.empty(); });
+    for (auto& completion : _completed) {
+      _ready.push_back(std::move(completion));
+    }
+    _completed.clear();
+  }
+
+  void work() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+      detail::epoch_wait(_work, lock, [&] { return _stop || !_requests.empty(); });
+      if (_stop) {
+        return;
+      }
+      const Request request = _requests.front();
+      _requests.pop_front();
+      lock.unlock();
+      Completion completion = pread(request);
+      lock.lock();
+      _completed.push_back(std::move(completion));
+      detail::epoch_notify(_done);
+    }
+  }
+
+  static Completion pread(const Request& request) {
+    Completion completion{request.tag, 0, bytes()};
+    try {
+      buffer data = buffer::for_overwrite(request.length);
+      ssize_t result;
+      do {
+        result = ::pread(request.fd, data.get(), request.length,
+                         static_cast<off_t>(request.offset));
+      } while (result < 0 && errno == EINTR);
+      if (result < 0) {
+        completion.error = errno;
+      } else if (result > 0) {
+        completion.data = bytes(std::move(data), 0, static_cast<size_t>(result));
+      }
+    } catch (const std::bad_alloc&) {
+      completion.error = ENOMEM;
+    }
+    return completion;
+  }
+
+  Backend _backend;
+  bool _fixed;
+  size_t _in_flight;
+  Deque<Completion> _ready;
+
+  // io_uring backend, a slot holds the buffer of a read until it completes.
+  detail::IoUring _ring;
+  Vector<Slot> _slots;
+  Vector<uint32_t> _free_slots;
+
+  // Thread pool backend, the queues are guarded by _mutex.
+  size_t _depth;
+  Vector<Request> _batch;
+  std::mutex _mutex;
+  std::atomic<uint32_t> _work;
+  std::atomic<uint32_t> _done;
+  Deque<Request> _requests;
+  Deque<Completion> _completed;
+  bool _stop;
+  Vector<std::thread> _threads;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_ASYNC_READER_H_
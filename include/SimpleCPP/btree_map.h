@@ -0,0 +1,601 @@
+#ifndef SIMPLECPP_BTREE_MAP_H_
+#define SIMPLECPP_BTREE_MAP_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/pool.h>
+#include <SimpleCPP/vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief An ordered map stored in a B+ tree whose nodes hold many keys each
+
+    @tparam K The type of the keys, which must be default constructible
+    @tparam V The type of the values, which must be default constructible
+    @tparam Compare The strict ordering of the keys
+    @tparam node_bytes The target size of a node, e.g. a few cache lines or a page
+    @param alloc A custom allocator function used for the node pools
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Entries live in the leaves, which are linked for scans. Nodes come from a Pool, so nodes
+   freed by erase are reused by later inserts. Inserts and erases invalidate iterators.
+*/
+template <typename K, typename V, typename Compare = std::less<K>, size_t node_bytes = 256,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BTreeMap {
+  static_assert(node_bytes >= 64, "Nodes must be at least a cache line.");
+
+  struct Node {
+    uint16_t count;
+    bool leaf;
+  };
+
+  static constexpr size_t kLeafSlots = std::max<size_t>(
+      4, (node_bytes - sizeof(Node) - sizeof(void*)) / (sizeof(K) + sizeof(V)));
+  static constexpr size_t kInnerSlots = std::max<size_t>(
+      4, (node_bytes - sizeof(Node) - sizeof(void*)) / (sizeof(K) + sizeof(void*)));
+  static_assert(kLeafSlots <= UINT16_MAX && kInnerSlots <= UINT16_MAX, "Nodes are too large.");
+
+  // A node with fewer entries than this is refilled before erasing from it.
+  static constexpr size_t kLeafMin = kLeafSlots / 2;
+  static constexpr size_t kInnerMin = (kInnerSlots - 1) / 2;
+
+  struct Leaf : Node {
+    Leaf() noexcept : Node{0, true}, next(nullptr) {}
+
+    Leaf* next;
+    K keys[kLeafSlots];
+    V values[kLeafSlots];
+  };
+
+  struct Inner : Node {
+    Inner() noexcept : Node{0, false} {}
+
+    // Keys in children[i] are less than keys[i], keys in children[i + 1] are not.
+    K keys[kInnerSlots];
+    Node* children[kInnerSlots + 1];
+  };
+
+ public:
+  template <bool is_const>
+  class Iterator {
+    using Value = std::conditional_t<is_const, const V, V>;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::pair<const K&, Value&>;
+    using reference = value_type;
+    using pointer = void;
+
+    Iterator() noexcept : _leaf(nullptr), _index(0) {}
+    Iterator(Leaf* leaf, size_t index) noexcept : _leaf(leaf), _index(index) { skip_end(); }
+
+    /**
+     * @brief Converts a mutable iterator to a const one.
+     */
+    template <bool other_const>
+      requires(is_const && !other_const)
+    Iterator(const Iterator<other_const>& other) noexcept
+        : _leaf(other._leaf), _index(other._index) {}
+
+    const K& key() const noexcept { return _leaf->keys[_index]; }
+    Value& value() const noexcept { return _leaf->values[_index]; }
+    value_type operator*() const noexcept { return {key(), value()}; }
+
+    Iterator& operator++() noexcept {
+      ++_index;
+      skip_end();
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) noexcept {
+      return a._leaf == b._leaf && a._index == b._index;
+    }
+
+   private:
+    friend class BTreeMap;
+    template <bool>
+    friend class Iterator;
+
+    void skip_end() noexcept {
+      while (_leaf != nullptr && _index == _leaf->count) {
+        _leaf = _leaf->next;
+        _index = 0;
+      }
+    }
+
+    Leaf* _leaf;
+    size_t _index;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /**
+   * @brief Default constructor to create an empty BTreeMap without allocating.
+   */
+  BTreeMap() noexcept : _root(nullptr), _size(0) {}
+
+  BTreeMap(const BTreeMap& other) : BTreeMap() { bulk_load(other.begin(), other.end()); }
+
+  /**
+   * @note This leaves the other BTreeMap empty
+   */
+  BTreeMap(BTreeMap&& other) noexcept
+      : _leaves(std::move(other._leaves)),
+        _inners(std::move(other._inners)),
+        _root(other._root),
+        _size(other._size) {
+    other._root = nullptr;
+    other._size = 0;
+  }
+
+  ~BTreeMap() noexcept { clear(); }
+
+  BTreeMap& operator=(const BTreeMap& other) {
+    if (this != &other) {
+      bulk_load(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  BTreeMap& operator=(BTreeMap&& other) noexcept {
+    if (this != &other) {
+      clear();
+      _leaves = std::move(other._leaves);
+      _inners = std::move(other._inners);
+      _root = other._root;
+      _size = other._size;
+      other._root = nullptr;
+      other._size = 0;
+    }
+    return *this;
+  }
+
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+
+  /**
+   * @brief Returns the bytes allocated for nodes, including free nodes kept for reuse.
+   */
+  size_t memory_usage() const noexcept {
+    return _leaves.allocated_bytes() + _inners.allocated_bytes();
+  }
+
+  iterator begin() noexcept { return {first_leaf(), 0}; }
+  iterator end() noexcept { return {}; }
+  const_iterator begin() const noexcept { return {first_leaf(), 0}; }
+  const_iterator end() const noexcept { return {}; }
+
+  /**
+   * @brief Returns the first entry whose key is not less than key.
+   */
+  iterator lower_bound(const K& key) noexcept {
+    if (_root == nullptr) {
+      return end();
+    }
+    Leaf* leaf = find_leaf(key);
+    return {leaf, lower_index(leaf->keys, leaf->count, key)};
+  }
+  const_iterator lower_bound(const K& key) const noexcept {
+    return const_cast<BTreeMap*>(this)->lower_bound(key);
+  }
+
+  /**
+   * @brief Returns the entries with keys in [low, high).
+   */
+  std::pair<iterator, iterator> range(const K& low, const K& high) noexcept {
+    return {lower_bound(low), lower_bound(high)};
+  }
+  std::pair<const_iterator, const_iterator> range(const K& low, const K& high) const noexcept {
+    return {lower_bound(low), lower_bound(high)};
+  }
+
+  iterator find(const K& key) noexcept {
+    iterator it = lower_bound(key);
+    return (it != end() && !Compare{}(key, it.key())) ? it : end();
+  }
+  const_iterator find(const K& key) const noexcept {
+    return const_cast<BTreeMap*>(this)->find(key);
+  }
+
+  bool contains(const K& key) const noexcept { return find(key) != end(); }
+
+  /**
+   * @throws std::out_of_range If the key is not in the BTreeMap.
+   */
+  V& at(const K& key) {
+    iterator it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("BTreeMap key not found.");
+    }
+    return it.value();
+  }
+  const V& at(const K& key) const { return const_cast<BTreeMap*>(this)->at(key); }
+
+  /**
+   * @brief Returns the value for key, value initializing it if the key is not present.
+   */
+  V& operator[](const K& key) { return insert(key, V()).first.value(); }
+
+  /**
+   * @brief Inserts key and value if key is not present.
+   *
+   * @return An iterator to the entry for key and whether it was inserted.
+   */
+  std::pair<iterator, bool> insert(const K& key, V value) {
+    if (_root == nullptr) {
+      _root = new_leaf();
+    }
+    if (is_full(_root)) {
+      Inner* root = new_inner();
+      root->children[0] = _root;
+      _root = root;
+      split_child(root, 0);
+    }
+
+    Node* node = _root;
+    while (!node->leaf) {
+      auto inner = static_cast<Inner*>(node);
+      size_t child = upper_index(inner->keys, inner->count, key);
+      if (is_full(inner->children[child])) {
+        split_child(inner, child);
+        if (!Compare{}(key, inner->keys[child])) {
+          ++child;
+        }
+      }
+      node = inner->children[child];
+    }
+
+    auto leaf = static_cast<Leaf*>(node);
+    const size_t index = lower_index(leaf->keys, leaf->count, key);
+    if (index < leaf->count && !Compare{}(key, leaf->keys[index])) {
+      return {iterator(leaf, index), false};
+    }
+    std::move_backward(leaf->keys + index, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+    std::move_backward(leaf->values + index, leaf->values + leaf->count,
+                       leaf->values + leaf->count + 1);
+    leaf->keys[index] = key;
+    leaf->values[index] = std::move(value);
+    ++leaf->count;
+    ++_size;
+    return {iterator(leaf, index), true};
+  }
+
+  /**
+   * @brief Removes the entry for key.
+   *
+   * @return False if key was not present.
+   */
+  bool erase(const K& key) {
+    if (_root == nullptr) {
+      return false;
+    }
+
+    Node* node = _root;
+    while (!node->leaf) {
+      auto inner = static_cast<Inner*>(node);
+      const size_t child = upper_index(inner->keys, inner->count, key);
+      // Refill the child first so removing from it cannot underflow, this may merge it away.
+      node = refill_child(inner, child);
+    }
+
+    auto leaf = static_cast<Leaf*>(node);
+    const size_t index = lower_index(leaf->keys, leaf->count, key);
+    const bool found = index < leaf->count && !Compare{}(key, leaf->keys[index]);
+    if (found) {
+      std::move(leaf->keys + index + 1, leaf->keys + leaf->count, leaf->keys + index);
+      std::move(leaf->values + index + 1, leaf->values + leaf->count, leaf->values + index);
+      --leaf->count;
+      --_size;
+    }
+
+    if (!_root->leaf && _root->count == 0) {
+      auto root = static_cast<Inner*>(_root);
+      _root = root->children[0];
+      delete_inner(root);
+    }
+    return found;
+  }
+
+  /**
+   * @brief Replaces the contents with the range [first, last) in O(n), filling nodes completely.
+   *
+   * @warning The entries must be sorted by key without duplicates.
+   */
+  template <typename It>
+  void bulk_load(It first, It last) {
+    BTreeMap loaded{};
+    loaded.build_sorted(first, last);
+    *this = std::move(loaded);
+  }
+
+  void clear() noexcept {
+    if (_root != nullptr) {
+      destroy(_root);
+    }
+    _root = nullptr;
+    _size = 0;
+  }
+
+ private:
+  static size_t lower_index(const K* keys, size_t count, const K& key) noexcept {
+    return std::lower_bound(keys, keys + count, key, Compare{}) - keys;
+  }
+
+  static size_t upper_index(const K* keys, size_t count, const K& key) noexcept {
+    return std::upper_bound(keys, keys + count, key, Compare{}) - keys;
+  }
+
+  static bool is_full(const Node* node) noexcept {
+    return node->count == (node->leaf ? kLeafSlots : kInnerSlots);
+  }
+
+  Leaf* first_leaf() const noexcept {
+    Node* node = _root;
+    if (node == nullptr) {
+      return nullptr;
+    }
+    while (!node->leaf) {
+      node = static_cast<Inner*>(node)->children[0];
+    }
+    return static_cast<Leaf*>(node);
+  }
+
+  Leaf* find_leaf(const K& key) const noexcept {
+    Node* node = _root;
+    while (!node->leaf) {
+      auto inner = static_cast<Inner*>(node);
+      node = inner->children[upper_index(inner->keys, inner->count, key)];
+    }
+    return static_cast<Leaf*>(node);
+  }
+
+  Leaf* new_leaf() { return new (_leaves.allocate()) Leaf(); }
+  Inner* new_inner() { return new (_inners.allocate()) Inner(); }
+
+  void delete_leaf(Leaf* leaf) noexcept {
+    leaf->~Leaf();
+    _leaves.deallocate(leaf);
+  }
+
+  void delete_inner(Inner* inner) noexcept {
+    inner->~Inner();
+    _inners.deallocate(inner);
+  }
+
+  void destroy(Node* node) noexcept {
+    if (node->leaf) {
+      delete_leaf(static_cast<Leaf*>(node));
+      return;
+    }
+    auto inner = static_cast<Inner*>(node);
+    for (size_t i = 0; i <= inner->count; ++i) {
+      destroy(inner->children[i]);
+    }
+    delete_inner(inner);
+  }
+
+  /**
+   * @brief Splits the full child at index of parent in two, parent must not be full.
+   */
+  void split_child(Inner* parent, size_t index) {
+    Node* child = parent->children[index];
+    Node* right;
+    K separator;
+    if (child->leaf) {
+      auto left = static_cast<Leaf*>(child);
+      Leaf* leaf = new_leaf();
+      const size_t keep = left->count / 2;
+      leaf->count = static_cast<uint16_t>(left->count - keep);
+      std::move(left->keys + keep, left->keys + left->count, leaf->keys);
+      std::move(left->values + keep, left->values + left->count, leaf->values);
+      left->count = static_cast<uint16_t>(keep);
+      leaf->next = left->next;
+      left->next = leaf;
+      separator = leaf->keys[0];
+      right = leaf;
+    } else {
+      auto left = static_cast<Inner*>(child);
+      Inner* inner = new_inner();
+      const size_t mid = left->count / 2;
+      inner->count = static_cast<uint16_t>(left->count - mid - 1);
+      std::move(left->keys + mid + 1, left->keys + left->count, inner->keys);
+      std::copy(left->children + mid + 1, left->children + left->count + 1, inner->children);
+      separator = std::move(left->keys[mid]);
+      left->count = static_cast<uint16_t>(mid);
+      right = inner;
+    }
+
+    std::move_backward(parent->keys + index, parent->keys + parent->count,
+                       parent->keys + parent->count + 1);
+    std::copy_backward(parent->children + index + 1, parent->children + parent->count + 1,
+                       parent->children + parent->count + 2);
+    parent->keys[index] = std::move(separator);
+    parent->children[index + 1] = right;
+    ++parent->count;
+  }
+
+  /**
+   * @brief Ensures the child at index of parent has more than the minimum number of entries by
+   * borrowing from or merging with a sibling.
+   *
+   * @return The node that now covers the keys of the child.
+   */
+  Node* refill_child(Inner* parent, size_t index) {
+    Node* child = parent->children[index];
+    const size_t min = child->leaf ? kLeafMin : kInnerMin;
+    if (child->count > min) {
+      return child;
+    }
+    if (index > 0 && parent->children[index - 1]->count > min) {
+      borrow_left(parent, index);
+      return child;
+    }
+    if (index < parent->count && parent->children[index + 1]->count > min) {
+      borrow_right(parent, index);
+      return child;
+    }
+    if (index < parent->count) {
+      merge(parent, index);
+      return child;
+    }
+    merge(parent, index - 1);
+    return parent->children[index - 1];
+  }
+
+  void borrow_left(Inner* parent, size_t index) noexcept {
+    Node* child = parent->children[index];
+    Node* sibling = parent->children[index - 1];
+    if (child->leaf) {
+      auto leaf = static_cast<Leaf*>(child);
+      auto left = static_cast<Leaf*>(sibling);
+      std::move_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+      std::move_backward(leaf->values, leaf->values + leaf->count,
+                         leaf->values + leaf->count + 1);
+      leaf->keys[0] = std::move(left->keys[left->count - 1]);
+      leaf->values[0] = std::move(left->values[left->count - 1]);
+      parent->keys[index - 1] = leaf->keys[0];
+    } else {
+      auto inner = static_cast<Inner*>(child);
+      auto left = static_cast<Inner*>(sibling);
+      std::move_backward(inner->keys, inner->keys + inner->count, inner->keys + inner->count + 1);
+      std::copy_backward(inner->children, inner->children + inner->count + 1,
+                         inner->children + inner->count + 2);
+      inner->keys[0] = std::move(parent->keys[index - 1]);
+      inner->children[0] = left->children[left->count];
+      parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+    }
+    ++child->count;
+    --sibling->count;
+  }
+
+  void borrow_right(Inner* parent, size_t index) noexcept {
+    Node* child = parent->children[index];
+    Node* sibling = parent->children[index + 1];
+    if (child->leaf) {
+      auto leaf = static_cast<Leaf*>(child);
+      auto right = static_cast<Leaf*>(sibling);
+      leaf->keys[leaf->count] = std::move(right->keys[0]);
+      leaf->values[leaf->count] = std::move(right->values[0]);
+      std::move(right->keys + 1, right->keys + right->count, right->keys);
+      std::move(right->values + 1, right->values + right->count, right->values);
+      parent->keys[index] = right->keys[0];
+    } else {
+      auto inner = static_cast<Inner*>(child);
+      auto right = static_cast<Inner*>(sibling);
+      inner->keys[inner->count] = std::move(parent->keys[index]);
+      inner->children[inner->count + 1] = right->children[0];
+      parent->keys[index] = std::move(right->keys[0]);
+      std::move(right->keys + 1, right->keys + right->count, right->keys);
+      std::copy(right->children + 1, right->children + right->count + 1, right->children);
+    }
+    ++child->count;
+    --sibling->count;
+  }
+
+  /**
+   * @brief Moves the child after index of parent into the child at index and frees it.
+   */
+  void merge(Inner* parent, size_t index) noexcept {
+    Node* child = parent->children[index];
+    Node* sibling = parent->children[index + 1];
+    if (child->leaf) {
+      auto leaf = static_cast<Leaf*>(child);
+      auto right = static_cast<Leaf*>(sibling);
+      std::move(right->keys, right->keys + right->count, leaf->keys + leaf->count);
+      std::move(right->values, right->values + right->count, leaf->values + leaf->count);
+      leaf->count = static_cast<uint16_t>(leaf->count + right->count);
+      leaf->next = right->next;
+      delete_leaf(right);
+    } else {
+      auto inner = static_cast<Inner*>(child);
+      auto right = static_cast<Inner*>(sibling);
+      inner->keys[inner->count] = std::move(parent->keys[index]);
+      std::move(right->keys, right->keys + right->count, inner->keys + inner->count + 1);
+      std::copy(right->children, right->children + right->count + 1,
+                inner->children + inner->count + 1);
+      inner->count = static_cast<uint16_t>(inner->count + right->count + 1);
+      delete_inner(right);
+    }
+
+    std::move(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+    std::copy(parent->children + index + 2, parent->children + parent->count + 1,
+              parent->children + index + 1);
+    --parent->count;
+  }
+
+  /**
+   * @brief Splits count items into the fewest groups of at most max, with sizes differing by at
+   * most one.
+   */
+  static size_t group_count(size_t count, size_t max) noexcept { return (count + max - 1) / max; }
+
+  template <typename It>
+  void build_sorted(It first, It last) {
+    // Each built node next to the smallest key below it, which separates it from its left sibling.
+    Vector<std::pair<Node*, K>> level{};
+    const size_t count = std::distance(first, last);
+    const size_t leaves = group_count(count, kLeafSlots);
+    Leaf* previous = nullptr;
+    for (size_t i = 0; i < leaves; ++i) {
+      Leaf* leaf = new_leaf();
+      const size_t size = count / leaves + (i < count % leaves);
+      for (; leaf->count < size; ++first) {
+        const auto& [key, value] = *first;
+        leaf->keys[leaf->count] = key;
+        leaf->values[leaf->count] = value;
+        ++leaf->count;
+      }
+      if (previous != nullptr) {
+        previous->next = leaf;
+      }
+      previous = leaf;
+      level.push_back({leaf, leaf->keys[0]});
+    }
+    _size = count;
+
+    while (level.size() > 1) {
+      Vector<std::pair<Node*, K>> parents{};
+      const size_t inners = group_count(level.size(), kInnerSlots + 1);
+      size_t next = 0;
+      for (size_t i = 0; i < inners; ++i) {
+        Inner* inner = new_inner();
+        const size_t children = level.size() / inners + (i < level.size() % inners);
+        parents.push_back({inner, level[next].second});
+        inner->children[0] = level[next].first;
+        for (size_t c = 1; c < children; ++c) {
+          inner->keys[c - 1] = level[next + c].second;
+          inner->children[c] = level[next + c].first;
+        }
+        inner->count = static_cast<uint16_t>(children - 1);
+        next += children;
+      }
+      level = std::move(parents);
+    }
+    _root = level.empty() ? nullptr : level[0].first;
+  }
+
+  Pool<sizeof(Leaf), alloc, dealloc> _leaves;
+  Pool<sizeof(Inner), alloc, dealloc> _inners;
+  Node* _root;
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_BTREE_MAP_H_
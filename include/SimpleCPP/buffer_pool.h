@@ -0,0 +1,151 @@
+#ifndef SIMPLECPP_BUFFER_POOL_H_
+#define SIMPLECPP_BUFFER_POOL_H_
+
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace simplecpp {
+/**
+    @brief A process wide arena of fixed size I/O buffers exposed as an allocator pair
+
+    @tparam buffer_size The number of bytes every buffer holds
+    @tparam buffer_count The number of buffers in the arena
+
+    @note allocate and deallocate are an Allocator and a Deallocator, so a Pointer<uint8_t[]> or
+   BasicBytes using them takes its block from the arena and puts it back when the last copy is
+   destroyed, without calling malloc. The arena is a single mapping that can be registered with
+   the kernel once for fixed buffer I/O. Requests larger than a buffer, or made while every buffer
+   is in use, fall back to malloc. The arena is mapped on first use and lives until the process
+   exits. This is thread safe.
+*/
+template <size_t buffer_size = 65536, size_t buffer_count = 64>
+class BufferPool {
+  static_assert(buffer_count > 0, "The pool must hold at least one buffer.");
+
+ public:
+  /**
+   * @brief The size of a block, which holds a buffer and the header of a Pointer<uint8_t[]>.
+   */
+  static constexpr size_t kBlockSize = (2 * sizeof(size_t) + buffer_size + 63) / 64 * 64;
+
+  BufferPool() = delete;
+
+  /**
+   * @brief Returns a block of at least size bytes, from the arena if one is free.
+   *
+   * @throws std::bad_alloc If the arena cannot be mapped or malloc fails.
+   */
+  static void* allocate(const size_t& size) {
+    if (size <= kBlockSize) {
+      State& pool = state();
+      std::lock_guard lock(pool.mutex);
+      if (pool.free != nullptr) {
+        FreeBlock* block = pool.free;
+        pool.free = block->next;
+        --pool.available;
+        return block;
+      }
+      if (pool.next != pool.arena + kArenaSize) {
+        void* block = pool.next;
+        pool.next += kBlockSize;
+        --pool.available;
+        return block;
+      }
+    }
+    void* data = std::malloc(size);
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    return data;
+  }
+
+  /**
+   * @brief Returns a block to the arena, or frees it if it was allocated with malloc.
+   */
+  static void deallocate(void* block) noexcept {
+    if (!owns(block)) {
+      std::free(block);
+      return;
+    }
+    State& pool = state();
+    std::lock_guard lock(pool.mutex);
+    auto free_block = static_cast<FreeBlock*>(block);
+    free_block->next = pool.free;
+    pool.free = free_block;
+    ++pool.available;
+  }
+
+  /**
+   * @brief Checks if ptr points into the arena, which is false for every ptr before it is mapped.
+   *
+   * @note This does not map the arena, so it never throws.
+   */
+  static bool owns(const void* ptr) noexcept {
+    const auto address = static_cast<const uint8_t*>(ptr);
+    const uint8_t* arena = mapped().load(std::memory_order_acquire);
+    return arena != nullptr && address >= arena && address < arena + kArenaSize;
+  }
+
+  /**
+   * @brief Returns the whole arena, e.g. to register it with io_uring.
+   */
+  static iovec region() { return iovec{state().arena, kArenaSize}; }
+
+  /**
+   * @brief Returns the number of free buffers in the arena.
+   */
+  static size_t available() {
+    State& pool = state();
+    std::lock_guard lock(pool.mutex);
+    return pool.available;
+  }
+
+ private:
+  static constexpr size_t kArenaSize = kBlockSize * buffer_count;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct State {
+    // Blocks are handed out from next before the free list is used, so untouched blocks are never
+    // faulted in.
+    State() : free(nullptr), available(buffer_count) {
+      void* data = ::mmap(nullptr, kArenaSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      arena = static_cast<uint8_t*>(data);
+      next = arena;
+      mapped().store(arena, std::memory_order_release);
+    }
+
+    std::mutex mutex;
+    FreeBlock* free;
+    uint8_t* arena;
+    uint8_t* next;
+    size_t available;
+  };
+
+  static State& state() {
+    static State pool;
+    return pool;
+  }
+
+  // The arena once State mapped it, constant initialized so reading it never maps the arena.
+  static std::atomic<uint8_t*>& mapped() noexcept {
+    static constinit std::atomic<uint8_t*> arena{nullptr};
+    return arena;
+  }
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_BUFFER_POOL_H_
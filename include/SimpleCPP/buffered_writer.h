@@ -0,0 +1,419 @@
+#ifndef SIMPLECPP_BUFFERED_WRITER_H_
+#define SIMPLECPP_BUFFERED_WRITER_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/futex.h>
+#include <SimpleCPP/pool.h>
+#include <SimpleCPP/vector.h>
+
+#include <poll.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A stream writer that buffers small writes in pooled chunks and writes them out with
+   writev, optionally from a background thread
+
+    @param alloc A custom allocator function used for the chunks
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam chunk_size The number of bytes every chunk holds
+
+    @note Writes are copied into the current chunk. Once flush_bytes are buffered, or flush_interval
+   passed since the last flush, the chunks are written with a single writev, either by the writing
+   thread or by a background thread that the chunks are handed to. Written chunks return to a Pool
+   and the chunk lists keep their capacity, so a steady stream of writes does not allocate. With
+   the background thread, the max_chunks chunks are allocated up front and a write that finds all
+   of them waiting to be written blocks until one is free. Bytes left buffered for flush_interval
+   are written by the background thread on its own, unless a write is in progress, which then
+   flushes when it returns. Inline, a due flush is only started by a later write, which checks the
+   clock once every kClockStride writes, or by flush(). A single BasicBufferedWriter must only be
+   used from one thread. The file descriptor is not closed.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator,
+          size_t chunk_size = 65536>
+class BasicBufferedWriter {
+ public:
+  /**
+   * @brief Where buffered chunks are written.
+   */
+  enum class Flush { kInline, kBackground };
+
+  /**
+   * @brief The number of chunks passed to a single writev call.
+   */
+  static constexpr size_t kMaxIov = 64;
+
+  /**
+   * @param fd The file descriptor to write to
+   * @param mode kBackground starts a thread that writes the chunks
+   * @param flush_bytes The number of buffered bytes that starts a flush
+   * @param flush_interval The time after which buffered bytes are flushed, 0 for no limit
+   * @param max_chunks The number of chunks used with the background thread, at least 2
+   */
+  explicit BasicBufferedWriter(int fd, Flush mode = Flush::kInline,
+                               size_t flush_bytes = 4 * chunk_size,
+                               std::chrono::milliseconds flush_interval =
+                                   std::chrono::milliseconds(100),
+                               size_t max_chunks = 16)
+      : _fd(fd),
+        _mode(mode),
+        _flush_bytes(std::max<size_t>(flush_bytes, 1)),
+        _flush_interval(flush_interval),
+        _max_chunks(std::max<size_t>(max_chunks, 2)),
+        _current(nullptr),
+        _buffered(0),
+        _writes(0),
+        _last_flush(std::chrono::steady_clock::now()),
+        _flush_due(false),
+        _calling(false),
+        _claimed(false),
+        _wake(0),
+        _flushed(0),
+        _in_use(0),
+        _busy(false),
+        _error(0),
+        _stop(false) {
+    if (_mode == Flush::kBackground) {
+      _chunks.reserve(_max_chunks);
+      _queue.reserve(_max_chunks);
+      _writing.reserve(_max_chunks);
+      for (size_t i = 0; i < _max_chunks; ++i) {
+        _chunks.push_back(static_cast<Chunk*>(_pool.allocate()));
+      }
+      for (Chunk* chunk : _chunks) {
+        _pool.deallocate(chunk);
+      }
+      _chunks.clear();
+      _thread = std::thread([this] { run(); });
+    }
+  }
+
+  BasicBufferedWriter(const BasicBufferedWriter&) = delete;
+  BasicBufferedWriter& operator=(const BasicBufferedWriter&) = delete;
+
+  /**
+   * @brief Flushes the buffered bytes, errors are ignored.
+   */
+  ~BasicBufferedWriter() noexcept {
+    try {
+      flush();
+    } catch (...) {
+      // A destructor cannot report the error, call flush() first to see it.
+    }
+    if (_mode == Flush::kBackground) {
+      {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+        detail::epoch_notify(_wake);
+      }
+      _thread.join();
+    }
+    std::lock_guard lock(_mutex);
+    for (Chunk* chunk : _chunks) {
+      _pool.deallocate(chunk);
+    }
+    if (_current != nullptr) {
+      _pool.deallocate(_current);
+    }
+  }
+
+  /**
+   * @brief Returns the number of bytes written but not flushed yet by this thread.
+   */
+  size_t buffered() const noexcept { return _buffered.load(std::memory_order_relaxed); }
+
+  /**
+   * @throws std::system_error If an earlier flush failed.
+   */
+  BasicBufferedWriter& write(const void* data, size_t count) {
+    const Call call(*this);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (count != 0) {
+      if (_current == nullptr || _current->size == chunk_size) {
+        next_chunk();
+      }
+      const size_t copied = std::min(count, chunk_size - _current->size);
+      std::memcpy(_current->data + _current->size, bytes, copied);
+      _current->size += copied;
+      const size_t buffered = _buffered.load(std::memory_order_relaxed) + copied;
+      _buffered.store(buffered, std::memory_order_relaxed);
+      bytes += copied;
+      count -= copied;
+    }
+    if (_buffered.load(std::memory_order_relaxed) >= _flush_bytes || is_flush_due()) {
+      dispatch();
+    }
+    return *this;
+  }
+
+  BasicBufferedWriter& write(std::string_view str) { return write(str.data(), str.size()); }
+
+  BasicBufferedWriter& put(char c) { return write(&c, 1); }
+
+  /**
+   * @brief Writes every buffered byte and waits for the background thread to write them.
+   *
+   * @throws std::system_error If writing failed.
+   */
+  void flush() {
+    {
+      const Call call(*this);
+      dispatch();
+    }
+    if (_mode == Flush::kBackground) {
+      std::unique_lock lock(_mutex);
+      detail::epoch_wait(_flushed, lock, [&] { return _queue.empty() && !_busy; });
+      throw_error();
+    }
+  }
+
+ private:
+  struct Chunk {
+    size_t size;
+    uint8_t data[chunk_size];
+  };
+
+  // Marks a call of the writing thread, the background thread only takes its chunks between calls.
+  class Call {
+   public:
+    explicit Call(BasicBufferedWriter& writer) noexcept : _writer(writer) {
+      if (_writer._mode == Flush::kBackground) {
+        // Sequentially consistent with the check in flush_idle(), so at most one side proceeds.
+        _writer._calling.store(true, std::memory_order_seq_cst);
+        while (_writer._claimed.load(std::memory_order_seq_cst)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    ~Call() noexcept {
+      if (_writer._mode == Flush::kBackground) {
+        _writer._calling.store(false, std::memory_order_release);
+      }
+    }
+
+    Call(const Call&) = delete;
+    Call& operator=(const Call&) = delete;
+
+   private:
+    BasicBufferedWriter& _writer;
+  };
+
+  // Inline writers check the clock once every this many writes, which keeps it off the fast path.
+  static constexpr uint32_t kClockStride = 64;
+
+  bool is_flush_due() noexcept {
+    if (_flush_interval.count() == 0) {
+      return false;
+    }
+    if (_mode == Flush::kBackground) {
+      return _flush_due.load(std::memory_order_relaxed);
+    }
+    if (++_writes % kClockStride != 0) {
+      return false;
+    }
+    return std::chrono::steady_clock::now() - _last_flush >= _flush_interval;
+  }
+
+  void next_chunk() {
+    if (_current != nullptr) {
+      _chunks.push_back(_current);
+      _current = nullptr;
+    }
+    std::unique_lock lock(_mutex);
+    throw_error();
+    if (_mode == Flush::kBackground && _in_use == _max_chunks) {
+      // Every chunk is full, so the full ones are handed over to free one up.
+      hand_off();
+      detail::epoch_wait(_flushed, lock, [&] { return _in_use < _max_chunks || _error != 0; });
+      throw_error();
+    }
+    _current = static_cast<Chunk*>(_pool.allocate());
+    _current->size = 0;
+    ++_in_use;
+  }
+
+  // Passes the buffered chunks on to be written.
+  void dispatch() {
+    if (_current != nullptr && _current->size != 0) {
+      _chunks.push_back(_current);
+      _current = nullptr;
+    }
+    _buffered.store(0, std::memory_order_relaxed);
+    _last_flush = std::chrono::steady_clock::now();
+    if (_chunks.empty()) {
+      return;
+    }
+    if (_mode == Flush::kInline) {
+      const int error = write_chunks(_chunks);
+      std::lock_guard lock(_mutex);
+      recycle(_chunks);
+      if (error != 0) {
+        throw std::system_error(error, std::generic_category(), "writev");
+      }
+      return;
+    }
+    _flush_due.store(false, std::memory_order_relaxed);
+    std::lock_guard lock(_mutex);
+    throw_error();
+    hand_off();
+  }
+
+  // Queues the full chunks for the background thread, _mutex must be held.
+  void hand_off() noexcept {
+    _buffered.store(0, std::memory_order_relaxed);
+    for (Chunk* chunk : _chunks) {
+      _queue.push_back(chunk);
+    }
+    _chunks.clear();
+    detail::epoch_notify(_wake);
+  }
+
+  void run() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+      if (!_queue.empty()) {
+        _writing.swap(_queue);
+        _busy = true;
+        lock.unlock();
+        const int error = write_chunks(_writing);
+        lock.lock();
+        recycle(_writing);
+        _busy = false;
+        if (error != 0 && _error == 0) {
+          _error = error;
+        }
+        detail::epoch_notify(_flushed);
+        continue;
+      }
+      if (_stop) {
+        return;
+      }
+      const uint32_t seen = _wake.load(std::memory_order_relaxed);
+      lock.unlock();
+      const bool woken = (_flush_interval.count() == 0)
+                             ? detail::futex_wait(_wake, seen)
+                             : detail::futex_wait(_wake, seen, _flush_interval);
+      lock.lock();
+      if (!woken) {
+        flush_idle();
+      }
+    }
+  }
+
+  // Hands the chunks of an idle writing thread to the background thread, or marks the flush as due
+  // if a call is in progress, _mutex must be held.
+  void flush_idle() noexcept {
+    _claimed.store(true, std::memory_order_seq_cst);
+    if (_calling.load(std::memory_order_seq_cst)) {
+      _flush_due.store(true, std::memory_order_relaxed);
+    } else {
+      if (_current != nullptr && _current->size != 0) {
+        _chunks.push_back(_current);
+        _current = nullptr;
+      }
+      if (!_chunks.empty()) {
+        hand_off();
+      }
+    }
+    _claimed.store(false, std::memory_order_release);
+  }
+
+  // Writes the chunks with as few writev calls as possible and returns 0 or the errno.
+  int write_chunks(const Vector<Chunk*, alloc, dealloc>& chunks) const noexcept {
+    size_t index = 0;
+    size_t offset = 0;
+    while (index != chunks.size()) {
+      iovec iov[kMaxIov];
+      int count = 0;
+      for (size_t i = index; i != chunks.size() && count != static_cast<int>(kMaxIov); ++i) {
+        const size_t skip = (i == index) ? offset : 0;
+        iov[count++] = iovec{chunks[i]->data + skip, chunks[i]->size - skip};
+      }
+      const ssize_t result = ::writev(_fd, iov, count);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          pollfd ready{_fd, POLLOUT, 0};
+          ::poll(&ready, 1, -1);
+          continue;
+        }
+        return errno;
+      }
+      size_t written = static_cast<size_t>(result);
+      while (index != chunks.size() && written >= chunks[index]->size - offset) {
+        written -= chunks[index]->size - offset;
+        offset = 0;
+        ++index;
+      }
+      offset += written;
+    }
+    return 0;
+  }
+
+  // Returns the chunks to the Pool, _mutex must be held.
+  void recycle(Vector<Chunk*, alloc, dealloc>& chunks) noexcept {
+    for (Chunk* chunk : chunks) {
+      _pool.deallocate(chunk);
+    }
+    _in_use -= chunks.size();
+    chunks.clear();
+  }
+
+  // Throws the error of a failed background write once, _mutex must be held.
+  void throw_error() {
+    if (_error != 0) {
+      throw std::system_error(std::exchange(_error, 0), std::generic_category(), "writev");
+    }
+  }
+
+  const int _fd;
+  const Flush _mode;
+  const size_t _flush_bytes;
+  const std::chrono::milliseconds _flush_interval;
+  const size_t _max_chunks;
+
+  // Only used by the writing thread, or by the background thread while it holds _claimed and no
+  // call is in progress. _buffered is atomic as buffered() may be called between calls.
+  Chunk* _current;
+  Vector<Chunk*, alloc, dealloc> _chunks;
+  std::atomic<size_t> _buffered;
+  uint32_t _writes;
+  std::chrono::steady_clock::time_point _last_flush;
+  std::atomic<bool> _flush_due;
+  std::atomic<bool> _calling;
+  std::atomic<bool> _claimed;
+
+  // Guarded by _mutex, shared with the background thread.
+  std::mutex _mutex;
+  Pool<sizeof(Chunk), alloc, dealloc, 4> _pool;
+  Vector<Chunk*, alloc, dealloc> _queue;
+  Vector<Chunk*, alloc, dealloc> _writing;
+  std::atomic<uint32_t> _wake;
+  std::atomic<uint32_t> _flushed;
+  size_t _in_use;
+  bool _busy;
+  int _error;
+  bool _stop;
+  std::thread _thread;
+};
+
+using BufferedWriter = BasicBufferedWriter<>;
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_BUFFERED_WRITER_H_
@@ -0,0 +1,384 @@
+#ifndef SIMPLECPP_BYTES_H_
+#define SIMPLECPP_BYTES_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/ref_count.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+template <Allocator alloc, Deallocator dealloc>
+class BasicIOBuf;
+
+namespace detail {
+/**
+ * @brief A shared, type erased owner of bytes that are not in a Pointer<uint8_t[]>, e.g. a
+ * memory mapping, which is destroyed with its last copy.
+ */
+template <Allocator alloc, Deallocator dealloc>
+class BytesOwner {
+ public:
+  BytesOwner() noexcept : _block(nullptr) {}
+
+  /**
+   * @brief Moves owner into a new block, which also remembers where the owned bytes start.
+   */
+  template <typename T>
+  BytesOwner(T owner, const uint8_t* data) : BytesOwner() {
+    void* memory = alloc(sizeof(Holder<T>));
+    try {
+      _block = new (memory) Holder<T>(std::move(owner), data);
+    } catch (...) {
+      dealloc(memory);
+      throw;
+    }
+  }
+
+  BytesOwner(const BytesOwner& other) noexcept : _block(other._block) {
+    if (_block != nullptr) {
+      ref_acquire(_block->refs);
+    }
+  }
+
+  BytesOwner(BytesOwner&& other) noexcept : _block(std::exchange(other._block, nullptr)) {}
+
+  ~BytesOwner() noexcept { release(); }
+
+  BytesOwner& operator=(const BytesOwner& other) noexcept {
+    BytesOwner copy(other);
+    std::swap(_block, copy._block);
+    return *this;
+  }
+
+  BytesOwner& operator=(BytesOwner&& other) noexcept {
+    BytesOwner moved(std::move(other));
+    std::swap(_block, moved._block);
+    return *this;
+  }
+
+  /**
+   * @brief Returns the start of the owned bytes, or nullptr if there is no owner.
+   */
+  const uint8_t* data() const noexcept { return _block != nullptr ? _block->data : nullptr; }
+
+  size_t get_ref_count() const noexcept {
+    return _block != nullptr ? ref_count(_block->refs) : 0;
+  }
+
+ private:
+  struct Block {
+    size_t refs;
+    const uint8_t* data;
+    void (*destroy)(Block*) noexcept;
+  };
+
+  template <typename T>
+  struct Holder : Block {
+    Holder(T&& owner, const uint8_t* data)
+        : Block{1, data, [](Block* block) noexcept {
+                  auto holder = static_cast<Holder*>(block);
+                  holder->~Holder();
+                  dealloc(holder);
+                }},
+          owner(std::move(owner)) {}
+
+    T owner;
+  };
+
+  void release() noexcept {
+    if (_block != nullptr && ref_release(_block->refs)) {
+      _block->destroy(_block);
+    }
+    _block = nullptr;
+  }
+
+  Block* _block;
+};
+}  // namespace detail
+
+/**
+    @brief An immutable view of a shared byte buffer that slices without copying
+
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note The bytes live in a Pointer<uint8_t[]>, so a slice is a copy of that Pointer with a
+   narrower range and the buffer is freed when the last slice is destroyed. Bytes owned by
+   something else, e.g. a BasicMappedFile, are shared the same way through a reference counted
+   owner instead of the buffer. A small slice keeps the whole buffer or owner alive.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicBytes {
+ public:
+  using buffer = Pointer<uint8_t[], alloc, dealloc>;
+  using iterator = const uint8_t*;
+  using const_iterator = const uint8_t*;
+
+  /**
+   * @brief Default constructor to create empty BasicBytes without allocating.
+   */
+  BasicBytes() noexcept : _buffer(), _owner(), _data(nullptr), _size(0) {}
+
+  /**
+   * @brief Copies str into a new buffer.
+   */
+  explicit BasicBytes(std::string_view str) : BasicBytes() {
+    if (!str.empty()) {
+      _buffer = buffer::for_overwrite(str.size());
+      std::memcpy(_buffer.get(), str.data(), str.size());
+      _data = _buffer.get();
+      _size = str.size();
+    }
+  }
+
+  /**
+   * @brief Views the whole of a shared buffer.
+   */
+  explicit BasicBytes(buffer data) noexcept
+      : _buffer(std::move(data)), _data(_buffer.get()), _size(_buffer.size()) {}
+
+  /**
+   * @brief Views length bytes of a shared buffer starting at offset.
+   *
+   * @throws std::out_of_range If the range is not within the buffer.
+   */
+  BasicBytes(buffer data, size_t offset, size_t length) : BasicBytes() {
+    if (offset > data.size() || length > data.size() - offset) {
+      throw std::out_of_range("Bytes range out of range.");
+    }
+    _data = data.get() + offset;
+    _size = length;
+    _buffer = std::move(data);
+  }
+
+  /**
+   * @brief Views size bytes at data without copying them, owner keeps them alive until the last
+   * slice is destroyed.
+   *
+   * @param owner A movable object whose destruction releases the bytes, e.g. the Pointer holding
+   * a memory mapping.
+   */
+  template <typename Owner>
+    requires(!std::is_same_v<std::remove_cvref_t<Owner>, buffer>)
+  BasicBytes(Owner owner, const uint8_t* data, size_t size) : BasicBytes() {
+    if (size != 0) {
+      _owner = owner_type(std::move(owner), data);
+      _data = data;
+      _size = size;
+    }
+  }
+
+  const uint8_t* data() const noexcept { return _data; }
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+
+  const_iterator begin() const noexcept { return _data; }
+  const_iterator end() const noexcept { return _data + _size; }
+
+  const uint8_t& operator[](size_t index) const noexcept { return _data[index]; }
+
+  /**
+   * @brief Returns the bytes as characters, e.g. for text protocols.
+   */
+  std::string_view as_string() const noexcept {
+    return {reinterpret_cast<const char*>(_data), _size};
+  }
+
+  /**
+   * @brief Returns the number of BasicBytes sharing the buffer or owner, or 0 if there is none.
+   */
+  size_t get_ref_count() const noexcept {
+    return _buffer.is_valid() ? _buffer.get_ref_count() : _owner.get_ref_count();
+  }
+
+  /**
+   * @brief Returns the bytes in [first, last) sharing this buffer.
+   *
+   * @throws std::out_of_range If the range is not within these bytes.
+   */
+  BasicBytes slice(size_t first, size_t last) const {
+    if (first > last || last > _size) {
+      throw std::out_of_range("Bytes slice out of range.");
+    }
+    BasicBytes result{};
+    if (first != last) {
+      result._buffer = _buffer;
+      result._owner = _owner;
+      result._data = _data + first;
+      result._size = last - first;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Removes the first count bytes and returns them, sharing this buffer.
+   *
+   * @throws std::out_of_range If count is greater than size().
+   */
+  BasicBytes split_to(size_t count) {
+    BasicBytes head = slice(0, count);
+    _data += count;
+    _size -= count;
+    return head;
+  }
+
+  /**
+   * @brief Removes the bytes from at onwards and returns them, sharing this buffer.
+   *
+   * @throws std::out_of_range If at is greater than size().
+   */
+  BasicBytes split_off(size_t at) {
+    BasicBytes tail = slice(at, _size);
+    _size = at;
+    return tail;
+  }
+
+  friend bool operator==(const BasicBytes& a, const BasicBytes& b) noexcept {
+    return a.as_string() == b.as_string();
+  }
+  friend bool operator==(const BasicBytes& a, std::string_view b) noexcept {
+    return a.as_string() == b;
+  }
+
+ private:
+  template <Allocator, Deallocator>
+  friend class BasicIOBuf;
+
+  using owner_type = detail::BytesOwner<alloc, dealloc>;
+
+  // At most one of _buffer and _owner is valid.
+  buffer _buffer;
+  owner_type _owner;
+  const uint8_t* _data;
+  size_t _size;
+};
+
+/**
+    @brief A growable byte buffer that freezes into BasicBytes without copying
+
+    @note The buffer is a Pointer<uint8_t[]> that is not shared until freeze(), which hands it to
+   the returned BasicBytes, so the capacity beyond size() stays allocated until the bytes are
+   released.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicBytesMut {
+ public:
+  using buffer = Pointer<uint8_t[], alloc, dealloc>;
+  using iterator = uint8_t*;
+  using const_iterator = const uint8_t*;
+
+  /**
+   * @brief Default constructor to create empty BasicBytesMut without allocating.
+   */
+  BasicBytesMut() noexcept : _buffer(), _size(0) {}
+
+  explicit BasicBytesMut(size_t capacity) : BasicBytesMut() { reserve(capacity); }
+
+  BasicBytesMut(const BasicBytesMut&) = delete;
+  BasicBytesMut& operator=(const BasicBytesMut&) = delete;
+
+  /**
+   * @note This leaves the other BasicBytesMut empty.
+   */
+  BasicBytesMut(BasicBytesMut&& other) noexcept
+      : _buffer(std::move(other._buffer)), _size(std::exchange(other._size, 0)) {}
+
+  BasicBytesMut& operator=(BasicBytesMut&& other) noexcept {
+    _buffer = std::move(other._buffer);
+    _size = std::exchange(other._size, 0);
+    return *this;
+  }
+
+  uint8_t* data() noexcept { return _buffer.get(); }
+  const uint8_t* data() const noexcept { return _buffer.get(); }
+  size_t size() const noexcept { return _size; }
+  size_t capacity() const noexcept { return _buffer.size(); }
+  bool empty() const noexcept { return _size == 0; }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + _size; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + _size; }
+
+  uint8_t& operator[](size_t index) noexcept { return data()[index]; }
+  const uint8_t& operator[](size_t index) const noexcept { return data()[index]; }
+
+  /**
+   * @brief Ensures the capacity is at least count bytes.
+   */
+  void reserve(size_t count) {
+    if (count > capacity()) {
+      buffer grown = buffer::for_overwrite(count);
+      if (_size != 0) {
+        std::memcpy(grown.get(), _buffer.get(), _size);
+      }
+      _buffer = std::move(grown);
+    }
+  }
+
+  /**
+   * @brief Resizes to count bytes, leaving new bytes uninitialized for the caller to fill.
+   */
+  void resize_for_overwrite(size_t count) {
+    reserve(count);
+    _size = count;
+  }
+
+  void push_back(uint8_t byte) {
+    grow_for(1);
+    _buffer[_size++] = byte;
+  }
+
+  BasicBytesMut& append(const void* bytes, size_t count) {
+    if (count != 0) {
+      grow_for(count);
+      std::memcpy(_buffer.get() + _size, bytes, count);
+      _size += count;
+    }
+    return *this;
+  }
+
+  BasicBytesMut& append(std::string_view str) { return append(str.data(), str.size()); }
+
+  void clear() noexcept { _size = 0; }
+
+  /**
+   * @brief Returns the contents as BasicBytes that take over the buffer, leaving this empty.
+   */
+  BasicBytes<alloc, dealloc> freeze() noexcept {
+    if (_size == 0) {
+      _buffer = buffer();
+      return {};
+    }
+    const size_t size = std::exchange(_size, 0);
+    return BasicBytes<alloc, dealloc>(std::move(_buffer), 0, size);
+  }
+
+ private:
+  void grow_for(size_t count) {
+    if (_size + count > capacity()) {
+      reserve(std::max(_size + count, 2 * capacity()));
+    }
+  }
+
+  buffer _buffer;
+  size_t _size;
+};
+
+using Bytes = BasicBytes<>;
+using BytesMut = BasicBytesMut<>;
+
+template <Allocator alloc, Deallocator dealloc>
+struct is_trivially_relocatable<BasicBytes<alloc, dealloc>> : std::true_type {};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_BYTES_H_
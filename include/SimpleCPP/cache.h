@@ -0,0 +1,445 @@
+#ifndef SIMPLECPP_CACHE_H_
+#define SIMPLECPP_CACHE_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/flat_hash_map.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/vector.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+ * @brief Evicts the least recently used entry, tracked with a doubly linked list of slots.
+ */
+class LruPolicy {
+ public:
+  LruPolicy() noexcept : _head(kNone), _tail(kNone) {}
+
+  void add_slot() { _links.push_back({kNone, kNone}); }
+
+  void on_insert(uint32_t slot) noexcept { link_front(slot); }
+
+  void on_access(uint32_t slot) noexcept {
+    if (slot != _head) {
+      unlink(slot);
+      link_front(slot);
+    }
+  }
+
+  void on_erase(uint32_t slot) noexcept { unlink(slot); }
+
+  /**
+   * @warning There must be at least one entry.
+   */
+  uint32_t victim() noexcept { return _tail; }
+
+  void clear() noexcept {
+    _links.clear();
+    _head = kNone;
+    _tail = kNone;
+  }
+
+ private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  struct Link {
+    uint32_t prev;
+    uint32_t next;
+  };
+
+  void link_front(uint32_t slot) noexcept {
+    _links[slot] = {kNone, _head};
+    if (_head != kNone) {
+      _links[_head].prev = slot;
+    } else {
+      _tail = slot;
+    }
+    _head = slot;
+  }
+
+  void unlink(uint32_t slot) noexcept {
+    const Link link = _links[slot];
+    if (link.prev != kNone) {
+      _links[link.prev].next = link.next;
+    } else {
+      _head = link.next;
+    }
+    if (link.next != kNone) {
+      _links[link.next].prev = link.prev;
+    } else {
+      _tail = link.prev;
+    }
+  }
+
+  Vector<Link> _links;
+  uint32_t _head;
+  uint32_t _tail;
+};
+
+/**
+ * @brief Approximates LRU with a reference bit per slot that a clock hand clears as it looks for an
+ * unreferenced entry.
+ *
+ * @note Hits only set a bit instead of relinking a list, and new entries start unreferenced so
+ * entries that are never read again are evicted first.
+ */
+class ClockPolicy {
+ public:
+  ClockPolicy() noexcept : _hand(0) {}
+
+  void add_slot() { _state.push_back(kFree); }
+
+  void on_insert(uint32_t slot) noexcept { _state[slot] = kLive; }
+
+  void on_access(uint32_t slot) noexcept { _state[slot] = kReferenced; }
+
+  void on_erase(uint32_t slot) noexcept { _state[slot] = kFree; }
+
+  /**
+   * @warning There must be at least one entry.
+   */
+  uint32_t victim() noexcept {
+    for (;;) {
+      const uint32_t slot = static_cast<uint32_t>(_hand);
+      _hand = (_hand + 1 == _state.size()) ? 0 : _hand + 1;
+      if (_state[slot] == kLive) {
+        return slot;
+      }
+      if (_state[slot] == kReferenced) {
+        _state[slot] = kLive;
+      }
+    }
+  }
+
+  void clear() noexcept {
+    _state.clear();
+    _hand = 0;
+  }
+
+ private:
+  static constexpr uint8_t kFree = 0;
+  static constexpr uint8_t kLive = 1;
+  static constexpr uint8_t kReferenced = 2;
+
+  Vector<uint8_t> _state;
+  size_t _hand;
+};
+
+/**
+ * @brief Weighs every entry as one so the capacity of a Cache is a number of entries.
+ */
+struct CountWeigher {
+  template <typename K, typename P>
+  size_t operator()(const K&, const P&) const noexcept {
+    return 1;
+  }
+};
+
+/**
+ * @brief Weighs an entry by the bytes its Pointer allocated so the capacity of a Cache is in bytes.
+ *
+ * @note Provide a custom weigher for values that own further memory, e.g. strings.
+ */
+struct AllocSizeWeigher {
+  template <typename K, typename P>
+  size_t operator()(const K&, const P& value) const noexcept {
+    return value.get_alloc_size();
+  }
+};
+
+/**
+    @brief A bounded map of Pointer values that evicts entries once their total weight exceeds the
+   capacity
+
+    @tparam K The type of the keys
+    @tparam V The type of the values, which are held as Pointer objects
+    @tparam Policy The eviction policy, LruPolicy or ClockPolicy
+    @tparam Weigher Returns the weight of an entry, CountWeigher or AllocSizeWeigher
+    @tparam Hash The hash function for the keys
+    @tparam Eq The equality function for the keys
+    @param alloc A custom allocator function used for the index and the values
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Eviction only drops the reference held by the Cache, values that were returned by get()
+   stay alive until their holders release them. Every operation is O(1).
+*/
+template <typename K, typename V, typename Policy = LruPolicy, typename Weigher = CountWeigher,
+          typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class Cache {
+ public:
+  using pointer = Pointer<V, alloc, dealloc>;
+
+  /**
+   * @param capacity The maximum total weight of the entries
+   */
+  explicit Cache(size_t capacity) noexcept : _capacity(capacity), _weight(0), _free(kNone) {}
+
+  Cache(const Cache&) = delete;
+  Cache& operator=(const Cache&) = delete;
+
+  size_t size() const noexcept { return _index.size(); }
+  bool empty() const noexcept { return _index.empty(); }
+  size_t capacity() const noexcept { return _capacity; }
+  size_t weight() const noexcept { return _weight; }
+
+  /**
+   * @brief Changes the capacity, evicting entries until they fit.
+   */
+  void set_capacity(size_t capacity) {
+    _capacity = capacity;
+    while (_weight > _capacity) {
+      evict();
+    }
+  }
+
+  /**
+   * @brief Returns the value for key and marks it as used, or an invalid Pointer if key is not
+   * present.
+   */
+  pointer get(const K& key) {
+    const auto it = _index.find(key);
+    if (it == _index.end()) {
+      return pointer(nullptr);
+    }
+    _policy.on_access(it->second);
+    return pointer(_slots[it->second].value);
+  }
+
+  /**
+   * @brief Returns the value for key without marking it as used, or an invalid Pointer.
+   */
+  pointer peek(const K& key) const {
+    const auto it = _index.find(key);
+    return (it == _index.end()) ? pointer(nullptr) : pointer(_slots[it->second].value);
+  }
+
+  bool contains(const K& key) const noexcept { return _index.contains(key); }
+
+  /**
+   * @brief Inserts or replaces the value for key, evicting entries until it fits.
+   *
+   * @return False if the entry weighs more than the capacity, in which case it is not cached and
+   * any previous value for key is removed.
+   */
+  bool put(const K& key, pointer value) {
+    erase(key);
+    const size_t weight = Weigher{}(key, value);
+    if (weight > _capacity) {
+      return false;
+    }
+    while (_weight + weight > _capacity) {
+      evict();
+    }
+
+    uint32_t slot = _free;
+    if (slot == kNone) {
+      slot = add_free_slot(key);
+    } else {
+      _slots[slot].key = key;
+    }
+    // The slot stays on the free list until the index holds it, so a throwing insert loses nothing.
+    _index.insert(key, slot);
+    _free = _slots[slot].next_free;
+    _slots[slot].value = std::move(value);
+    _slots[slot].weight = weight;
+    _policy.on_insert(slot);
+    _weight += weight;
+    return true;
+  }
+
+  /**
+   * @brief Removes the entry for key.
+   *
+   * @return False if key was not present.
+   */
+  bool erase(const K& key) {
+    const auto it = _index.find(key);
+    if (it == _index.end()) {
+      return false;
+    }
+    const uint32_t slot = it->second;
+    _index.erase(it);
+    release(slot);
+    return true;
+  }
+
+  void clear() noexcept {
+    _index.clear();
+    _slots.clear();
+    _policy.clear();
+    _weight = 0;
+    _free = kNone;
+  }
+
+ private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  struct Slot {
+    Slot(const K& key, pointer&& value, size_t weight)
+        : key(key), value(std::move(value)), weight(weight), next_free(kNone) {}
+
+    K key;
+    pointer value;
+    size_t weight;
+    uint32_t next_free;
+  };
+
+  // Appends an empty slot holding key to the free list, or changes nothing if that throws.
+  uint32_t add_free_slot(const K& key) {
+    const uint32_t slot = static_cast<uint32_t>(_slots.size());
+    _slots.emplace_back(key, pointer(nullptr), 0);
+    try {
+      _policy.add_slot();
+    } catch (...) {
+      _slots.pop_back();
+      throw;
+    }
+    _slots[slot].next_free = _free;
+    _free = slot;
+    return slot;
+  }
+
+  void evict() {
+    const uint32_t slot = _policy.victim();
+    _index.erase(_slots[slot].key);
+    release(slot);
+  }
+
+  void release(uint32_t slot) noexcept {
+    _policy.on_erase(slot);
+    _weight -= _slots[slot].weight;
+    _slots[slot].value = pointer(nullptr);
+    _slots[slot].next_free = _free;
+    _free = slot;
+  }
+
+  FlatHashMap<K, uint32_t, Hash, Eq, alloc, dealloc> _index;
+  Vector<Slot, alloc, dealloc> _slots;
+  Policy _policy;
+  size_t _capacity;
+  size_t _weight;
+  uint32_t _free;
+};
+
+/**
+    @brief A thread safe Cache split into independently locked shards
+
+    @tparam shard_count The number of shards, a power of two. Each shard gets an equal part of the
+   capacity, so an entry may be evicted before the total capacity is reached.
+
+    @note See Cache for the other parameters.
+*/
+template <typename K, typename V, typename Policy = LruPolicy, typename Weigher = CountWeigher,
+          typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator,
+          size_t shard_count = 16>
+class ShardedCache {
+  static_assert(std::has_single_bit(shard_count), "The shard count must be a power of two.");
+
+  using Shard = Cache<K, V, Policy, Weigher, Hash, Eq, alloc, dealloc>;
+
+ public:
+  using pointer = typename Shard::pointer;
+
+  /**
+   * @param capacity The maximum total weight of the entries across all shards, the first
+   * capacity % shard_count shards get one more than the others
+   *
+   * @throws std::invalid_argument If capacity is less than shard_count, which would leave a shard
+   * that caches nothing.
+   */
+  explicit ShardedCache(size_t capacity) {
+    if (capacity < shard_count) {
+      throw std::invalid_argument("The capacity must be at least the shard count.");
+    }
+    for (size_t i = 0; i < shard_count; ++i) {
+      _shards[i].cache.set_capacity(capacity / shard_count + (i < capacity % shard_count));
+    }
+  }
+
+  ShardedCache(const ShardedCache&) = delete;
+  ShardedCache& operator=(const ShardedCache&) = delete;
+
+  pointer get(const K& key) {
+    auto& shard = shard_for(key);
+    std::lock_guard lock(shard.mutex);
+    return shard.cache.get(key);
+  }
+
+  pointer peek(const K& key) const {
+    const auto& shard = shard_for(key);
+    std::lock_guard lock(shard.mutex);
+    return shard.cache.peek(key);
+  }
+
+  bool put(const K& key, pointer value) {
+    auto& shard = shard_for(key);
+    std::lock_guard lock(shard.mutex);
+    return shard.cache.put(key, std::move(value));
+  }
+
+  bool erase(const K& key) {
+    auto& shard = shard_for(key);
+    std::lock_guard lock(shard.mutex);
+    return shard.cache.erase(key);
+  }
+
+  /**
+   * @note The shards are counted one at a time, so concurrent writes may be partially counted.
+   */
+  size_t size() const {
+    size_t size = 0;
+    for (const auto& shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      size += shard.cache.size();
+    }
+    return size;
+  }
+
+  size_t weight() const {
+    size_t weight = 0;
+    for (const auto& shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      weight += shard.cache.weight();
+    }
+    return weight;
+  }
+
+  void clear() {
+    for (auto& shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      shard.cache.clear();
+    }
+  }
+
+ private:
+  // Even a hit relinks the LRU list, so each shard has a plain exclusive lock.
+  struct alignas(64) LockedShard {
+    mutable std::mutex mutex;
+    Shard cache{0};
+  };
+
+  static size_t shard_index(const K& key) noexcept {
+    if constexpr (shard_count == 1) {
+      return 0;
+    } else {
+      return detail::mix_hash(Hash{}(key)) >> (64 - std::countr_zero(shard_count));
+    }
+  }
+
+  LockedShard& shard_for(const K& key) noexcept { return _shards[shard_index(key)]; }
+  const LockedShard& shard_for(const K& key) const noexcept { return _shards[shard_index(key)]; }
+
+  LockedShard _shards[shard_count];
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_CACHE_H_
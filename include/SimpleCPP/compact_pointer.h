@@ -0,0 +1,291 @@
+#ifndef SIMPLECPP_COMPACT_POINTER_H_
+#define SIMPLECPP_COMPACT_POINTER_H_
+
+#include <SimpleCPP/ref_count.h>
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A process wide arena that hands out blocks as 32 bit handles
+
+    @tparam capacity The number of bytes of address space reserved for the arena
+    @tparam alignment The alignment of every block, a handle is the offset of a block divided by it
+    @tparam Tag A type that tells arenas with the same capacity and alignment apart
+
+    @note The whole capacity is reserved with a single mapping on first use, but pages are only
+   backed by memory once blocks in them are handed out, so the default 32GB costs nothing up front.
+   Freed blocks are kept in a free list per size and reused before the arena grows. Blocks do not
+   store their size, the caller passes it back to deallocate. Handle 0 is never handed out, so it
+   can mean null. This is thread safe.
+*/
+template <size_t capacity = (size_t{1} << 35), size_t alignment = 8, typename Tag = void>
+class CompactArena {
+  static_assert(std::has_single_bit(alignment) && alignment >= sizeof(uint32_t),
+                "The alignment must be a power of two of at least 4.");
+  static_assert(capacity / alignment <= (size_t{1} << 32),
+                "Every block in the arena must be reachable with a 32 bit handle.");
+
+ public:
+  static constexpr size_t kCapacity = capacity;
+  static constexpr size_t kAlignment = alignment;
+
+  CompactArena() = delete;
+
+  /**
+   * @brief Returns the handle of an uninitialized block of at least size bytes.
+   *
+   * @throws std::bad_alloc If the arena cannot be mapped or is full.
+   */
+  static uint32_t allocate(size_t size) {
+    const size_t size_class = class_of(size);
+    State& arena = state();
+    std::lock_guard lock(arena.mutex);
+    const uint32_t handle = arena.free[size_class];
+    if (handle != 0) {
+      arena.free[size_class] = *static_cast<uint32_t*>(at(handle));
+      return handle;
+    }
+    const size_t block = class_size(size_class);
+    if (capacity - arena.next < block) {
+      throw std::bad_alloc();
+    }
+    const size_t offset = arena.next;
+    arena.next += block;
+    return static_cast<uint32_t>(offset / alignment);
+  }
+
+  /**
+   * @brief Returns a block to the arena, size must be the size it was allocated with.
+   */
+  static void deallocate(uint32_t handle, size_t size) noexcept {
+    const size_t size_class = class_of(size);
+    State& arena = state();
+    std::lock_guard lock(arena.mutex);
+    *static_cast<uint32_t*>(at(handle)) = arena.free[size_class];
+    arena.free[size_class] = handle;
+  }
+
+  /**
+   * @brief Returns the address of the block behind handle.
+   */
+  static void* at(uint32_t handle) noexcept { return state().base + size_t{handle} * alignment; }
+
+  /**
+   * @brief Returns the handle of a block in the arena from its address.
+   */
+  static uint32_t handle_of(const void* block) noexcept {
+    return static_cast<uint32_t>((static_cast<const uint8_t*>(block) - state().base) / alignment);
+  }
+
+  /**
+   * @brief Returns the number of bytes handed out so far, including freed blocks.
+   */
+  static size_t used() {
+    State& arena = state();
+    std::lock_guard lock(arena.mutex);
+    return arena.next - alignment;
+  }
+
+ private:
+  // Blocks of up to kSmallClasses granules get a class each, larger ones round to a power of two.
+  static constexpr size_t kSmallClasses = 64;
+  static constexpr size_t kClasses = kSmallClasses + 64;
+
+  static constexpr size_t class_of(size_t size) noexcept {
+    const size_t granules = std::max<size_t>((size + alignment - 1) / alignment, 1);
+    if (granules <= kSmallClasses) {
+      return granules - 1;
+    }
+    return kSmallClasses - 7 + std::bit_width(granules - 1);
+  }
+
+  static constexpr size_t class_size(size_t size_class) noexcept {
+    if (size_class < kSmallClasses) {
+      return (size_class + 1) * alignment;
+    }
+    return (size_t{1} << (size_class - kSmallClasses + 7)) * alignment;
+  }
+
+  struct State {
+    State() : free{}, next(alignment) {
+      void* data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      base = static_cast<uint8_t*>(data);
+    }
+
+    std::mutex mutex;
+    uint32_t free[kClasses];
+    uint8_t* base;
+    size_t next;
+  };
+
+  static State& state() {
+    static State arena;
+    return arena;
+  }
+};
+
+/**
+    @brief A reference counted pointer that is 4 bytes large, storing a handle into a CompactArena
+
+    @tparam T The type of the data to be managed
+    @tparam Arena The CompactArena the data is allocated from
+
+    @note Pointer holds two 8 byte addresses, this holds one 32 bit handle and keeps a 32 bit
+   reference count in front of the data, so structures made of many small nodes take a fraction of
+   the memory and more of them fit in cache. Dereferencing adds the handle, scaled by the
+   alignment, to the base of the arena. Like Pointer, copies may be made and destroyed from
+   different threads.
+*/
+template <typename T, typename Arena = CompactArena<>>
+class CompactPointer {
+ public:
+  /**
+   * @brief Default constructor to create an invalid CompactPointer without allocating.
+   */
+  CompactPointer() noexcept : _handle(0) {}
+
+  explicit CompactPointer(std::nullptr_t) noexcept : CompactPointer() {}
+
+  explicit CompactPointer(const T& other) : CompactPointer() { construct(other); }
+
+  /**
+   * @brief Creates a CompactPointer that owns a new T move constructed from other.
+   */
+  explicit CompactPointer(T&& other) : CompactPointer() { construct(std::move(other)); }
+
+  /**
+   * @brief Creates a CompactPointer that owns a new T constructed from args.
+   */
+  template <typename... Args>
+  static CompactPointer make(Args&&... args) {
+    CompactPointer pointer{};
+    pointer.construct(std::forward<Args>(args)...);
+    return pointer;
+  }
+
+  /**
+   * @note This is a shallow copy just like with raw pointers.
+   */
+  CompactPointer(const CompactPointer& other) noexcept : _handle(other._handle) {
+    if (_handle != 0) {
+      detail::ref_acquire(block()->refs);
+    }
+  }
+
+  /**
+   * @note This leaves the other CompactPointer in an invalid state.
+   */
+  CompactPointer(CompactPointer&& other) noexcept : _handle(std::exchange(other._handle, 0)) {}
+
+  ~CompactPointer() noexcept { dec_ref(); }
+
+  CompactPointer& operator=(const CompactPointer& other) noexcept {
+    CompactPointer copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  CompactPointer& operator=(CompactPointer&& other) noexcept {
+    CompactPointer moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  void swap(CompactPointer& other) noexcept { std::swap(_handle, other._handle); }
+
+  T* get() noexcept { return is_valid() ? &block()->value : nullptr; }
+  const T* get() const noexcept { return is_valid() ? &block()->value : nullptr; }
+
+  /**
+   * @brief Returns the handle into Arena, 0 if this is invalid.
+   */
+  uint32_t handle() const noexcept { return _handle; }
+
+  /**
+   * @brief Returns the reference count, or 0 if this is invalid.
+   */
+  size_t get_ref_count() const noexcept {
+    return is_valid() ? detail::ref_count(block()->refs) : 0;
+  }
+
+  bool is_valid() const noexcept { return _handle != 0; }
+
+  T& operator*() const {
+    if (is_valid()) {
+      return block()->value;
+    } else {
+      throw std::runtime_error("Attempting to dereference a null pointer.");
+    }
+  }
+
+  T* operator->() const { return &**this; }
+
+  friend bool operator==(const CompactPointer& a, const CompactPointer& b) noexcept {
+    return a._handle == b._handle;
+  }
+  friend bool operator<(const CompactPointer& a, const CompactPointer& b) noexcept {
+    return a._handle < b._handle;
+  }
+  friend bool operator>(const CompactPointer& a, const CompactPointer& b) noexcept {
+    return a._handle > b._handle;
+  }
+
+ private:
+  struct Block {
+    template <typename... Args>
+    explicit Block(Args&&... args) : refs(1), value(std::forward<Args>(args)...) {}
+
+    uint32_t refs;
+    T value;
+  };
+
+  Block* block() const noexcept { return static_cast<Block*>(Arena::at(_handle)); }
+
+  /**
+   * @brief Constructs the data after the reference count, freeing the block if T throws.
+   */
+  template <typename... Args>
+  void construct(Args&&... args) {
+    // Checked here rather than in the class, so T may hold CompactPointers to itself.
+    static_assert(alignof(Block) <= Arena::kAlignment,
+                  "Types aligned above the alignment of the arena are not supported.");
+    const uint32_t handle = Arena::allocate(sizeof(Block));
+    try {
+      new (Arena::at(handle)) Block(std::forward<Args>(args)...);
+    } catch (...) {
+      Arena::deallocate(handle, sizeof(Block));
+      throw;
+    }
+    _handle = handle;
+  }
+
+  void dec_ref() noexcept {
+    if (is_valid()) {
+      if (detail::ref_release(block()->refs)) {
+        block()->~Block();
+        Arena::deallocate(_handle, sizeof(Block));
+      }
+      _handle = 0;
+    }
+  }
+
+  uint32_t _handle;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_COMPACT_POINTER_H_
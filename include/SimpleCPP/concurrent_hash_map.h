@@ -0,0 +1,184 @@
+#ifndef SIMPLECPP_CONCURRENT_HASH_MAP_H_
+#define SIMPLECPP_CONCURRENT_HASH_MAP_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/flat_hash_map.h>
+#include <SimpleCPP/pointer.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A thread safe hash map split into independently locked shards of FlatHashMap
+
+    @tparam K The type of the keys
+    @tparam V The type of the values, which are held as Pointer objects
+    @tparam Hash The hash function for the keys
+    @tparam Eq The equality function for the keys
+    @param alloc A custom allocator function used for the shards and the values
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam shard_count The number of shards, a power of two. More shards lower contention between
+   writers at the cost of memory.
+
+    @note Lookups return a copy of the stored Pointer, so a value stays alive for as long as the
+   caller holds it even if it is erased or replaced concurrently. Readers of a shard share its lock,
+   so read mostly workloads only contend on the lock's cache line.
+*/
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator,
+          size_t shard_count = 64>
+class ConcurrentHashMap {
+  static_assert(std::has_single_bit(shard_count), "The shard count must be a power of two.");
+
+ public:
+  using pointer = Pointer<V, alloc, dealloc>;
+
+  ConcurrentHashMap() = default;
+  ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+  ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+  /**
+   * @brief Returns the value for key or an invalid Pointer if key is not present.
+   */
+  pointer find(const K& key) const {
+    const Shard& shard = shard_for(key);
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return pointer(nullptr);
+    }
+    return pointer(it->second);
+  }
+
+  bool contains(const K& key) const {
+    const Shard& shard = shard_for(key);
+    std::shared_lock lock(shard.mutex);
+    return shard.map.contains(key);
+  }
+
+  /**
+   * @brief Inserts key and value if key is not present.
+   *
+   * @return False if key was already present, in which case the map is unchanged.
+   */
+  bool insert(const K& key, pointer value) {
+    Shard& shard = shard_for(key);
+    std::unique_lock lock(shard.mutex);
+    return shard.map.insert(key, std::move(value)).second;
+  }
+
+  /**
+   * @brief Inserts key and value, replacing the value if key is already present.
+   *
+   * @note Readers holding the old value keep it alive until they release it.
+   */
+  void insert_or_assign(const K& key, pointer value) {
+    Shard& shard = shard_for(key);
+    std::unique_lock lock(shard.mutex);
+    shard.map.insert_or_assign(key, std::move(value));
+  }
+
+  /**
+   * @brief Returns the value for key, inserting the result of make() if key is not present.
+   *
+   * @note make() is called with the shard locked, so it must not access this map.
+   */
+  template <typename Fn>
+  pointer find_or_insert(const K& key, Fn&& make) {
+    if (pointer found = find(key); found.is_valid()) {
+      return pointer(std::move(found));
+    }
+    Shard& shard = shard_for(key);
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      it = shard.map.insert(key, pointer(make())).first;
+    }
+    return pointer(it->second);
+  }
+
+  /**
+   * @brief Removes the entry for key.
+   *
+   * @return The removed value, or an invalid Pointer if key was not present.
+   */
+  pointer erase(const K& key) {
+    Shard& shard = shard_for(key);
+    std::unique_lock lock(shard.mutex);
+    const auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return pointer(nullptr);
+    }
+    pointer value(std::move(it->second));
+    shard.map.erase(it);
+    return pointer(std::move(value));
+  }
+
+  /**
+   * @brief Returns the number of entries.
+   *
+   * @note The shards are counted one at a time, so concurrent writes may be partially counted.
+   */
+  size_t size() const {
+    size_t size = 0;
+    for (const auto& shard : _shards) {
+      std::shared_lock lock(shard.mutex);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Calls fn(key, value) for each entry with the shard of the entry read locked.
+   *
+   * @note fn must not modify this map.
+   */
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (const auto& shard : _shards) {
+      std::shared_lock lock(shard.mutex);
+      for (const auto& [key, value] : shard.map) {
+        fn(key, value);
+      }
+    }
+  }
+
+  void clear() {
+    for (auto& shard : _shards) {
+      std::unique_lock lock(shard.mutex);
+      shard.map.clear();
+    }
+  }
+
+ private:
+  // Shards are cache line aligned so that locking one does not slow down its neighbours.
+  struct alignas(64) Shard {
+    mutable std::shared_mutex mutex;
+    FlatHashMap<K, pointer, Hash, Eq, alloc, dealloc> map;
+  };
+
+  static size_t shard_index(const K& key) noexcept {
+    if constexpr (shard_count == 1) {
+      return 0;
+    } else {
+      // The top bits pick the shard so they are independent of the bits each shard probes with.
+      return detail::mix_hash(Hash{}(key)) >> (64 - std::countr_zero(shard_count));
+    }
+  }
+
+  Shard& shard_for(const K& key) noexcept { return _shards[shard_index(key)]; }
+  const Shard& shard_for(const K& key) const noexcept { return _shards[shard_index(key)]; }
+
+  Shard _shards[shard_count];
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_CONCURRENT_HASH_MAP_H_
@@ -0,0 +1,346 @@
+#ifndef SIMPLECPP_DEQUE_H_
+#define SIMPLECPP_DEQUE_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/vector.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A double ended queue stored in fixed size blocks with a small cache of spare blocks
+
+    @tparam T The type of the elements
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam block_bytes The approximate size in bytes of every block
+
+    @note Pushing and popping at either end is O(1) and never moves elements, so references stay
+   valid until their element is popped. Up to kSpareBlocks blocks emptied by a pop are kept for
+   later pushes, so a queue whose size stays bounded stops allocating, and any further emptied block
+   is freed, so a spike does not pin its memory.
+*/
+template <typename T, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator, size_t block_bytes = 4096>
+class Deque {
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over aligned types are not supported.");
+
+ public:
+  static constexpr size_t kBlockElems = (sizeof(T) < block_bytes) ? block_bytes / sizeof(T) : 1;
+  // The number of emptied blocks kept for reuse, one is enough for a queue that moves forward.
+  static constexpr size_t kSpareBlocks = 2;
+
+ private:
+
+  template <bool is_const>
+  class Iterator {
+    using Owner = std::conditional_t<is_const, const Deque, Deque>;
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<is_const, const T*, T*>;
+    using reference = std::conditional_t<is_const, const T&, T&>;
+
+    Iterator() noexcept : _deque(nullptr), _index(0) {}
+    Iterator(Owner* deque, size_t index) noexcept : _deque(deque), _index(index) {}
+
+    /**
+     * @brief Converts a mutable iterator to a const one.
+     */
+    template <bool other_const>
+      requires(is_const && !other_const)
+    Iterator(const Iterator<other_const>& other) noexcept
+        : _deque(other._deque), _index(other._index) {}
+
+    reference operator*() const noexcept { return (*_deque)[_index]; }
+    pointer operator->() const noexcept { return &(*_deque)[_index]; }
+    reference operator[](difference_type n) const noexcept { return (*_deque)[_index + n]; }
+
+    Iterator& operator++() noexcept {
+      ++_index;
+      return *this;
+    }
+    Iterator operator++(int) noexcept { return {_deque, _index++}; }
+    Iterator& operator--() noexcept {
+      --_index;
+      return *this;
+    }
+    Iterator operator--(int) noexcept { return {_deque, _index--}; }
+    Iterator& operator+=(difference_type n) noexcept {
+      _index += n;
+      return *this;
+    }
+    Iterator& operator-=(difference_type n) noexcept {
+      _index -= n;
+      return *this;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+    friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+    friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept {
+      return static_cast<difference_type>(a._index) - static_cast<difference_type>(b._index);
+    }
+    friend bool operator==(const Iterator& a, const Iterator& b) noexcept {
+      return a._index == b._index;
+    }
+    friend auto operator<=>(const Iterator& a, const Iterator& b) noexcept {
+      return a._index <=> b._index;
+    }
+
+   private:
+    template <bool>
+    friend class Iterator;
+
+    Owner* _deque;
+    size_t _index;
+  };
+
+ public:
+  using value_type = T;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /**
+   * @brief Default constructor to create an empty Deque without allocating.
+   */
+  Deque() noexcept : _spare{}, _spares(0), _head(0), _blocks(0), _front(0), _size(0) {}
+
+  Deque(std::initializer_list<T> values) : Deque() {
+    for (const T& value : values) {
+      push_back(value);
+    }
+  }
+
+  Deque(const Deque& other) : Deque() {
+    for (const T& value : other) {
+      push_back(value);
+    }
+  }
+
+  /**
+   * @note This leaves the other Deque empty, references to its elements now refer to this one.
+   */
+  Deque(Deque&& other) noexcept : Deque() { swap(other); }
+
+  ~Deque() noexcept {
+    clear();
+    while (_spares > 0) {
+      dealloc(_spare[--_spares]);
+    }
+  }
+
+  Deque& operator=(const Deque& other) {
+    if (this != &other) {
+      Deque copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  Deque& operator=(Deque&& other) noexcept {
+    if (this != &other) {
+      Deque moved(std::move(other));
+      swap(moved);
+    }
+    return *this;
+  }
+
+  void swap(Deque& other) noexcept {
+    std::swap(_spare, other._spare);
+    std::swap(_spares, other._spares);
+    std::swap(_map, other._map);
+    std::swap(_head, other._head);
+    std::swap(_blocks, other._blocks);
+    std::swap(_front, other._front);
+    std::swap(_size, other._size);
+  }
+
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+
+  iterator begin() noexcept { return {this, 0}; }
+  iterator end() noexcept { return {this, _size}; }
+  const_iterator begin() const noexcept { return {this, 0}; }
+  const_iterator end() const noexcept { return {this, _size}; }
+
+  T& operator[](size_t index) noexcept { return *slot(_front + index); }
+  const T& operator[](size_t index) const noexcept { return *slot(_front + index); }
+
+  /**
+   * @throws std::out_of_range If index is not less than size().
+   */
+  T& at(size_t index) {
+    if (index >= _size) {
+      throw std::out_of_range("Deque index out of range.");
+    }
+    return (*this)[index];
+  }
+  const T& at(size_t index) const { return const_cast<Deque*>(this)->at(index); }
+
+  T& front() noexcept { return (*this)[0]; }
+  const T& front() const noexcept { return (*this)[0]; }
+  T& back() noexcept { return (*this)[_size - 1]; }
+  const T& back() const noexcept { return (*this)[_size - 1]; }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    const size_t position = _front + _size;
+    if (position == _blocks * kBlockElems) {
+      add_back_block();
+    }
+    T* value;
+    try {
+      value = new (slot(position)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      trim_back();
+      throw;
+    }
+    ++_size;
+    return *value;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  T& emplace_front(Args&&... args) {
+    if (_front == 0) {
+      add_front_block();
+    }
+    T* value;
+    try {
+      value = new (slot(_front - 1)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      trim_front();
+      throw;
+    }
+    --_front;
+    ++_size;
+    return *value;
+  }
+
+  void push_front(const T& value) { emplace_front(value); }
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  /**
+   * @warning The Deque must not be empty.
+   */
+  void pop_back() noexcept {
+    --_size;
+    slot(_front + _size)->~T();
+    trim_back();
+  }
+
+  /**
+   * @warning The Deque must not be empty.
+   */
+  void pop_front() noexcept {
+    slot(_front)->~T();
+    ++_front;
+    --_size;
+    trim_front();
+  }
+
+  /**
+   * @brief Destroys every element, keeping up to kSpareBlocks blocks for reuse.
+   */
+  void clear() noexcept {
+    while (_size > 0) {
+      pop_back();
+    }
+    while (_blocks > 0) {
+      release_block(_head);
+      _head = (_head + 1) & (_map.size() - 1);
+      --_blocks;
+    }
+    _front = 0;
+  }
+
+ private:
+  // The blocks are a ring in _map, whose size is zero or a power of two. Element positions are
+  // counted from the start of the block at _head.
+  T* slot(size_t position) const noexcept {
+    const size_t block = (_head + position / kBlockElems) & (_map.size() - 1);
+    return _map[block] + position % kBlockElems;
+  }
+
+  void reserve_block() {
+    if (_blocks < _map.size()) {
+      return;
+    }
+    Vector<T*, alloc, dealloc> map((_map.size() == 0) ? 8 : 2 * _map.size());
+    for (size_t i = 0; i < _blocks; ++i) {
+      map[i] = _map[(_head + i) & (_map.size() - 1)];
+    }
+    _map = std::move(map);
+    _head = 0;
+  }
+
+  void add_back_block() {
+    reserve_block();
+    _map[(_head + _blocks) & (_map.size() - 1)] = take_block();
+    ++_blocks;
+  }
+
+  void add_front_block() {
+    reserve_block();
+    const size_t head = (_head - 1) & (_map.size() - 1);
+    _map[head] = take_block();
+    _head = head;
+    ++_blocks;
+    _front += kBlockElems;
+  }
+
+  T* take_block() {
+    if (_spares > 0) {
+      return _spare[--_spares];
+    }
+    return static_cast<T*>(alloc(kBlockElems * sizeof(T)));
+  }
+
+  void release_block(size_t block) noexcept {
+    if (_spares < kSpareBlocks) {
+      _spare[_spares++] = _map[block];
+    } else {
+      dealloc(_map[block]);
+    }
+  }
+
+  // Releases the last block once no element uses it.
+  void trim_back() noexcept {
+    if (_blocks > 0 && _front + _size <= (_blocks - 1) * kBlockElems) {
+      --_blocks;
+      release_block((_head + _blocks) & (_map.size() - 1));
+    }
+  }
+
+  // Releases the first block once no element uses it.
+  void trim_front() noexcept {
+    if (_front >= kBlockElems) {
+      release_block(_head);
+      _head = (_head + 1) & (_map.size() - 1);
+      --_blocks;
+      _front -= kBlockElems;
+    }
+  }
+
+  T* _spare[kSpareBlocks];
+  size_t _spares;
+  Vector<T*, alloc, dealloc> _map;
+  size_t _head;
+  size_t _blocks;
+  size_t _front;
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_DEQUE_H_
@@ -0,0 +1,310 @@
+#ifndef SIMPLECPP_FLAT_GRAPH_H_
+#define SIMPLECPP_FLAT_GRAPH_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/bytes.h>
+#include <SimpleCPP/deque.h>
+#include <SimpleCPP/flat_hash_map.h>
+#include <SimpleCPP/pointer.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+ * @brief The position of a T in a flat graph, 0 for none.
+ *
+ * @note Flat types use FlatRef and FlatArray where the live types use Pointer, so they stay
+ * trivially copyable and can be read straight out of the buffer.
+ */
+template <typename T>
+struct FlatRef {
+  uint64_t offset = 0;
+
+  explicit operator bool() const noexcept { return offset != 0; }
+  friend bool operator==(const FlatRef& a, const FlatRef& b) noexcept = default;
+};
+
+/**
+ * @brief The position and length of an array of T in a flat graph.
+ */
+template <typename T>
+struct FlatArray {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+namespace detail {
+struct FlatHeader {
+  static constexpr uint64_t kMagic = 0x53696d706c654647;  // "SimpleFG"
+  static constexpr uint32_t kVersion = 1;
+
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t size;
+  uint64_t root;
+};
+
+// Objects are aligned relative to the start of the buffer, which is at least this aligned.
+inline constexpr size_t kFlatAlignment = 16;
+
+template <typename T>
+inline constexpr bool is_flat_v = std::is_trivially_copyable_v<T> && alignof(T) <= kFlatAlignment;
+}  // namespace detail
+
+/**
+    @brief Writes graphs of Pointers into a flat, position independent buffer
+
+    @param alloc A custom allocator function used for the buffer and the table of written objects
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Every object is written once, at an offset aligned for its type, and referred to by that
+   offset. Writing a Pointer that was written before, or a copy of it, returns the first offset, so
+   shared nodes of a DAG are not duplicated. Trivially copyable types are written as they are,
+   other types are written through an encode function that returns their flat form, writing the
+   Pointers they hold first. Children are written before their parents with one level of recursion
+   per level of the graph, and a cycle throws. The writer keeps a copy of every Pointer it wrote
+   until finish(), so their addresses are not reused by new data meanwhile. After finish() the
+   writer starts over with an empty buffer. The buffer uses the byte order and layout of the writing
+   machine.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicFlatWriter {
+ public:
+  /**
+   * @brief Creates a writer whose buffer holds only the header.
+   */
+  BasicFlatWriter() : _buffer(empty_buffer()) {}
+
+  BasicFlatWriter(const BasicFlatWriter&) = delete;
+  BasicFlatWriter& operator=(const BasicFlatWriter&) = delete;
+
+  /**
+   * @brief Returns the number of bytes written so far, including the header.
+   */
+  size_t size() const noexcept { return _buffer.size(); }
+
+  /**
+   * @brief Copies value into the buffer.
+   */
+  template <typename T>
+  FlatRef<T> write(const T& value) {
+    static_assert(detail::is_flat_v<T>, "Flat types must be trivially copyable.");
+    return FlatRef<T>{place(&value, sizeof(T), alignof(T))};
+  }
+
+  /**
+   * @brief Copies count values into the buffer as one array.
+   */
+  template <typename T>
+  FlatArray<T> write_array(const T* values, size_t count) {
+    static_assert(detail::is_flat_v<T>, "Flat types must be trivially copyable.");
+    if (count == 0) {
+      return {};
+    }
+    return FlatArray<T>{place(values, count * sizeof(T), alignof(T)), count};
+  }
+
+  /**
+   * @brief Writes the trivially copyable data of pointer once, an invalid Pointer gives a null
+   * FlatRef.
+   */
+  template <typename T, Allocator palloc, Deallocator pdealloc>
+  FlatRef<T> write(const Pointer<T, palloc, pdealloc>& pointer) {
+    return write(pointer, [](const T& value, BasicFlatWriter&) -> const T& { return value; });
+  }
+
+  /**
+   * @brief Writes encode(*pointer, *this) once, encode may call write for the Pointers held by
+   * the data and must return a trivially copyable value.
+   *
+   * @note If encode throws, pointer is not recorded as written, while the children it wrote are.
+   * @throws std::invalid_argument If the data of pointer is reached again while it is encoded.
+   */
+  template <typename T, Allocator palloc, Deallocator pdealloc, typename Encode>
+  auto write(const Pointer<T, palloc, pdealloc>& pointer, Encode&& encode)
+      -> FlatRef<std::remove_cvref_t<std::invoke_result_t<Encode&, const T&, BasicFlatWriter&>>> {
+    using Flat = std::remove_cvref_t<std::invoke_result_t<Encode&, const T&, BasicFlatWriter&>>;
+    if (!pointer.is_valid()) {
+      return {};
+    }
+    const void* key = pointer.get();
+    auto [entry, inserted] = _written.try_emplace(key, kEncoding);
+    if (!inserted) {
+      if (entry->second == kEncoding) {
+        throw std::invalid_argument("A flat graph must not contain cycles.");
+      }
+      return FlatRef<Flat>{entry->second};
+    }
+    try {
+      const FlatRef<Flat> ref = write<Flat>(encode(*pointer.get(), *this));
+      _held.emplace_back(pointer);
+      // Writing the children may have grown the table, so the entry is looked up again.
+      _written[key] = ref.offset;
+      return ref;
+    } catch (...) {
+      _written.erase(key);
+      throw;
+    }
+  }
+
+  /**
+   * @brief Stores root in the header and returns the buffer, leaving the writer as if it was new.
+   */
+  template <typename T>
+  BasicBytes<alloc, dealloc> finish(FlatRef<T> root) {
+    BasicBytesMut<alloc, dealloc> next = empty_buffer();
+    detail::FlatHeader header{detail::FlatHeader::kMagic, detail::FlatHeader::kVersion, 0,
+                              _buffer.size(), root.offset};
+    std::memcpy(_buffer.data(), &header, sizeof(header));
+    _written.clear();
+    _held.clear();
+    BasicBytes<alloc, dealloc> bytes = _buffer.freeze();
+    _buffer = std::move(next);
+    return bytes;
+  }
+
+ private:
+  static constexpr uint64_t kEncoding = UINT64_MAX;
+
+  // A copy of a written Pointer of any type.
+  class Held {
+   public:
+    template <typename P>
+    explicit Held(const P& pointer) noexcept
+        : _release([](void* storage) noexcept { std::launder(static_cast<P*>(storage))->~P(); }) {
+      static_assert(sizeof(P) <= sizeof(_storage) && alignof(P) <= alignof(void*),
+                    "Every Pointer must fit into Held.");
+      new (_storage) P(pointer);
+    }
+
+    ~Held() noexcept { _release(_storage); }
+
+    Held(const Held&) = delete;
+    Held& operator=(const Held&) = delete;
+
+   private:
+    void (*_release)(void*) noexcept;
+    alignas(void*) unsigned char _storage[2 * sizeof(void*)];
+  };
+
+  static BasicBytesMut<alloc, dealloc> empty_buffer() {
+    BasicBytesMut<alloc, dealloc> buffer(4096);
+    const detail::FlatHeader header{};
+    buffer.append(&header, sizeof(header));
+    return buffer;
+  }
+
+  uint64_t place(const void* data, size_t size, size_t alignment) {
+    static constexpr uint8_t kPadding[detail::kFlatAlignment] = {};
+    const size_t offset = (_buffer.size() + alignment - 1) / alignment * alignment;
+    _buffer.append(kPadding, offset - _buffer.size());
+    _buffer.append(data, size);
+    return offset;
+  }
+
+  BasicBytesMut<alloc, dealloc> _buffer;
+  FlatHashMap<const void*, uint64_t, std::hash<const void*>, std::equal_to<const void*>, alloc,
+              dealloc>
+      _written;
+  Deque<Held, alloc, dealloc> _held;
+};
+
+using FlatWriter = BasicFlatWriter<>;
+
+/**
+    @brief Reads a flat graph in place, e.g. straight out of a MappedFile
+
+    @note Nothing is copied or parsed up front, the constructor checks the header and every
+   FlatRef and FlatArray is checked against the bounds and alignment of the buffer when it is
+   resolved. The view does not own the buffer, which must outlive it.
+*/
+class FlatView {
+ public:
+  /**
+   * @throws std::runtime_error If data does not hold a flat graph of exactly size bytes.
+   */
+  FlatView(const void* data, size_t size) : _data(static_cast<const uint8_t*>(data)), _size(size) {
+    if (size < sizeof(detail::FlatHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(detail::FlatHeader) != 0) {
+      throw std::runtime_error("Not a flat graph.");
+    }
+    const auto header = reinterpret_cast<const detail::FlatHeader*>(_data);
+    if (header->magic != detail::FlatHeader::kMagic ||
+        header->version != detail::FlatHeader::kVersion || header->size != size) {
+      throw std::runtime_error("Not a flat graph.");
+    }
+  }
+
+  /**
+   * @brief Creates a view of bytes, e.g. a BasicBytes or a BasicMappedFile.
+   */
+  template <typename Buffer>
+  explicit FlatView(const Buffer& bytes) : FlatView(bytes.data(), bytes.size()) {}
+
+  size_t size() const noexcept { return _size; }
+
+  /**
+   * @brief Returns the root passed to BasicFlatWriter::finish.
+   *
+   * @throws std::out_of_range If there is no root or it does not hold a T.
+   */
+  template <typename T>
+  const T& root() const {
+    const T* value = get(FlatRef<T>{reinterpret_cast<const detail::FlatHeader*>(_data)->root});
+    if (value == nullptr) {
+      throw std::out_of_range("The flat graph has no root.");
+    }
+    return *value;
+  }
+
+  /**
+   * @brief Returns the T that ref refers to, or nullptr for a null FlatRef.
+   *
+   * @throws std::out_of_range If ref does not point to a T within the buffer.
+   */
+  template <typename T>
+  const T* get(FlatRef<T> ref) const {
+    static_assert(detail::is_flat_v<T>, "Flat types must be trivially copyable.");
+    if (!ref) {
+      return nullptr;
+    }
+    check(ref.offset, 1, sizeof(T), alignof(T));
+    return reinterpret_cast<const T*>(_data + ref.offset);
+  }
+
+  /**
+   * @throws std::out_of_range If array does not lie within the buffer.
+   */
+  template <typename T>
+  std::span<const T> get(FlatArray<T> array) const {
+    static_assert(detail::is_flat_v<T>, "Flat types must be trivially copyable.");
+    if (array.size == 0) {
+      return {};
+    }
+    check(array.offset, array.size, sizeof(T), alignof(T));
+    return {reinterpret_cast<const T*>(_data + array.offset), static_cast<size_t>(array.size)};
+  }
+
+ private:
+  void check(uint64_t offset, uint64_t count, size_t size, size_t alignment) const {
+    if (offset < sizeof(detail::FlatHeader) || offset > _size || count > (_size - offset) / size ||
+        reinterpret_cast<uintptr_t>(_data + offset) % alignment != 0) {
+      throw std::out_of_range("Invalid offset in a flat graph.");
+    }
+  }
+
+  const uint8_t* _data;
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_FLAT_GRAPH_H_
@@ -0,0 +1,521 @@
+#ifndef SIMPLECPP_FLAT_HASH_MAP_H_
+#define SIMPLECPP_FLAT_HASH_MAP_H_
+
+#include <SimpleCPP/allocator.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace simplecpp {
+namespace detail {
+/**
+ * @brief Control byte values of an open addressing table, full slots store 7 bits of the hash.
+ */
+enum class Ctrl : int8_t { kEmpty = -128, kDeleted = -2 };
+
+/**
+ * @brief Spreads the bits of a hash so identity hashes such as std::hash<int> probe well.
+ */
+inline uint64_t mix_hash(uint64_t hash) noexcept {
+  const __uint128_t product = static_cast<__uint128_t>(hash) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+/**
+ * @brief A group of 16 control bytes that is matched in parallel, with SSE2 if available.
+ *
+ * @note Every match returns a mask with bit i set if byte i matches.
+ */
+class CtrlGroup {
+ public:
+  static constexpr size_t kWidth = 16;
+
+#ifdef __SSE2__
+  explicit CtrlGroup(const int8_t* ctrl) noexcept
+      : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+  uint32_t match(int8_t h2) const noexcept {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+  }
+
+  uint32_t match_empty() const noexcept {
+    return match(static_cast<int8_t>(Ctrl::kEmpty));
+  }
+
+  uint32_t match_empty_or_deleted() const noexcept {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_ctrl));
+  }
+
+ private:
+  __m128i _ctrl;
+#else
+  explicit CtrlGroup(const int8_t* ctrl) noexcept {
+    std::memcpy(&_low, ctrl, sizeof(_low));
+    std::memcpy(&_high, ctrl + sizeof(_low), sizeof(_high));
+  }
+
+  uint32_t match(int8_t h2) const noexcept {
+    const uint64_t pattern = kLsbs * static_cast<uint8_t>(h2);
+    return combine(zero_bytes(_low ^ pattern), zero_bytes(_high ^ pattern));
+  }
+
+  uint32_t match_empty() const noexcept {
+    // Empty is the only value with the high bit set and bit one clear.
+    return combine(_low & ~(_low << 6) & kMsbs, _high & ~(_high << 6) & kMsbs);
+  }
+
+  uint32_t match_empty_or_deleted() const noexcept {
+    return combine(_low & kMsbs, _high & kMsbs);
+  }
+
+ private:
+  static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+  static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+
+  /**
+   * @brief Sets the high bit of each zero byte, possibly also of a 0x01 byte after a zero byte.
+   *
+   * @note False positives are harmless since every match is confirmed by comparing keys.
+   */
+  static uint64_t zero_bytes(uint64_t word) noexcept { return (word - kLsbs) & ~word & kMsbs; }
+
+  /**
+   * @brief Packs the high bit of each byte of both words into a 16 bit mask.
+   */
+  static uint32_t combine(uint64_t low, uint64_t high) noexcept {
+    constexpr uint64_t kGather = 0x0102040810204080ULL;
+    return static_cast<uint32_t>((((low >> 7) * kGather) >> 56) |
+                                 ((((high >> 7) * kGather) >> 56) << 8));
+  }
+
+  uint64_t _low;
+  uint64_t _high;
+#endif
+};
+}  // namespace detail
+
+/**
+    @brief A hash map that stores its entries in one flat array probed by groups of control bytes
+
+    @tparam K The type of the keys
+    @tparam V The type of the values
+    @tparam Hash The hash function for the keys
+    @tparam Eq The equality function for the keys
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Iterators and references are invalidated by any insertion that grows the table.
+*/
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class FlatHashMap {
+  using Group = detail::CtrlGroup;
+  using Ctrl = detail::Ctrl;
+
+ public:
+  /**
+   * @note The key of an entry must not be modified through an iterator.
+   */
+  using value_type = std::pair<K, V>;
+
+  template <bool is_const>
+  class Iterator {
+    using Entry = std::conditional_t<is_const, const value_type, value_type>;
+
+   public:
+    Iterator() noexcept : _ctrl(nullptr), _end(nullptr), _slot(nullptr) {}
+    Iterator(const int8_t* ctrl, const int8_t* end, Entry* slot) noexcept
+        : _ctrl(ctrl), _end(end), _slot(slot) {
+      skip_empty();
+    }
+
+    /**
+     * @brief Converts a mutable iterator to a const one.
+     */
+    template <bool other_const>
+      requires(is_const && !other_const)
+    Iterator(const Iterator<other_const>& other) noexcept
+        : _ctrl(other._ctrl), _end(other._end), _slot(other._slot) {}
+
+    Entry& operator*() const noexcept { return *_slot; }
+    Entry* operator->() const noexcept { return _slot; }
+
+    Iterator& operator++() noexcept {
+      ++_ctrl;
+      ++_slot;
+      skip_empty();
+      return *this;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) noexcept {
+      return a._slot == b._slot;
+    }
+
+   private:
+    friend class FlatHashMap;
+    template <bool>
+    friend class Iterator;
+
+    void skip_empty() noexcept {
+      while (_ctrl != _end && *_ctrl < 0) {
+        ++_ctrl;
+        ++_slot;
+      }
+    }
+
+    const int8_t* _ctrl;
+    const int8_t* _end;
+    Entry* _slot;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /**
+   * @brief Default constructor to create an empty FlatHashMap without allocating.
+   */
+  FlatHashMap() noexcept
+      : _ctrl(nullptr), _slots(nullptr), _capacity(0), _size(0), _growth_left(0) {}
+
+  FlatHashMap(const FlatHashMap& other) : FlatHashMap() {
+    reserve(other._size);
+    for (const auto& [key, value] : other) {
+      insert_unique(hash_of(key), key, value);
+    }
+  }
+
+  /**
+   * @note This leaves the other FlatHashMap empty
+   */
+  FlatHashMap(FlatHashMap&& other) noexcept
+      : _ctrl(other._ctrl),
+        _slots(other._slots),
+        _capacity(other._capacity),
+        _size(other._size),
+        _growth_left(other._growth_left) {
+    other.reset();
+  }
+
+  ~FlatHashMap() noexcept { destroy(); }
+
+  FlatHashMap& operator=(const FlatHashMap& other) {
+    if (this != &other) {
+      FlatHashMap copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      _ctrl = other._ctrl;
+      _slots = other._slots;
+      _capacity = other._capacity;
+      _size = other._size;
+      _growth_left = other._growth_left;
+      other.reset();
+    }
+    return *this;
+  }
+
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+  size_t capacity() const noexcept { return _capacity; }
+
+  iterator begin() noexcept { return {_ctrl, _ctrl + _capacity, _slots}; }
+  iterator end() noexcept { return {_ctrl + _capacity, _ctrl + _capacity, _slots + _capacity}; }
+  const_iterator begin() const noexcept { return {_ctrl, _ctrl + _capacity, _slots}; }
+  const_iterator end() const noexcept {
+    return {_ctrl + _capacity, _ctrl + _capacity, _slots + _capacity};
+  }
+
+  iterator find(const K& key) noexcept {
+    const size_t index = find_index(hash_of(key), key);
+    return (index == _capacity) ? end() : iterator_at(index);
+  }
+  const_iterator find(const K& key) const noexcept {
+    const size_t index = find_index(hash_of(key), key);
+    return (index == _capacity) ? end() : const_iterator(iterator_at(index));
+  }
+
+  bool contains(const K& key) const noexcept { return find_index(hash_of(key), key) != _capacity; }
+
+  /**
+   * @throws std::out_of_range If the key is not in the FlatHashMap.
+   */
+  V& at(const K& key) {
+    const size_t index = find_index(hash_of(key), key);
+    if (index == _capacity) {
+      throw std::out_of_range("FlatHashMap key not found.");
+    }
+    return _slots[index].second;
+  }
+  const V& at(const K& key) const { return const_cast<FlatHashMap*>(this)->at(key); }
+
+  /**
+   * @brief Returns the value for key, value initializing it if the key is not present.
+   */
+  V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  /**
+   * @brief Inserts key with a value constructed from args if key is not present.
+   *
+   * @return An iterator to the entry for key and whether it was inserted.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    const uint64_t hash = hash_of(key);
+    const size_t index = find_index(hash, key);
+    if (index != _capacity) {
+      return {iterator_at(index), false};
+    }
+    return {iterator_at(insert_unique(hash, key, std::forward<Args>(args)...)), true};
+  }
+
+  /**
+   * @brief Inserts key and value if key is not present, otherwise leaves the map unchanged.
+   */
+  std::pair<iterator, bool> insert(const K& key, const V& value) { return try_emplace(key, value); }
+  std::pair<iterator, bool> insert(const K& key, V&& value) {
+    return try_emplace(key, std::move(value));
+  }
+
+  /**
+   * @brief Inserts key and value, replacing the value if key is already present.
+   */
+  template <typename T>
+  std::pair<iterator, bool> insert_or_assign(const K& key, T&& value) {
+    auto result = try_emplace(key, std::forward<T>(value));
+    if (!result.second) {
+      result.first->second = std::forward<T>(value);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Removes the entry for key.
+   *
+   * @return False if key was not present.
+   */
+  bool erase(const K& key) noexcept {
+    const size_t index = find_index(hash_of(key), key);
+    if (index == _capacity) {
+      return false;
+    }
+    erase_at(index);
+    return true;
+  }
+
+  /**
+   * @brief Removes the entry at pos.
+   *
+   * @note Unlike std::unordered_map this returns nothing, increment a copy of pos beforehand to
+   * keep iterating.
+   */
+  void erase(const_iterator pos) noexcept { erase_at(pos._slot - _slots); }
+
+  /**
+   * @brief Ensures count entries can be held without growing.
+   */
+  void reserve(size_t count) {
+    if (count > _size + _growth_left) {
+      resize(capacity_for(count));
+    }
+  }
+
+  /**
+   * @brief Removes every entry but keeps the capacity.
+   */
+  void clear() noexcept {
+    destroy_entries();
+    if (_capacity != 0) {
+      std::memset(_ctrl, static_cast<int8_t>(Ctrl::kEmpty), _capacity);
+    }
+    _size = 0;
+    _growth_left = max_load(_capacity);
+  }
+
+ private:
+  uint64_t hash_of(const K& key) const noexcept { return detail::mix_hash(Hash{}(key)); }
+  static size_t h1(uint64_t hash) noexcept { return hash >> 7; }
+  static int8_t h2(uint64_t hash) noexcept { return static_cast<int8_t>(hash & 0x7F); }
+
+  static size_t max_load(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+  static size_t capacity_for(size_t count) noexcept {
+    size_t capacity = Group::kWidth;
+    while (max_load(capacity) < count) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  iterator iterator_at(size_t index) const noexcept {
+    return {_ctrl + index, _ctrl + _capacity, _slots + index};
+  }
+
+  /**
+   * @brief Visits groups in triangular order, which reaches every group of a power of two table.
+   */
+  template <typename Fn>
+  size_t probe(uint64_t hash, Fn&& fn) const noexcept {
+    const size_t group_mask = _capacity / Group::kWidth - 1;
+    size_t group = h1(hash) & group_mask;
+    for (size_t step = 1;; ++step) {
+      const size_t base = group * Group::kWidth;
+      const size_t result = fn(base, Group(_ctrl + base));
+      if (result != SIZE_MAX) {
+        return result;
+      }
+      group = (group + step) & group_mask;
+    }
+  }
+
+  size_t find_index(uint64_t hash, const K& key) const noexcept {
+    if (_capacity == 0) {
+      return 0;
+    }
+    return probe(hash, [&](size_t base, const Group& group) -> size_t {
+      for (uint32_t match = group.match(h2(hash)); match != 0; match &= match - 1) {
+        const size_t index = base + std::countr_zero(match);
+        if (Eq{}(_slots[index].first, key)) {
+          return index;
+        }
+      }
+      // No probe sequence continues past a group with an empty slot.
+      return (group.match_empty() != 0) ? _capacity : SIZE_MAX;
+    });
+  }
+
+  size_t find_non_full(uint64_t hash) const noexcept {
+    return probe(hash, [](size_t base, const Group& group) -> size_t {
+      const uint32_t match = group.match_empty_or_deleted();
+      return (match != 0) ? base + std::countr_zero(match) : SIZE_MAX;
+    });
+  }
+
+  /**
+   * @brief Inserts an entry for a key that is known not to be present.
+   *
+   * @return The index of the new entry.
+   */
+  template <typename... Args>
+  size_t insert_unique(uint64_t hash, const K& key, Args&&... args) {
+    if (_capacity == 0) {
+      resize(Group::kWidth);
+    }
+    size_t index = find_non_full(hash);
+    if (_growth_left == 0 && _ctrl[index] == static_cast<int8_t>(Ctrl::kEmpty)) {
+      // Rehash in place when mostly tombstones are left, otherwise double the capacity.
+      resize((_size < max_load(_capacity) / 2) ? _capacity : _capacity * 2);
+      index = find_non_full(hash);
+    }
+    new (_slots + index) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+    if (_ctrl[index] == static_cast<int8_t>(Ctrl::kEmpty)) {
+      --_growth_left;
+    }
+    _ctrl[index] = h2(hash);
+    ++_size;
+    return index;
+  }
+
+  void erase_at(size_t index) noexcept {
+    _slots[index].~value_type();
+    --_size;
+    const size_t base = index & ~(Group::kWidth - 1);
+    if (Group(_ctrl + base).match_empty() != 0) {
+      // Lookups stop at this group anyway, so the slot can be reused as if it was never full.
+      _ctrl[index] = static_cast<int8_t>(Ctrl::kEmpty);
+      ++_growth_left;
+    } else {
+      _ctrl[index] = static_cast<int8_t>(Ctrl::kDeleted);
+    }
+  }
+
+  static size_t slots_offset(size_t capacity) noexcept {
+    constexpr size_t align = alignof(value_type);
+    return (capacity + align - 1) / align * align;
+  }
+
+  void resize(size_t capacity) {
+    static_assert(alignof(value_type) <= alignof(std::max_align_t),
+                  "Over aligned types are not supported.");
+    const size_t offset = slots_offset(capacity);
+    auto memory = static_cast<char*>(alloc(offset + capacity * sizeof(value_type)));
+    int8_t* old_ctrl = _ctrl;
+    value_type* old_slots = _slots;
+    const size_t old_capacity = _capacity;
+
+    _ctrl = reinterpret_cast<int8_t*>(memory);
+    _slots = reinterpret_cast<value_type*>(memory + offset);
+    _capacity = capacity;
+    _growth_left = max_load(capacity) - _size;
+    std::memset(_ctrl, static_cast<int8_t>(Ctrl::kEmpty), capacity);
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] >= 0) {
+        const uint64_t hash = hash_of(old_slots[i].first);
+        const size_t index = find_non_full(hash);
+        _ctrl[index] = h2(hash);
+        if constexpr (is_trivially_relocatable_v<value_type>) {
+          std::memcpy(static_cast<void*>(_slots + index), static_cast<const void*>(old_slots + i),
+                      sizeof(value_type));
+        } else {
+          new (_slots + index) value_type(std::move(old_slots[i]));
+          old_slots[i].~value_type();
+        }
+      }
+    }
+    if (old_ctrl != nullptr) {
+      dealloc(old_ctrl);
+    }
+  }
+
+  void destroy_entries() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_t i = 0; i < _capacity; ++i) {
+        if (_ctrl[i] >= 0) {
+          _slots[i].~value_type();
+        }
+      }
+    }
+  }
+
+  void destroy() noexcept {
+    destroy_entries();
+    if (_ctrl != nullptr) {
+      dealloc(_ctrl);
+    }
+    reset();
+  }
+
+  void reset() noexcept {
+    _ctrl = nullptr;
+    _slots = nullptr;
+    _capacity = 0;
+    _size = 0;
+    _growth_left = 0;
+  }
+
+  int8_t* _ctrl;
+  value_type* _slots;
+  size_t _capacity;
+  size_t _size;
+  size_t _growth_left;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_FLAT_HASH_MAP_H_
@@ -0,0 +1,252 @@
+#ifndef SIMPLECPP_FLAT_MAP_H_
+#define SIMPLECPP_FLAT_MAP_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/vector.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+ * @brief Tag to construct a FlatMap from entries that are already sorted and unique.
+ */
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+/**
+    @brief An ordered map stored as a sorted array that can be frozen into an Eytzinger layout for
+   faster lookups
+
+    @tparam K The type of the keys
+    @tparam V The type of the values
+    @tparam Compare The strict ordering of the keys
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Inserting or erasing is O(n) and unfreezes the map. freeze() stores a copy of the keys in
+   breadth first order of the implicit binary search tree, so the first levels share cache lines
+   and the search loop is branchless and prefetches the cache line of its descendants a few levels
+   ahead.
+*/
+template <typename K, typename V, typename Compare = std::less<K>,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class FlatMap {
+ public:
+  using value_type = std::pair<K, V>;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+  /**
+   * @brief Default constructor to create an empty FlatMap without allocating.
+   */
+  FlatMap() noexcept = default;
+
+  /**
+   * @brief Creates a FlatMap from entries that may be unsorted, keeping the first of equal keys.
+   */
+  FlatMap(std::initializer_list<value_type> entries) : _entries() {
+    _entries.reserve_exact(entries.size());
+    for (const auto& entry : entries) {
+      _entries.push_back_unchecked(entry);
+    }
+    std::stable_sort(_entries.begin(), _entries.end(), [](const auto& a, const auto& b) {
+      return Compare{}(a.first, b.first);
+    });
+    auto last = std::unique(_entries.begin(), _entries.end(), [](const auto& a, const auto& b) {
+      return !Compare{}(a.first, b.first);
+    });
+    _entries.resize(last - _entries.begin());
+  }
+
+  /**
+   * @brief Creates a FlatMap from entries in O(n).
+   *
+   * @warning The entries must be sorted by key without duplicates.
+   */
+  FlatMap(sorted_unique_t, Vector<value_type, alloc, dealloc> entries) noexcept
+      : _entries(std::move(entries)) {}
+
+  /**
+   * @brief Creates a FlatMap from the range [first, last) in O(n).
+   *
+   * @warning The entries must be sorted by key without duplicates.
+   */
+  template <typename It>
+  FlatMap(sorted_unique_t, It first, It last) {
+    for (; first != last; ++first) {
+      _entries.push_back(*first);
+    }
+  }
+
+  size_t size() const noexcept { return _entries.size(); }
+  bool empty() const noexcept { return _entries.empty(); }
+  bool is_frozen() const noexcept { return _layout.size() == _entries.size() + 1; }
+
+  iterator begin() noexcept { return _entries.begin(); }
+  iterator end() noexcept { return _entries.end(); }
+  const_iterator begin() const noexcept { return _entries.begin(); }
+  const_iterator end() const noexcept { return _entries.end(); }
+
+  /**
+   * @brief Builds the Eytzinger layout in O(n) so later lookups use it.
+   */
+  void freeze() {
+    if (is_frozen()) {
+      return;
+    }
+    const size_t n = _entries.size();
+    Vector<K, alloc, dealloc> layout(n + 1);
+    Vector<size_t, alloc, dealloc> ranks(n + 1);
+    size_t rank = 0;
+    build(layout, ranks, 1, rank);
+    _layout = std::move(layout);
+    _ranks = std::move(ranks);
+  }
+
+  /**
+   * @brief Drops the Eytzinger layout, freeing its memory.
+   */
+  void unfreeze() noexcept {
+    _layout = Vector<K, alloc, dealloc>();
+    _ranks = Vector<size_t, alloc, dealloc>();
+  }
+
+  /**
+   * @brief Returns the first entry whose key is not less than key.
+   */
+  iterator lower_bound(const K& key) noexcept { return begin() + lower_bound_index(key); }
+  const_iterator lower_bound(const K& key) const noexcept {
+    return begin() + lower_bound_index(key);
+  }
+
+  /**
+   * @brief Returns the first entry whose key is greater than key.
+   */
+  iterator upper_bound(const K& key) noexcept {
+    iterator it = lower_bound(key);
+    return (it != end() && !Compare{}(key, it->first)) ? it + 1 : it;
+  }
+  const_iterator upper_bound(const K& key) const noexcept {
+    const_iterator it = lower_bound(key);
+    return (it != end() && !Compare{}(key, it->first)) ? it + 1 : it;
+  }
+
+  /**
+   * @brief Returns the entries with keys in [low, high).
+   */
+  std::pair<iterator, iterator> range(const K& low, const K& high) noexcept {
+    return {lower_bound(low), lower_bound(high)};
+  }
+  std::pair<const_iterator, const_iterator> range(const K& low, const K& high) const noexcept {
+    return {lower_bound(low), lower_bound(high)};
+  }
+
+  iterator find(const K& key) noexcept {
+    iterator it = lower_bound(key);
+    return (it != end() && !Compare{}(key, it->first)) ? it : end();
+  }
+  const_iterator find(const K& key) const noexcept {
+    const_iterator it = lower_bound(key);
+    return (it != end() && !Compare{}(key, it->first)) ? it : end();
+  }
+
+  bool contains(const K& key) const noexcept { return find(key) != end(); }
+
+  /**
+   * @throws std::out_of_range If the key is not in the FlatMap.
+   */
+  V& at(const K& key) {
+    iterator it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("FlatMap key not found.");
+    }
+    return it->second;
+  }
+  const V& at(const K& key) const { return const_cast<FlatMap*>(this)->at(key); }
+
+  /**
+   * @brief Inserts key and value if key is not present.
+   *
+   * @return An iterator to the entry for key and whether it was inserted.
+   */
+  std::pair<iterator, bool> insert(const K& key, V value) {
+    iterator it = lower_bound(key);
+    if (it != end() && !Compare{}(key, it->first)) {
+      return {it, false};
+    }
+    unfreeze();
+    return {_entries.insert(it, value_type(key, std::move(value))), true};
+  }
+
+  /**
+   * @brief Removes the entry for key.
+   *
+   * @return False if key was not present.
+   */
+  bool erase(const K& key) {
+    iterator it = find(key);
+    if (it == end()) {
+      return false;
+    }
+    unfreeze();
+    _entries.erase(it);
+    return true;
+  }
+
+  void clear() noexcept {
+    unfreeze();
+    _entries.clear();
+  }
+
+ private:
+  // Keys per cache line, which is also the number of descendants log2(kLineNodes) levels down.
+  static constexpr size_t kLineNodes = (sizeof(K) >= 64) ? 1 : std::bit_floor(64 / sizeof(K));
+
+  void build(Vector<K, alloc, dealloc>& layout, Vector<size_t, alloc, dealloc>& ranks, size_t node,
+             size_t& rank) {
+    // In order traversal of the implicit tree, whose depth is only log2(n).
+    if (node < layout.size()) {
+      build(layout, ranks, 2 * node, rank);
+      layout[node] = _entries[rank].first;
+      ranks[node] = rank;
+      ++rank;
+      build(layout, ranks, 2 * node + 1, rank);
+    }
+  }
+
+  size_t lower_bound_index(const K& key) const noexcept {
+    if (!is_frozen()) {
+      return std::lower_bound(_entries.begin(), _entries.end(), key,
+                              [](const value_type& entry, const K& k) {
+                                return Compare{}(entry.first, k);
+                              }) -
+             _entries.begin();
+    }
+    // Those descendants are consecutive, starting at kLineNodes * node.
+    const K* keys = _layout.data();
+    const size_t n = _entries.size();
+    size_t node = 1;
+    while (node <= n) {
+      __builtin_prefetch(keys + kLineNodes * node);
+      node = 2 * node + Compare{}(keys[node], key);
+    }
+    // The path went right after the answer for every trailing one, so drop those and one more.
+    node >>= std::countr_one(node) + 1;
+    return (node == 0) ? n : _ranks[node];
+  }
+
+  Vector<value_type, alloc, dealloc> _entries;
+  Vector<K, alloc, dealloc> _layout;
+  Vector<size_t, alloc, dealloc> _ranks;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_FLAT_MAP_H_
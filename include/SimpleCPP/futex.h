@@ -0,0 +1,79 @@
+#ifndef SIMPLECPP_FUTEX_H_
+#define SIMPLECPP_FUTEX_H_
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+
+namespace simplecpp {
+namespace detail {
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "A futex must be a plain 32 bit word.");
+
+/**
+ * @brief Blocks while word holds expected, until futex_wake is called on it or timeout elapsed.
+ *
+ * @param timeout A negative timeout waits without a limit.
+ * @return False if the timeout elapsed. Spurious wake ups return true, so callers must check the
+ * condition they wait for again.
+ */
+inline bool futex_wait(std::atomic<uint32_t>& word, uint32_t expected,
+                       std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) noexcept {
+  timespec limit{};
+  timespec* limit_ptr = nullptr;
+  if (timeout.count() >= 0) {
+    limit.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    limit.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    limit_ptr = &limit;
+  }
+  const long result = ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word),
+                                FUTEX_WAIT_PRIVATE, expected, limit_ptr, nullptr, 0);
+  return result == 0 || errno != ETIMEDOUT;
+}
+
+/**
+ * @brief Wakes up to count threads blocked in futex_wait on word.
+ */
+inline void futex_wake(std::atomic<uint32_t>& word, int count = INT_MAX) noexcept {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr,
+            nullptr, 0);
+}
+
+/**
+ * @brief Waits with a mutex held by lock until ready() is true, parking in futex_wait on epoch.
+ *
+ * @note Every change that may make ready() true must be followed by epoch_notify on epoch with the
+ * mutex held. The waiter reads epoch with the mutex held before it parks, so a change made after
+ * ready() was checked bumps epoch first and futex_wait returns right away.
+ */
+template <typename Ready>
+inline void epoch_wait(std::atomic<uint32_t>& epoch, std::unique_lock<std::mutex>& lock,
+                       Ready&& ready) {
+  while (!ready()) {
+    const uint32_t seen = epoch.load(std::memory_order_relaxed);
+    lock.unlock();
+    futex_wait(epoch, seen);
+    lock.lock();
+  }
+}
+
+/**
+ * @brief Bumps epoch and wakes every thread in epoch_wait on it.
+ */
+inline void epoch_notify(std::atomic<uint32_t>& epoch) noexcept {
+  epoch.fetch_add(1, std::memory_order_release);
+  futex_wake(epoch);
+}
+}  // namespace detail
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_FUTEX_H_
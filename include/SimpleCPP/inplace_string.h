@@ -0,0 +1,168 @@
+#ifndef SIMPLECPP_INPLACE_STRING_H_
+#define SIMPLECPP_INPLACE_STRING_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+namespace simplecpp {
+/**
+    @brief A null terminated string of up to N characters that are all stored inline
+
+    @tparam N The maximum number of characters, excluding the null terminator
+
+    @note This never allocates and is usable in constant expressions. The checked functions throw
+   std::length_error or std::out_of_range, the unchecked and try_ variants never throw.
+*/
+template <size_t N>
+class InplaceString {
+ public:
+  using iterator = char*;
+  using const_iterator = const char*;
+
+  /**
+   * @brief Default constructor to create an empty InplaceString.
+   */
+  constexpr InplaceString() noexcept : _data{}, _size(0) {}
+
+  /**
+   * @throws std::length_error If str is longer than N characters.
+   */
+  constexpr explicit InplaceString(std::string_view str) : InplaceString() { append(str); }
+  constexpr explicit InplaceString(const char* str) : InplaceString(std::string_view(str)) {}
+
+  constexpr char* data() noexcept { return _data; }
+  constexpr const char* data() const noexcept { return _data; }
+  constexpr const char* c_str() const noexcept { return _data; }
+  constexpr size_t size() const noexcept { return _size; }
+  static constexpr size_t capacity() noexcept { return N; }
+  constexpr bool empty() const noexcept { return _size == 0; }
+  constexpr bool full() const noexcept { return _size == N; }
+
+  constexpr iterator begin() noexcept { return _data; }
+  constexpr iterator end() noexcept { return _data + _size; }
+  constexpr const_iterator begin() const noexcept { return _data; }
+  constexpr const_iterator end() const noexcept { return _data + _size; }
+
+  constexpr operator std::string_view() const noexcept { return {_data, _size}; }
+
+  /**
+   * @brief Accesses the character at index without bounds checking.
+   */
+  constexpr char& operator[](size_t index) noexcept { return _data[index]; }
+  constexpr const char& operator[](size_t index) const noexcept { return _data[index]; }
+
+  /**
+   * @brief Accesses the character at index.
+   *
+   * @throws std::out_of_range If index is not less than size().
+   */
+  constexpr char& at(size_t index) {
+    check_index(index);
+    return _data[index];
+  }
+  constexpr const char& at(size_t index) const {
+    check_index(index);
+    return _data[index];
+  }
+
+  /**
+   * @throws std::length_error If the InplaceString is full.
+   */
+  constexpr void push_back(char c) {
+    check_capacity(_size + 1);
+    push_back_unchecked(c);
+  }
+
+  /**
+   * @brief Appends c without checking the capacity.
+   *
+   * @warning The caller must ensure the InplaceString is not full.
+   */
+  constexpr void push_back_unchecked(char c) noexcept {
+    _data[_size] = c;
+    _data[++_size] = '\0';
+  }
+
+  /**
+   * @throws std::length_error If the result would be longer than N characters.
+   */
+  constexpr InplaceString& append(std::string_view str) {
+    check_capacity(_size + str.size());
+    return append_unchecked(str);
+  }
+
+  /**
+   * @brief Appends str without checking the capacity.
+   *
+   * @warning The caller must ensure size() + str.size() <= N.
+   */
+  constexpr InplaceString& append_unchecked(std::string_view str) noexcept {
+    for (const char c : str) {
+      _data[_size++] = c;
+    }
+    _data[_size] = '\0';
+    return *this;
+  }
+
+  /**
+   * @brief Appends as much of str as fits.
+   *
+   * @return False if str was truncated.
+   */
+  constexpr bool try_append(std::string_view str) noexcept {
+    const size_t space = N - _size;
+    append_unchecked(str.substr(0, space));
+    return str.size() <= space;
+  }
+
+  constexpr InplaceString& operator+=(std::string_view str) { return append(str); }
+
+  /**
+   * @brief Removes the last character.
+   *
+   * @warning The InplaceString must not be empty.
+   */
+  constexpr void pop_back() noexcept { _data[--_size] = '\0'; }
+
+  /**
+   * @brief Shortens the string to count characters if it is longer.
+   */
+  constexpr void truncate(size_t count) noexcept {
+    if (count < _size) {
+      _size = count;
+      _data[_size] = '\0';
+    }
+  }
+
+  constexpr void clear() noexcept { truncate(0); }
+
+  friend constexpr bool operator==(const InplaceString& a, const InplaceString& b) noexcept {
+    return std::string_view(a) == std::string_view(b);
+  }
+  friend constexpr bool operator==(const InplaceString& a, std::string_view b) noexcept {
+    return std::string_view(a) == b;
+  }
+  friend constexpr auto operator<=>(const InplaceString& a, const InplaceString& b) noexcept {
+    return std::string_view(a) <=> std::string_view(b);
+  }
+
+ private:
+  constexpr void check_index(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("InplaceString index out of range.");
+    }
+  }
+
+  static constexpr void check_capacity(size_t count) {
+    if (count > N) {
+      throw std::length_error("InplaceString capacity exceeded.");
+    }
+  }
+
+  char _data[N + 1];
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_INPLACE_STRING_H_
@@ -0,0 +1,276 @@
+#ifndef SIMPLECPP_INPLACE_VECTOR_H_
+#define SIMPLECPP_INPLACE_VECTOR_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A Vector with a fixed capacity of N elements that are all stored inline
+
+    @tparam T The type of the elements
+    @tparam N The maximum number of elements
+
+    @note This never allocates and is usable in constant expressions. The checked functions throw
+   std::length_error or std::out_of_range, the unchecked and try_ variants never throw.
+*/
+template <typename T, size_t N>
+class InplaceVector {
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * @brief Default constructor to create an empty InplaceVector.
+   */
+  constexpr InplaceVector() noexcept : _size(0) {}
+
+  /**
+   * @brief Creates an InplaceVector of count value initialized elements.
+   *
+   * @throws std::length_error If count is greater than N.
+   */
+  constexpr explicit InplaceVector(size_t count) : InplaceVector() { resize(count); }
+
+  /**
+   * @throws std::length_error If values has more than N elements.
+   */
+  constexpr InplaceVector(std::initializer_list<T> values) : InplaceVector() {
+    check_capacity(values.size());
+    for (const auto& value : values) {
+      emplace_back_unchecked(value);
+    }
+  }
+
+  constexpr InplaceVector(const InplaceVector& other)
+    requires std::is_trivially_copy_constructible_v<T>
+  = default;
+  constexpr InplaceVector(const InplaceVector& other) : InplaceVector() {
+    for (const auto& value : other) {
+      emplace_back_unchecked(value);
+    }
+  }
+
+  constexpr InplaceVector(InplaceVector&& other) noexcept
+    requires std::is_trivially_move_constructible_v<T>
+  = default;
+  /**
+   * @brief Move constructor that moves each element of other.
+   *
+   * @note The moved from elements are destroyed, leaving the other InplaceVector empty
+   */
+  constexpr InplaceVector(InplaceVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      : InplaceVector() {
+    for (auto& value : other) {
+      emplace_back_unchecked(std::move(value));
+    }
+    other.clear();
+  }
+
+  constexpr ~InplaceVector()
+    requires std::is_trivially_destructible_v<T>
+  = default;
+  constexpr ~InplaceVector() { clear(); }
+
+  constexpr InplaceVector& operator=(const InplaceVector& other)
+    requires std::is_trivially_copy_assignable_v<T> && std::is_trivially_destructible_v<T>
+  = default;
+  constexpr InplaceVector& operator=(const InplaceVector& other) {
+    if (this != &other) {
+      clear();
+      for (const auto& value : other) {
+        emplace_back_unchecked(value);
+      }
+    }
+    return *this;
+  }
+
+  constexpr InplaceVector& operator=(InplaceVector&& other) noexcept
+    requires std::is_trivially_move_assignable_v<T> && std::is_trivially_destructible_v<T>
+  = default;
+  constexpr InplaceVector& operator=(InplaceVector&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      for (auto& value : other) {
+        emplace_back_unchecked(std::move(value));
+      }
+      other.clear();
+    }
+    return *this;
+  }
+
+  constexpr T* data() noexcept { return _data; }
+  constexpr const T* data() const noexcept { return _data; }
+  constexpr size_t size() const noexcept { return _size; }
+  static constexpr size_t capacity() noexcept { return N; }
+  constexpr bool empty() const noexcept { return _size == 0; }
+  constexpr bool full() const noexcept { return _size == N; }
+
+  constexpr iterator begin() noexcept { return _data; }
+  constexpr iterator end() noexcept { return _data + _size; }
+  constexpr const_iterator begin() const noexcept { return _data; }
+  constexpr const_iterator end() const noexcept { return _data + _size; }
+
+  /**
+   * @brief Accesses the element at index without bounds checking.
+   */
+  constexpr T& operator[](size_t index) noexcept { return _data[index]; }
+  constexpr const T& operator[](size_t index) const noexcept { return _data[index]; }
+
+  /**
+   * @brief Accesses the element at index.
+   *
+   * @throws std::out_of_range If index is not less than size().
+   */
+  constexpr T& at(size_t index) {
+    check_index(index);
+    return _data[index];
+  }
+  constexpr const T& at(size_t index) const {
+    check_index(index);
+    return _data[index];
+  }
+
+  constexpr T& front() noexcept { return _data[0]; }
+  constexpr const T& front() const noexcept { return _data[0]; }
+  constexpr T& back() noexcept { return _data[_size - 1]; }
+  constexpr const T& back() const noexcept { return _data[_size - 1]; }
+
+  /**
+   * @throws std::length_error If the InplaceVector is full.
+   */
+  template <typename... Args>
+  constexpr T& emplace_back(Args&&... args) {
+    check_capacity(_size + 1);
+    return emplace_back_unchecked(std::forward<Args>(args)...);
+  }
+
+  constexpr void push_back(const T& value) { emplace_back(value); }
+  constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  /**
+   * @brief Constructs an element at the end without checking the capacity.
+   *
+   * @warning The caller must ensure the InplaceVector is not full.
+   */
+  template <typename... Args>
+  constexpr T& emplace_back_unchecked(Args&&... args) {
+    T* slot = std::construct_at(_data + _size, std::forward<Args>(args)...);
+    ++_size;
+    return *slot;
+  }
+
+  constexpr void push_back_unchecked(const T& value) { emplace_back_unchecked(value); }
+  constexpr void push_back_unchecked(T&& value) { emplace_back_unchecked(std::move(value)); }
+
+  /**
+   * @brief Appends value if there is space.
+   *
+   * @return False if the InplaceVector was full, in which case nothing is appended.
+   */
+  constexpr bool try_push_back(const T& value) {
+    if (full()) {
+      return false;
+    }
+    emplace_back_unchecked(value);
+    return true;
+  }
+  constexpr bool try_push_back(T&& value) {
+    if (full()) {
+      return false;
+    }
+    emplace_back_unchecked(std::move(value));
+    return true;
+  }
+
+  /**
+   * @brief Destroys the last element.
+   *
+   * @warning The InplaceVector must not be empty.
+   */
+  constexpr void pop_back() noexcept {
+    --_size;
+    std::destroy_at(_data + _size);
+  }
+
+  /**
+   * @brief Removes the element at pos, shifting the following elements forward.
+   *
+   * @return An iterator to the element after the erased one.
+   */
+  constexpr iterator erase(const_iterator pos) {
+    T* slot = _data + (pos - _data);
+    for (T* it = slot; it + 1 != end(); ++it) {
+      *it = std::move(*(it + 1));
+    }
+    pop_back();
+    return slot;
+  }
+
+  /**
+   * @brief Resizes to count elements, value initializing any new elements.
+   *
+   * @throws std::length_error If count is greater than N.
+   */
+  constexpr void resize(size_t count) {
+    check_capacity(count);
+    while (_size > count) {
+      pop_back();
+    }
+    while (_size < count) {
+      emplace_back_unchecked();
+    }
+  }
+
+  /**
+   * @brief Destroys every element.
+   */
+  constexpr void clear() noexcept {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+      _size = 0;
+    } else {
+      while (_size != 0) {
+        pop_back();
+      }
+    }
+  }
+
+  friend constexpr bool operator==(const InplaceVector& a, const InplaceVector& b) {
+    if (a._size != b._size) {
+      return false;
+    }
+    for (size_t i = 0; i < a._size; ++i) {
+      if (!(a._data[i] == b._data[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  constexpr void check_index(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("InplaceVector index out of range.");
+    }
+  }
+
+  static constexpr void check_capacity(size_t count) {
+    if (count > N) {
+      throw std::length_error("InplaceVector capacity exceeded.");
+    }
+  }
+
+  union {
+    T _data[N];
+  };
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_INPLACE_VECTOR_H_
@@ -0,0 +1,401 @@
+#ifndef SIMPLECPP_IOBUF_H_
+#define SIMPLECPP_IOBUF_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/bytes.h>
+#include <SimpleCPP/deque.h>
+#include <SimpleCPP/pointer.h>
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A chain of shared byte segments that is written and read with a single writev or readv
+
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Every segment is a range of a Pointer<uint8_t[]> or of the owner of BasicBytes, e.g. a
+   BasicMappedFile, so appending or prepending BasicBytes or a buffer is O(1) and shares it without
+   copying. Copied data goes into the tailroom after the
+   last segment or the headroom before the first one when their buffer is not shared, otherwise
+   into a new segment. Copying a BasicIOBuf shares all segments. coalesce() copies the chain into a
+   single segment only when a contiguous view is needed.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicIOBuf {
+ public:
+  using buffer = Pointer<uint8_t[], alloc, dealloc>;
+  using bytes = BasicBytes<alloc, dealloc>;
+
+  /**
+   * @brief The size of the segments allocated for copied data.
+   */
+  static constexpr size_t kSegmentSize = 4096;
+
+  /**
+   * @brief The number of segments passed to a single writev call.
+   */
+  static constexpr size_t kMaxIov = 64;
+
+  /**
+   * @brief Default constructor to create an empty BasicIOBuf without allocating.
+   */
+  BasicIOBuf() noexcept : _size(0) {}
+
+  /**
+   * @brief Creates an empty BasicIOBuf with room for capacity bytes after headroom bytes, e.g. to
+   * prepend a header once the length of the body is known.
+   */
+  BasicIOBuf(size_t capacity, size_t headroom) : BasicIOBuf() {
+    _segments.push_back(Segment{buffer::for_overwrite(headroom + capacity), headroom, 0});
+  }
+
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+  size_t segment_count() const noexcept { return _segments.size(); }
+
+  /**
+   * @brief Returns the number of bytes that can be prepended without allocating.
+   */
+  size_t headroom() const noexcept {
+    return _segments.empty() ? 0 : _segments.front().headroom();
+  }
+
+  /**
+   * @brief Returns the number of bytes that can be appended without allocating.
+   */
+  size_t tailroom() const noexcept { return _segments.empty() ? 0 : _segments.back().tailroom(); }
+
+  /**
+   * @brief Appends the bytes as a segment that shares their buffer or owner.
+   */
+  BasicIOBuf& append(const bytes& data) {
+    if (!data.empty()) {
+      _segments.push_back(share(data));
+      _size += data._size;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Appends the whole buffer as a segment that shares it.
+   */
+  BasicIOBuf& append(buffer data) { return append(bytes(std::move(data))); }
+
+  /**
+   * @brief Appends the segments of other, sharing their buffers.
+   */
+  BasicIOBuf& append(const BasicIOBuf& other) {
+    if (&other == this) {
+      return append(BasicIOBuf(other));
+    }
+    for (const Segment& segment : other._segments) {
+      _segments.push_back(segment);
+    }
+    _size += other._size;
+    return *this;
+  }
+
+  /**
+   * @brief Copies count bytes to the end, filling the tailroom before allocating a segment.
+   */
+  BasicIOBuf& append(const void* data, size_t count) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const size_t in_tail = std::min(count, tailroom());
+    if (in_tail != 0) {
+      Segment& tail = _segments.back();
+      std::memcpy(tail.end(), bytes, in_tail);
+      tail.length += in_tail;
+    }
+    if (count > in_tail) {
+      const size_t rest = count - in_tail;
+      Segment segment{buffer::for_overwrite(std::max(rest, kSegmentSize)), 0, rest};
+      std::memcpy(segment.begin(), bytes + in_tail, rest);
+      _segments.push_back(std::move(segment));
+    }
+    _size += count;
+    return *this;
+  }
+
+  BasicIOBuf& append(std::string_view str) { return append(str.data(), str.size()); }
+
+  /**
+   * @brief Prepends the bytes as a segment that shares their buffer or owner.
+   */
+  BasicIOBuf& prepend(const bytes& data) {
+    if (!data.empty()) {
+      _segments.push_front(share(data));
+      _size += data._size;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Copies count bytes to the front, into the headroom if they fit or else into a new
+   * segment that leaves its unused space as headroom.
+   */
+  BasicIOBuf& prepend(const void* data, size_t count) {
+    if (count == 0) {
+      return *this;
+    }
+    if (count <= headroom()) {
+      Segment& head = _segments.front();
+      head.offset -= count;
+      head.length += count;
+      std::memcpy(head.begin(), data, count);
+    } else {
+      const size_t capacity = std::max(count, kSegmentSize);
+      Segment segment{buffer::for_overwrite(capacity), capacity - count, count};
+      std::memcpy(segment.begin(), data, count);
+      _segments.push_front(std::move(segment));
+    }
+    _size += count;
+    return *this;
+  }
+
+  BasicIOBuf& prepend(std::string_view str) { return prepend(str.data(), str.size()); }
+
+  /**
+   * @brief Removes the first count bytes, releasing the segments they covered.
+   *
+   * @throws std::out_of_range If count is greater than size().
+   */
+  void trim_front(size_t count) {
+    check_count(count);
+    _size -= count;
+    while (count != 0 || (!_segments.empty() && _segments.front().length == 0)) {
+      Segment& head = _segments.front();
+      if (head.length > count) {
+        head.offset += count;
+        head.length -= count;
+        return;
+      }
+      count -= head.length;
+      _segments.pop_front();
+    }
+  }
+
+  /**
+   * @brief Removes the first count bytes and returns them, sharing the segments they covered.
+   *
+   * @throws std::out_of_range If count is greater than size().
+   */
+  BasicIOBuf split_to(size_t count) {
+    check_count(count);
+    BasicIOBuf head{};
+    head._size = count;
+    _size -= count;
+    while (count != 0) {
+      Segment& segment = _segments.front();
+      if (segment.length > count) {
+        head._segments.push_back(Segment{segment.data, segment.offset, count, segment.owner});
+        segment.offset += count;
+        segment.length -= count;
+        break;
+      }
+      count -= segment.length;
+      head._segments.push_back(std::move(segment));
+      _segments.pop_front();
+    }
+    return head;
+  }
+
+  /**
+   * @brief Returns the contents as a single segment, copying the chain into one buffer if it has
+   * more than one segment.
+   */
+  bytes coalesce() {
+    if (_size == 0) {
+      clear();
+      return {};
+    }
+    if (_segments.size() != 1) {
+      Segment merged{buffer::for_overwrite(_size), 0, 0};
+      for (const Segment& segment : _segments) {
+        if (segment.length != 0) {
+          std::memcpy(merged.end(), segment.begin(), segment.length);
+          merged.length += segment.length;
+        }
+      }
+      _segments.clear();
+      _segments.push_back(std::move(merged));
+    }
+    return share(_segments.front());
+  }
+
+  /**
+   * @brief Calls fn with every non-empty segment in order as BasicBytes sharing its buffer or
+   * owner.
+   */
+  template <typename Fn>
+  void for_each_segment(Fn&& fn) const {
+    for (const Segment& segment : _segments) {
+      if (segment.length != 0) {
+        fn(share(segment));
+      }
+    }
+  }
+
+  void clear() noexcept {
+    _segments.clear();
+    _size = 0;
+  }
+
+  /**
+   * @brief Writes the chain to fd with writev and removes the written bytes, until the chain is
+   * empty or a non-blocking fd is full.
+   *
+   * @return The number of written bytes.
+   * @throws std::system_error If writev fails for another reason.
+   */
+  size_t write_to(int fd) {
+    size_t written = 0;
+    while (_size != 0) {
+      iovec iov[kMaxIov];
+      int count = 0;
+      for (const Segment& segment : _segments) {
+        if (count == static_cast<int>(kMaxIov)) {
+          break;
+        }
+        if (segment.length != 0) {
+          // writev does not modify the segments, it only takes a mutable pointer.
+          iov[count++] = iovec{const_cast<uint8_t*>(segment.begin()), segment.length};
+        }
+      }
+      const ssize_t result = ::writev(fd, iov, count);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          break;
+        }
+        throw std::system_error(errno, std::generic_category(), "writev");
+      }
+      trim_front(static_cast<size_t>(result));
+      written += static_cast<size_t>(result);
+    }
+    return written;
+  }
+
+  /**
+   * @brief Reads up to count bytes from fd with a single readv into the tailroom and, if that is
+   * too small, a new segment.
+   *
+   * @return The number of read bytes, which is 0 at the end of the file, or std::nullopt if a
+   * non-blocking fd has no data.
+   * @throws std::system_error If readv fails for another reason.
+   */
+  std::optional<size_t> read_from(int fd, size_t count = kSegmentSize) {
+    const size_t in_tail = std::min(count, tailroom());
+    iovec iov[2];
+    int iov_count = 0;
+    if (in_tail != 0) {
+      iov[iov_count++] = iovec{_segments.back().end(), in_tail};
+    }
+    buffer extra{};
+    if (count > in_tail) {
+      extra = buffer::for_overwrite(std::max(count - in_tail, kSegmentSize));
+      iov[iov_count++] = iovec{extra.get(), count - in_tail};
+    }
+    ssize_t result;
+    do {
+      result = ::readv(fd, iov, iov_count);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return std::nullopt;
+      }
+      throw std::system_error(errno, std::generic_category(), "readv");
+    }
+    const size_t read = static_cast<size_t>(result);
+    if (in_tail != 0) {
+      _segments.back().length += std::min(read, in_tail);
+    }
+    if (read > in_tail) {
+      _segments.push_back(Segment{std::move(extra), 0, read - in_tail});
+    }
+    _size += read;
+    return read;
+  }
+
+  friend bool operator==(const BasicIOBuf& a, std::string_view b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (const Segment& segment : a._segments) {
+      if (std::memcmp(segment.begin(), b.data(), segment.length) != 0) {
+        return false;
+      }
+      b.remove_prefix(segment.length);
+    }
+    return true;
+  }
+
+ private:
+  struct Segment {
+    // Only a writable segment is written through, and it always has a buffer.
+    uint8_t* begin() noexcept { return data.get() + offset; }
+    uint8_t* end() noexcept { return begin() + length; }
+    const uint8_t* begin() const noexcept {
+      return (data.is_valid() ? data.get() : owner.data()) + offset;
+    }
+
+    // Another owner may read the bytes around the range, so only an unshared buffer is written.
+    bool is_writable() const noexcept { return data.is_unique(); }
+    size_t headroom() const noexcept { return is_writable() ? offset : 0; }
+    size_t tailroom() const noexcept {
+      return is_writable() ? data.size() - offset - length : 0;
+    }
+
+    buffer data;
+    size_t offset;
+    size_t length;
+    // Keeps the bytes alive instead of data when they came from BasicBytes of another owner.
+    typename bytes::owner_type owner{};
+  };
+
+  static Segment share(const bytes& data) {
+    if (data._buffer.is_valid()) {
+      return Segment{data._buffer, static_cast<size_t>(data._data - data._buffer.get()),
+                     data._size};
+    }
+    return Segment{buffer{}, static_cast<size_t>(data._data - data._owner.data()), data._size,
+                   data._owner};
+  }
+
+  static bytes share(const Segment& segment) {
+    bytes result{};
+    result._buffer = segment.data;
+    result._owner = segment.owner;
+    result._data = segment.begin();
+    result._size = segment.length;
+    return result;
+  }
+
+  void check_count(size_t count) const {
+    if (count > _size) {
+      throw std::out_of_range("IOBuf count out of range.");
+    }
+  }
+
+  Deque<Segment, alloc, dealloc> _segments;
+  size_t _size;
+};
+
+using IOBuf = BasicIOBuf<>;
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_IOBUF_H_
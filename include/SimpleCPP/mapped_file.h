@@ -0,0 +1,230 @@
+#ifndef SIMPLECPP_MAPPED_FILE_H_
+#define SIMPLECPP_MAPPED_FILE_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/bytes.h>
+#include <SimpleCPP/pointer.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A read only view of a memory mapped file whose last copy unmaps it
+
+    @param alloc A custom allocator function used for the reference count, see Pointer
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note The mapping is owned by a Pointer, so copies and slices share it and munmap is called when
+   the last one is destroyed. Mapping is O(1) regardless of the file size, pages are read from the
+   page cache on first access and are shared with every other process mapping the same file. The
+   file may be closed or removed while it is mapped. The API mirrors BasicBytes, and as_bytes()
+   returns BasicBytes that share the mapping, e.g. to append a range of the file to a BasicIOBuf
+   without copying it.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicMappedFile {
+ public:
+  using iterator = const uint8_t*;
+  using const_iterator = const uint8_t*;
+
+  /**
+   * @brief Access pattern hints passed to madvise.
+   */
+  enum class Advice { kNormal, kSequential, kRandom, kWillNeed, kDontNeed, kHugePage };
+
+  /**
+   * @brief Default constructor to create an empty BasicMappedFile without allocating.
+   */
+  BasicMappedFile() noexcept : _mapping(nullptr), _data(nullptr), _size(0) {}
+
+  /**
+   * @brief Maps the whole file at path read only.
+   *
+   * @param populate Reads the whole file into the page cache up front instead of on first access.
+   * @throws std::system_error If the file cannot be opened or mapped.
+   */
+  explicit BasicMappedFile(const char* path, bool populate = false) : BasicMappedFile() {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      const int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), path);
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+      ::close(fd);
+      return;
+    }
+    const int flags = MAP_SHARED | (populate ? MAP_POPULATE : 0);
+    void* addr = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    const int error = errno;
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      throw std::system_error(error, std::generic_category(), path);
+    }
+    _mapping = Link(Mapping(addr, size));
+    _data = static_cast<const uint8_t*>(addr);
+    _size = size;
+  }
+
+  explicit BasicMappedFile(const std::string& path, bool populate = false)
+      : BasicMappedFile(path.c_str(), populate) {}
+
+  const uint8_t* data() const noexcept { return _data; }
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+
+  const_iterator begin() const noexcept { return _data; }
+  const_iterator end() const noexcept { return _data + _size; }
+
+  const uint8_t& operator[](size_t index) const noexcept { return _data[index]; }
+
+  std::string_view as_string() const noexcept {
+    return {reinterpret_cast<const char*>(_data), _size};
+  }
+
+  /**
+   * @brief Returns these bytes as BasicBytes that share the mapping instead of copying it.
+   *
+   * @note The BasicBytes hold one reference to the mapping between all their slices.
+   */
+  BasicBytes<alloc, dealloc> as_bytes() const {
+    return BasicBytes<alloc, dealloc>(_mapping, _data, _size);
+  }
+
+  /**
+   * @brief Returns the number of views sharing the mapping, or 0 if there is none.
+   */
+  size_t get_ref_count() const noexcept { return _mapping.get_ref_count(); }
+
+  /**
+   * @brief Returns the bytes in [first, last) sharing this mapping.
+   *
+   * @throws std::out_of_range If the range is not within these bytes.
+   */
+  BasicMappedFile slice(size_t first, size_t last) const {
+    if (first > last || last > _size) {
+      throw std::out_of_range("MappedFile slice out of range.");
+    }
+    BasicMappedFile result{};
+    if (first != last) {
+      result._mapping = _mapping;
+      result._data = _data + first;
+      result._size = last - first;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Removes the first count bytes and returns them, sharing this mapping.
+   *
+   * @throws std::out_of_range If count is greater than size().
+   */
+  BasicMappedFile split_to(size_t count) {
+    BasicMappedFile head = slice(0, count);
+    _data += count;
+    _size -= count;
+    return head;
+  }
+
+  /**
+   * @brief Removes the bytes from at onwards and returns them, sharing this mapping.
+   *
+   * @throws std::out_of_range If at is greater than size().
+   */
+  BasicMappedFile split_off(size_t at) {
+    BasicMappedFile tail = slice(at, _size);
+    _size = at;
+    return tail;
+  }
+
+  /**
+   * @brief Tells the kernel how the pages of this view will be accessed.
+   *
+   * @return False if the kernel does not support the advice for this mapping, e.g. kHugePage
+   * without transparent huge pages for files. The advice is only a hint either way.
+   */
+  bool advise(Advice advice) const noexcept {
+    if (_size == 0) {
+      return true;
+    }
+    int flag = MADV_NORMAL;
+    switch (advice) {
+      case Advice::kNormal:
+        flag = MADV_NORMAL;
+        break;
+      case Advice::kSequential:
+        flag = MADV_SEQUENTIAL;
+        break;
+      case Advice::kRandom:
+        flag = MADV_RANDOM;
+        break;
+      case Advice::kWillNeed:
+        flag = MADV_WILLNEED;
+        break;
+      case Advice::kDontNeed:
+        flag = MADV_DONTNEED;
+        break;
+      case Advice::kHugePage:
+#ifdef MADV_HUGEPAGE
+        flag = MADV_HUGEPAGE;
+        break;
+#else
+        return false;
+#endif
+    }
+    // madvise needs a page aligned start, so the range is widened to whole pages.
+    const uintptr_t page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const uintptr_t start = reinterpret_cast<uintptr_t>(_data) & ~(page - 1);
+    const size_t length = reinterpret_cast<uintptr_t>(_data) + _size - start;
+    return ::madvise(reinterpret_cast<void*>(start), length, flag) == 0;
+  }
+
+  friend bool operator==(const BasicMappedFile& a, std::string_view b) noexcept {
+    return a.as_string() == b;
+  }
+
+ private:
+  struct Mapping {
+    Mapping(void* addr, size_t length) noexcept : addr(addr), length(length) {}
+    Mapping(Mapping&& other) noexcept
+        : addr(std::exchange(other.addr, nullptr)), length(other.length) {}
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+    ~Mapping() noexcept {
+      if (addr != nullptr) {
+        ::munmap(addr, length);
+      }
+    }
+
+    void* addr;
+    size_t length;
+  };
+  using Link = Pointer<Mapping, alloc, dealloc>;
+
+  Link _mapping;
+  const uint8_t* _data;
+  size_t _size;
+};
+
+using MappedFile = BasicMappedFile<>;
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_MAPPED_FILE_H_
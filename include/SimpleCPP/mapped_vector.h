@@ -0,0 +1,348 @@
+#ifndef SIMPLECPP_MAPPED_VECTOR_H_
+#define SIMPLECPP_MAPPED_VECTOR_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+namespace detail {
+/**
+ * @brief A fast non cryptographic checksum of size bytes, reading four words at a time.
+ */
+inline uint64_t checksum(const void* data, size_t size, uint64_t seed = 0) noexcept {
+  constexpr uint64_t kPrime = 0x9E3779B97F4A7C15ULL;
+  const auto bytes = static_cast<const uint8_t*>(data);
+  uint64_t lanes[4] = {seed, seed + kPrime, seed - kPrime, ~seed};
+  size_t offset = 0;
+  for (; offset + 32 <= size; offset += 32) {
+    for (int i = 0; i < 4; ++i) {
+      uint64_t word;
+      std::memcpy(&word, bytes + offset + 8 * i, sizeof(word));
+      lanes[i] = std::rotl(lanes[i] ^ word, 31) * kPrime;
+    }
+  }
+  for (int i = 0; offset < size; offset += 8, ++i) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + offset, std::min<size_t>(8, size - offset));
+    lanes[i] = std::rotl(lanes[i] ^ word, 31) * kPrime;
+  }
+  uint64_t hash = size;
+  for (uint64_t lane : lanes) {
+    const __uint128_t product = static_cast<__uint128_t>(hash ^ lane) * kPrime;
+    hash = static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+  return hash;
+}
+}  // namespace detail
+
+/**
+    @brief A vector of trivially copyable elements stored in a memory mapped file, so it is
+   available again right after the process restarts
+
+    @tparam T The type of the elements
+
+    @note The file starts with a header page holding two slots, followed by the elements. sync()
+   flushes the elements, then writes the length and a checksum of the elements into the older slot
+   and flushes the header, so a crash at any point leaves at least one intact slot. Opening picks
+   the newest slot whose checksums match, which for data that is only appended to falls back to
+   the length of the previous sync() if the last one did not complete. Elements overwritten in
+   place since the last sync() make both slots fail, in which case opening throws unless
+   verification is turned off. The file grows by doubling with ftruncate and mremap, which
+   invalidates pointers and references to the elements. Changes reach the page cache right away,
+   but only sync() records the new length. The destructor does not sync, so opening and closing a
+   vector without verification is O(1), and a vector closed without sync() reopens as it was at the
+   last sync(), just like after a crash.
+*/
+template <typename T>
+class MappedVector {
+  static_assert(std::is_trivially_copyable_v<T>, "Elements must be trivially copyable.");
+
+ public:
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * @brief The size of the header in front of the elements.
+   */
+  static constexpr size_t kHeaderSize = 4096;
+
+  static_assert(alignof(T) <= kHeaderSize, "Elements aligned above a page are not supported.");
+
+  /**
+   * @brief Opens the vector stored at path, creating an empty one if the file is missing or empty.
+   *
+   * @param verify Checks the elements against the checksum, which reads the whole file.
+   * @throws std::system_error If the file cannot be opened, resized or mapped.
+   * @throws std::runtime_error If the file does not hold an intact vector of T.
+   */
+  explicit MappedVector(const char* path, bool verify = true)
+      : _fd(-1), _base(nullptr), _mapped(0), _size(0), _capacity(0), _sequence(0) {
+    _fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+    try {
+      struct stat info {};
+      if (::fstat(_fd, &info) != 0) {
+        throw std::system_error(errno, std::generic_category(), "fstat");
+      }
+      if (info.st_size == 0) {
+        initialize();
+      } else {
+        load(static_cast<size_t>(info.st_size), verify);
+      }
+    } catch (...) {
+      release();
+      throw;
+    }
+  }
+
+  explicit MappedVector(const std::string& path, bool verify = true)
+      : MappedVector(path.c_str(), verify) {}
+
+  MappedVector(const MappedVector&) = delete;
+  MappedVector& operator=(const MappedVector&) = delete;
+
+  /**
+   * @note This leaves the other MappedVector closed.
+   */
+  MappedVector(MappedVector&& other) noexcept
+      : _fd(std::exchange(other._fd, -1)),
+        _base(std::exchange(other._base, nullptr)),
+        _mapped(std::exchange(other._mapped, 0)),
+        _size(std::exchange(other._size, 0)),
+        _capacity(std::exchange(other._capacity, 0)),
+        _sequence(std::exchange(other._sequence, 0)) {}
+
+  MappedVector& operator=(MappedVector&& other) noexcept {
+    if (this != &other) {
+      release();
+      _fd = std::exchange(other._fd, -1);
+      _base = std::exchange(other._base, nullptr);
+      _mapped = std::exchange(other._mapped, 0);
+      _size = std::exchange(other._size, 0);
+      _capacity = std::exchange(other._capacity, 0);
+      _sequence = std::exchange(other._sequence, 0);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Unmaps and closes the file without syncing.
+   */
+  ~MappedVector() noexcept { release(); }
+
+  size_t size() const noexcept { return _size; }
+  size_t capacity() const noexcept { return _capacity; }
+  bool empty() const noexcept { return _size == 0; }
+
+  T* data() noexcept { return reinterpret_cast<T*>(_base + kHeaderSize); }
+  const T* data() const noexcept { return reinterpret_cast<const T*>(_base + kHeaderSize); }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + _size; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + _size; }
+
+  T& operator[](size_t index) noexcept { return data()[index]; }
+  const T& operator[](size_t index) const noexcept { return data()[index]; }
+
+  /**
+   * @throws std::out_of_range If the index is out of range.
+   */
+  T& at(size_t index) {
+    if (index >= _size) {
+      throw std::out_of_range("MappedVector index out of range.");
+    }
+    return data()[index];
+  }
+
+  const T& at(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("MappedVector index out of range.");
+    }
+    return data()[index];
+  }
+
+  T& back() noexcept { return data()[_size - 1]; }
+  const T& back() const noexcept { return data()[_size - 1]; }
+
+  /**
+   * @brief Grows the file so it holds at least count elements.
+   *
+   * @throws std::system_error If the file cannot be resized or remapped.
+   */
+  void reserve(size_t count) {
+    if (count <= _capacity) {
+      return;
+    }
+    const size_t bytes = kHeaderSize + count * sizeof(T);
+    if (::ftruncate(_fd, static_cast<off_t>(bytes)) != 0) {
+      throw std::system_error(errno, std::generic_category(), "ftruncate");
+    }
+    void* data = ::mremap(_base, _mapped, bytes, MREMAP_MAYMOVE);
+    if (data == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "mremap");
+    }
+    _base = static_cast<uint8_t*>(data);
+    _mapped = bytes;
+    _capacity = count;
+  }
+
+  void push_back(const T& value) {
+    if (_size == _capacity) {
+      grow(_size + 1);
+    }
+    data()[_size++] = value;
+  }
+
+  /**
+   * @brief Appends count elements copied from values.
+   */
+  void append(const T* values, size_t count) {
+    if (_size + count > _capacity) {
+      grow(_size + count);
+    }
+    if (count != 0) {
+      std::memcpy(static_cast<void*>(data() + _size), values, count * sizeof(T));
+    }
+    _size += count;
+  }
+
+  /**
+   * @brief Resizes to count elements, value initializing new ones.
+   */
+  void resize(size_t count) {
+    if (count > _capacity) {
+      grow(count);
+    }
+    for (size_t i = _size; i < count; ++i) {
+      new (data() + i) T();
+    }
+    _size = count;
+  }
+
+  void pop_back() noexcept { --_size; }
+  void clear() noexcept { _size = 0; }
+
+  /**
+   * @brief Makes the elements and the length durable, see the class notes.
+   *
+   * @note This reads every element to compute the checksum.
+   * @throws std::system_error If flushing the file fails.
+   */
+  void sync() {
+    const size_t bytes = _size * sizeof(T);
+    if (::msync(_base, kHeaderSize + bytes, MS_SYNC) != 0) {
+      throw std::system_error(errno, std::generic_category(), "msync");
+    }
+    Slot slot{kMagic, kVersion, sizeof(T), _sequence + 1, _size, detail::checksum(data(), bytes),
+              0};
+    slot.header_checksum = detail::checksum(&slot, offsetof(Slot, header_checksum));
+    std::memcpy(_base + ((_sequence + 1) % 2) * sizeof(Slot), &slot, sizeof(slot));
+    if (::msync(_base, kHeaderSize, MS_SYNC) != 0) {
+      throw std::system_error(errno, std::generic_category(), "msync");
+    }
+    ++_sequence;
+  }
+
+ private:
+  static constexpr uint64_t kMagic = 0x53696d706c654d56;  // "SimpleMV"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kMinCapacity = (4096 + sizeof(T) - 1) / sizeof(T);
+
+  struct Slot {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t sequence;
+    uint64_t size;
+    uint64_t data_checksum;
+    uint64_t header_checksum;
+  };
+
+  void grow(size_t count) { reserve(std::max({count, 2 * _capacity, kMinCapacity})); }
+
+  void map(size_t bytes) {
+    void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (data == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    _base = static_cast<uint8_t*>(data);
+    _mapped = bytes;
+    _capacity = (bytes - kHeaderSize) / sizeof(T);
+  }
+
+  void initialize() {
+    const size_t bytes = kHeaderSize + kMinCapacity * sizeof(T);
+    if (::ftruncate(_fd, static_cast<off_t>(bytes)) != 0) {
+      throw std::system_error(errno, std::generic_category(), "ftruncate");
+    }
+    map(bytes);
+    sync();
+  }
+
+  void load(size_t bytes, bool verify) {
+    if (bytes < kHeaderSize) {
+      throw std::runtime_error("Not a MappedVector.");
+    }
+    map(bytes);
+    const Slot* newest = nullptr;
+    for (size_t i = 0; i < 2; ++i) {
+      const Slot* slot = reinterpret_cast<const Slot*>(_base) + i;
+      if (is_intact(*slot, verify) && (newest == nullptr || slot->sequence > newest->sequence)) {
+        newest = slot;
+      }
+    }
+    if (newest == nullptr) {
+      throw std::runtime_error("No intact MappedVector header.");
+    }
+    _size = newest->size;
+    _sequence = newest->sequence;
+  }
+
+  bool is_intact(const Slot& slot, bool verify) const noexcept {
+    if (slot.magic != kMagic || slot.version != kVersion || slot.element_size != sizeof(T) ||
+        slot.header_checksum != detail::checksum(&slot, offsetof(Slot, header_checksum)) ||
+        slot.size > _capacity) {
+      return false;
+    }
+    return !verify || slot.data_checksum == detail::checksum(data(), slot.size * sizeof(T));
+  }
+
+  void release() noexcept {
+    if (_base != nullptr) {
+      ::munmap(_base, _mapped);
+      _base = nullptr;
+    }
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+  int _fd;
+  uint8_t* _base;
+  size_t _mapped;
+  size_t _size;
+  size_t _capacity;
+  uint64_t _sequence;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_MAPPED_VECTOR_H_
@@ -0,0 +1,302 @@
+#ifndef SIMPLECPP_PMAP_H_
+#define SIMPLECPP_PMAP_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/flat_hash_map.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/vector.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A persistent hash map stored as a hash array mapped trie whose versions share nodes
+
+    @tparam K The type of the keys
+    @tparam V The type of the values
+    @tparam Hash The hash function for the keys
+    @tparam Eq The equality function for the keys
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Every node covers 5 bits of the hash and stores its entries and children in arrays
+   indexed by the popcount of a bitmap, so a lookup or update touches O(log32 n) nodes. Copying a
+   PMap is O(1) and makes a snapshot. An update copies the nodes on its path that are shared with
+   another snapshot and modifies the others in place, so a batch of updates on a map that has not
+   been copied never copies a node. A single PMap object must not be modified while it is read,
+   but snapshots may be used from different threads.
+*/
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class PMap {
+  struct Node;
+  using Link = Pointer<Node, alloc, dealloc>;
+
+ public:
+  using value_type = std::pair<K, V>;
+
+  /**
+   * @brief Default constructor to create an empty PMap without allocating.
+   */
+  PMap() noexcept : _root(nullptr), _size(0) {}
+
+  PMap(std::initializer_list<value_type> entries) : PMap() {
+    for (const auto& [key, value] : entries) {
+      set(key, value);
+    }
+  }
+
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+
+  /**
+   * @brief Returns the value for key, or nullptr if key is not present.
+   */
+  const V* find(const K& key) const noexcept {
+    const uint64_t hash = hash_of(key);
+    const Node* node = _root.get();
+    for (unsigned shift = 0; node != nullptr; shift += kBits) {
+      if (shift >= 64) {
+        for (const auto& entry : node->entries) {
+          if (Eq{}(entry.first, key)) {
+            return &entry.second;
+          }
+        }
+        return nullptr;
+      }
+      const uint32_t bit = bit_for(hash, shift);
+      if (node->datamap & bit) {
+        const auto& entry = node->entries[index_of(node->datamap, bit)];
+        return Eq{}(entry.first, key) ? &entry.second : nullptr;
+      }
+      node = (node->nodemap & bit) ? node->children[index_of(node->nodemap, bit)].get() : nullptr;
+    }
+    return nullptr;
+  }
+
+  bool contains(const K& key) const noexcept { return find(key) != nullptr; }
+
+  /**
+   * @throws std::out_of_range If the key is not in the PMap.
+   */
+  const V& at(const K& key) const {
+    const V* value = find(key);
+    if (value == nullptr) {
+      throw std::out_of_range("PMap key not found.");
+    }
+    return *value;
+  }
+
+  /**
+   * @brief Inserts key and value, replacing the value if key is already present.
+   *
+   * @return True if key was inserted.
+   */
+  bool set(const K& key, V value) {
+    const uint64_t hash = hash_of(key);
+    if (!_root.is_valid()) {
+      _root = Link(Node{});
+    }
+    const bool inserted = set(_root, hash, key, value, 0);
+    _size += inserted;
+    return inserted;
+  }
+
+  /**
+   * @brief Removes the entry for key.
+   *
+   * @return False if key was not present.
+   */
+  bool erase(const K& key) {
+    if (!contains(key)) {
+      return false;
+    }
+    erase(_root, hash_of(key), key, 0);
+    if (--_size == 0) {
+      _root = Link(nullptr);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Returns a new version with key set to value, sharing all untouched nodes.
+   */
+  PMap with(const K& key, V value) const {
+    PMap result = *this;
+    result.set(key, std::move(value));
+    return result;
+  }
+
+  /**
+   * @brief Returns a new version without key, sharing all untouched nodes.
+   */
+  PMap without(const K& key) const {
+    PMap result = *this;
+    result.erase(key);
+    return result;
+  }
+
+  /**
+   * @brief Calls fn(key, value) for each entry in hash order.
+   */
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    visit(_root, fn);
+  }
+
+  void clear() noexcept {
+    _root = Link(nullptr);
+    _size = 0;
+  }
+
+ private:
+  static constexpr unsigned kBits = 5;
+
+  struct Node {
+    uint32_t datamap = 0;
+    uint32_t nodemap = 0;
+    Vector<value_type, alloc, dealloc> entries;
+    Vector<Link, alloc, dealloc> children;
+  };
+
+  static uint64_t hash_of(const K& key) noexcept { return detail::mix_hash(Hash{}(key)); }
+
+  static uint32_t bit_for(uint64_t hash, unsigned shift) noexcept {
+    return uint32_t{1} << ((hash >> shift) & 31);
+  }
+
+  static size_t index_of(uint32_t map, uint32_t bit) noexcept {
+    return std::popcount(map & (bit - 1));
+  }
+
+  // Copies node if anything but its exclusive parent refers to it.
+  static void make_exclusive(Link& node) {
+    if (!node.is_unique()) {
+      node = Link(Node(*node));
+    }
+  }
+
+  // Builds the smallest subtree below shift that holds two entries with different keys.
+  static Link make_pair_node(value_type a, uint64_t hash_a, value_type b, uint64_t hash_b,
+                             unsigned shift) {
+    Node node{};
+    if (shift >= 64) {
+      node.entries.push_back(std::move(a));
+      node.entries.push_back(std::move(b));
+      return Link(std::move(node));
+    }
+    const uint32_t bit_a = bit_for(hash_a, shift);
+    const uint32_t bit_b = bit_for(hash_b, shift);
+    if (bit_a == bit_b) {
+      node.nodemap = bit_a;
+      node.children.push_back(
+          make_pair_node(std::move(a), hash_a, std::move(b), hash_b, shift + kBits));
+    } else {
+      node.datamap = bit_a | bit_b;
+      if (bit_a > bit_b) {
+        std::swap(a, b);
+      }
+      node.entries.push_back(std::move(a));
+      node.entries.push_back(std::move(b));
+    }
+    return Link(std::move(node));
+  }
+
+  // A node is only modified in place if its parent was and nothing else refers to it, so nodes
+  // reachable from another snapshot are copied first.
+  static bool set(Link& link, uint64_t hash, const K& key, V& value, unsigned shift) {
+    make_exclusive(link);
+    Node& node = *link;
+    if (shift >= 64) {
+      for (auto& entry : node.entries) {
+        if (Eq{}(entry.first, key)) {
+          entry.second = std::move(value);
+          return false;
+        }
+      }
+      node.entries.push_back(value_type(key, std::move(value)));
+      return true;
+    }
+    const uint32_t bit = bit_for(hash, shift);
+    if (node.datamap & bit) {
+      const size_t index = index_of(node.datamap, bit);
+      value_type& entry = node.entries[index];
+      if (Eq{}(entry.first, key)) {
+        entry.second = std::move(value);
+        return false;
+      }
+      const uint64_t other_hash = hash_of(entry.first);
+      Link child = make_pair_node(std::move(entry), other_hash, value_type(key, std::move(value)),
+                                  hash, shift + kBits);
+      node.entries.erase(node.entries.begin() + index);
+      node.datamap ^= bit;
+      node.nodemap |= bit;
+      node.children.insert(node.children.begin() + index_of(node.nodemap, bit), std::move(child));
+      return true;
+    }
+    if (node.nodemap & bit) {
+      return set(node.children[index_of(node.nodemap, bit)], hash, key, value, shift + kBits);
+    }
+    node.datamap |= bit;
+    node.entries.insert(node.entries.begin() + index_of(node.datamap, bit),
+                        value_type(key, std::move(value)));
+    return true;
+  }
+
+  // Assumes key is present. Children left with a single entry are folded into their parent, so
+  // the shape of the trie only depends on its keys.
+  static void erase(Link& link, uint64_t hash, const K& key, unsigned shift) {
+    make_exclusive(link);
+    Node& node = *link;
+    if (shift >= 64) {
+      for (auto it = node.entries.begin(); it != node.entries.end(); ++it) {
+        if (Eq{}(it->first, key)) {
+          node.entries.erase(it);
+          return;
+        }
+      }
+      return;
+    }
+    const uint32_t bit = bit_for(hash, shift);
+    if (node.datamap & bit) {
+      node.entries.erase(node.entries.begin() + index_of(node.datamap, bit));
+      node.datamap ^= bit;
+      return;
+    }
+    const size_t child_index = index_of(node.nodemap, bit);
+    Link& child = node.children[child_index];
+    erase(child, hash, key, shift + kBits);
+    if (child->children.empty() && child->entries.size() == 1) {
+      value_type entry = std::move(child->entries[0]);
+      node.children.erase(node.children.begin() + child_index);
+      node.nodemap ^= bit;
+      node.datamap |= bit;
+      node.entries.insert(node.entries.begin() + index_of(node.datamap, bit), std::move(entry));
+    }
+  }
+
+  template <typename Fn>
+  static void visit(const Link& link, Fn& fn) {
+    if (!link.is_valid()) {
+      return;
+    }
+    for (const auto& [key, value] : link->entries) {
+      fn(key, value);
+    }
+    for (const auto& child : link->children) {
+      visit(child, fn);
+    }
+  }
+
+  Link _root;
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_PMAP_H_
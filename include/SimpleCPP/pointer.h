@@ -1,22 +1,19 @@
 #ifndef SIMPLECPP_POINTER_H_
 #define SIMPLECPP_POINTER_H_
 
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/ref_count.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace simplecpp {
-void* default_allocator(const size_t& size) {
-  auto data = malloc(size);
-  if (data == nullptr) {
-    throw std::bad_alloc();
-  }
-}
-
-void default_deallocator(void* ptr) noexcept { free(static_cast<void*>(ptr)); }
-
-using Allocator = void* (*)(const size_t&);
-using Deallocator = void (*)(void*) noexcept;
-
 /**
     @brief A smart pointer class that dynamically manages heap memory
 
@@ -25,6 +22,9 @@ using Deallocator = void (*)(void*) noexcept;
    data. It should throw a std::bad_alloc exception if it fails to allocate memory or at least a
    exception if not std::bad_alloc.
     @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note The reference count is atomic, so copies of a Pointer may be made and destroyed from
+   different threads. A single Pointer object must still not be assigned while it is being read.
 */
 template <typename T, Allocator alloc = default_allocator,
           Deallocator dealloc = default_deallocator>
@@ -33,18 +33,19 @@ class Pointer {
   /**
    * @brief Default constructor to create an invalid Pointer object.
    */
-  Pointer()
-      : _refs(static_cast<size_t*>(alloc(sizeof(size_t) + sizeof(T)))),
-        _data(reinterpret_cast<T*>(_refs + 1)) {
-    *_refs = 1;
-  }
+  Pointer() : _refs(allocate()), _data(nullptr) { construct(); }
 
-  explicit Pointer(const T& other)
-      : _refs(static_cast<size_t*>(alloc(sizeof(size_t) + sizeof(T)))),
-        _data(reinterpret_cast<T*>(_refs + 1)) {
-    *_refs = 1;
-    *_data = other;
-  }
+  explicit Pointer(const T& other) : _refs(allocate()), _data(nullptr) { construct(other); }
+
+  /**
+   * @brief Creates a Pointer object that owns a new T move constructed from other.
+   */
+  explicit Pointer(T&& other) : _refs(allocate()), _data(nullptr) { construct(std::move(other)); }
+
+  /**
+   * @brief Creates an invalid Pointer object without allocating.
+   */
+  explicit Pointer(std::nullptr_t) noexcept : _refs(nullptr), _data(nullptr) {}
 
   /**
    * @brief Copy constructor to create a Pointer object from another Pointer object.
@@ -53,9 +54,9 @@ class Pointer {
    *
    * @note This is a shallow copy just like with raw pointers.
    */
-  explicit Pointer(const Pointer& other) noexcept : _refs(other._refs), _data(other._data) {
+  Pointer(const Pointer& other) noexcept : _refs(other._refs), _data(other._data) {
     if (_refs != nullptr) {
-      ++(*_refs);
+      inc_ref();
     }
   }
 
@@ -66,7 +67,7 @@ class Pointer {
    *
    * @note This leaves the other Pointer object in a invalid state
    */
-  explicit Pointer(Pointer&& other) noexcept : _refs(other._refs), _data(other._data) {
+  Pointer(Pointer&& other) noexcept : _refs(other._refs), _data(other._data) {
     other._refs = nullptr;
     other._data = nullptr;
   }
@@ -91,7 +92,7 @@ class Pointer {
     dec_ref();
     _refs = other._refs;
     if (_refs != nullptr) {
-      ++(*_refs);
+      inc_ref();
       _data = other._data;
     }
 
@@ -139,7 +140,19 @@ class Pointer {
    *
    * @note If this is an invalid Pointer object, it returns 0.
    */
-  const size_t& get_ref_count() const noexcept { return (is_valid()) ? (*_refs) : 0; }
+  size_t get_ref_count() const noexcept { return (is_valid()) ? detail::ref_count(*_refs) : 0; }
+  /**
+   * @brief Checks if this is the only Pointer object sharing the data, so it may be modified in
+   * place even if other threads just dropped their copies.
+   */
+  bool is_unique() const noexcept { return is_valid() && detail::ref_is_unique(*_refs); }
+  /**
+   * @brief Returns the number of bytes allocated for the reference count and the data.
+   *
+   * @note If this is an invalid Pointer object, it returns 0. Memory owned by the data itself is
+   * not included.
+   */
+  size_t get_alloc_size() const noexcept { return (is_valid()) ? sizeof(size_t) + sizeof(T) : 0; }
   /**
    * @brief Checks if the Pointer object is valid (i.e., it points to allocated memory).
    *
@@ -159,6 +172,11 @@ class Pointer {
     }
   }
 
+  /**
+   * @brief Member access operator to access the data at the pointer's location.
+   */
+  T* operator->() const { return &**this; }
+
   /**
    * @brief Equality operator that returns true if b is a copy of a or the reverse.
    *
@@ -205,10 +223,34 @@ class Pointer {
   friend bool operator>(const Pointer& a, const T* b) noexcept { return a._data > b; }
 
  private:
+  static size_t* allocate() {
+    static_assert(alignof(T) <= alignof(size_t), "Types aligned above size_t are not supported.");
+    return static_cast<size_t*>(alloc(sizeof(size_t) + sizeof(T)));
+  }
+
+  /**
+   * @brief Constructs the data after the reference count, freeing the memory if T throws.
+   */
+  template <typename... Args>
+  void construct(Args&&... args) {
+    try {
+      _data = new (_refs + 1) T(std::forward<Args>(args)...);
+    } catch (...) {
+      dealloc(_refs);
+      throw;
+    }
+    *_refs = 1;
+  }
+
+  void inc_ref() noexcept {
+    detail::ref_acquire(*_refs);
+  }
+
   void dec_ref() noexcept {
     if (is_valid()) {
-      if (--(*_refs) == 0) {
-        free(_refs);
+      if (detail::ref_release(*_refs)) {
+        _data->~T();
+        dealloc(_refs);
       }
       _refs = nullptr;
       _data = nullptr;
@@ -218,6 +260,167 @@ class Pointer {
   size_t* _refs;
   T* _data;
 };
+
+/**
+    @brief A Pointer to an array whose length is stored in the same block as the elements
+
+    @note The block holds the reference count, then the length and then the elements, so an array
+   is a single allocation just like a Pointer to a single object.
+*/
+template <typename T, Allocator alloc, Deallocator dealloc>
+class Pointer<T[], alloc, dealloc> {
+ public:
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * @brief Default constructor to create an invalid Pointer object without allocating.
+   */
+  Pointer() noexcept : _refs(nullptr), _data(nullptr) {}
+
+  explicit Pointer(std::nullptr_t) noexcept : Pointer() {}
+
+  /**
+   * @brief Creates a Pointer object that owns count value initialized elements.
+   */
+  explicit Pointer(size_t count) : Pointer() {
+    construct(count, [](T* element) { new (element) T(); });
+  }
+
+  /**
+   * @brief Creates a Pointer object that owns count copies of value.
+   */
+  Pointer(size_t count, const T& value) : Pointer() {
+    construct(count, [&](T* element) { new (element) T(value); });
+  }
+
+  /**
+   * @brief Creates a Pointer object that owns count default initialized elements, which leaves
+   * trivial elements uninitialized for the caller to overwrite.
+   */
+  static Pointer for_overwrite(size_t count) {
+    Pointer pointer{};
+    pointer.construct(count, [](T* element) { new (element) T; });
+    return pointer;
+  }
+
+  /**
+   * @note This is a shallow copy just like with raw pointers.
+   */
+  Pointer(const Pointer& other) noexcept : _refs(other._refs), _data(other._data) {
+    if (_refs != nullptr) {
+      detail::ref_acquire(_refs[0]);
+    }
+  }
+
+  /**
+   * @note This leaves the other Pointer object in an invalid state
+   */
+  Pointer(Pointer&& other) noexcept : _refs(other._refs), _data(other._data) {
+    other._refs = nullptr;
+    other._data = nullptr;
+  }
+
+  ~Pointer() noexcept { dec_ref(); }
+
+  Pointer& operator=(const Pointer& other) noexcept {
+    Pointer copy(other);
+    std::swap(_refs, copy._refs);
+    std::swap(_data, copy._data);
+    return *this;
+  }
+
+  Pointer& operator=(Pointer&& other) noexcept {
+    Pointer moved(std::move(other));
+    std::swap(_refs, moved._refs);
+    std::swap(_data, moved._data);
+    return *this;
+  }
+
+  T* get() noexcept { return _data; }
+  const T* get() const noexcept { return _data; }
+
+  /**
+   * @brief Returns the number of elements, or 0 for an invalid Pointer object.
+   */
+  size_t size() const noexcept { return (_refs != nullptr) ? _refs[1] : 0; }
+
+  iterator begin() const noexcept { return _data; }
+  iterator end() const noexcept { return _data + size(); }
+
+  /**
+   * @brief Accesses the element at index without bounds checking.
+   */
+  T& operator[](size_t index) const noexcept { return _data[index]; }
+
+  size_t get_ref_count() const noexcept { return (is_valid()) ? detail::ref_count(_refs[0]) : 0; }
+
+  /**
+   * @brief Checks if this is the only Pointer object sharing the elements, see Pointer::is_unique.
+   */
+  bool is_unique() const noexcept { return is_valid() && detail::ref_is_unique(_refs[0]); }
+
+  /**
+   * @brief Returns the number of bytes allocated for the header and the elements.
+   */
+  size_t get_alloc_size() const noexcept {
+    return (is_valid()) ? kHeaderSize + size() * sizeof(T) : 0;
+  }
+
+  bool is_valid() const noexcept { return _refs != nullptr; }
+
+  friend bool operator==(const Pointer& a, const Pointer& b) noexcept { return a._refs == b._refs; }
+
+ private:
+  static constexpr size_t kHeaderSize = 2 * sizeof(size_t);
+
+  template <typename Fn>
+  void construct(size_t count, Fn&& init) {
+    static_assert(alignof(T) <= alignof(size_t), "Types aligned above size_t are not supported.");
+    if (count > (SIZE_MAX - kHeaderSize) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    auto refs = static_cast<size_t*>(alloc(kHeaderSize + count * sizeof(T)));
+    T* data = reinterpret_cast<T*>(refs + 2);
+    size_t built = 0;
+    try {
+      for (; built < count; ++built) {
+        init(data + built);
+      }
+    } catch (...) {
+      destroy(data, built);
+      dealloc(refs);
+      throw;
+    }
+    refs[0] = 1;
+    refs[1] = count;
+    _refs = refs;
+    _data = data;
+  }
+
+  static void destroy(T* data, size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      while (count > 0) {
+        data[--count].~T();
+      }
+    }
+  }
+
+  void dec_ref() noexcept {
+    if (_refs != nullptr && detail::ref_release(_refs[0])) {
+      destroy(_data, _refs[1]);
+      dealloc(_refs);
+    }
+    _refs = nullptr;
+    _data = nullptr;
+  }
+
+  size_t* _refs;
+  T* _data;
+};
+
+template <typename T, Allocator alloc, Deallocator dealloc>
+struct is_trivially_relocatable<Pointer<T, alloc, dealloc>> : std::true_type {};
 }  // namespace simplecpp
 
 #endif  // SIMPLECPP_POINTER_H_
\ No newline at end of file
@@ -0,0 +1,144 @@
+#ifndef SIMPLECPP_POOL_H_
+#define SIMPLECPP_POOL_H_
+
+#include <SimpleCPP/allocator.h>
+
+#include <cstddef>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A pool of fixed size blocks carved out of larger chunks
+
+    @tparam block_size The size in bytes of every block
+    @param alloc A custom allocator function used for the chunks
+    @param dealloc A custom deallocator function that frees the chunks
+    @tparam chunk_blocks The number of blocks allocated at once
+
+    @note Freed blocks are kept in a free list and reused before a new chunk is allocated, so a
+   steady state of allocations and frees never calls alloc. Chunks are only freed with the Pool.
+   Blocks are aligned to std::max_align_t. This is not thread safe.
+*/
+template <size_t block_size, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator,
+          size_t chunk_blocks = (block_size < 4096) ? 16384 / block_size : 4>
+class Pool {
+  static_assert(block_size > 0, "Blocks must not be empty.");
+  static_assert(chunk_blocks > 0, "A chunk must hold at least one block.");
+
+ public:
+  static constexpr size_t kBlockSize =
+      (block_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+      alignof(std::max_align_t);
+
+  /**
+   * @brief Default constructor to create an empty Pool without allocating.
+   */
+  Pool() noexcept
+      : _chunks(nullptr), _free(nullptr), _next(nullptr), _end(nullptr), _chunk_count(0) {}
+
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+
+  /**
+   * @note This leaves the other Pool empty, blocks allocated from it now belong to this Pool.
+   */
+  Pool(Pool&& other) noexcept : Pool() { swap(other); }
+
+  Pool& operator=(Pool&& other) noexcept {
+    if (this != &other) {
+      release();
+      swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Frees every chunk, any blocks still in use become dangling.
+   */
+  ~Pool() noexcept { release(); }
+
+  void swap(Pool& other) noexcept {
+    std::swap(_chunks, other._chunks);
+    std::swap(_free, other._free);
+    std::swap(_next, other._next);
+    std::swap(_end, other._end);
+    std::swap(_chunk_count, other._chunk_count);
+  }
+
+  /**
+   * @brief Returns an uninitialized block of kBlockSize bytes.
+   *
+   * @throws std::bad_alloc If a new chunk was needed and could not be allocated.
+   */
+  void* allocate() {
+    if (_free != nullptr) {
+      FreeBlock* block = _free;
+      _free = block->next;
+      return block;
+    }
+    if (_next == _end) {
+      add_chunk();
+    }
+    void* block = _next;
+    _next += kBlockSize;
+    return block;
+  }
+
+  /**
+   * @brief Returns block to the pool for reuse.
+   *
+   * @warning block must have been allocated by this Pool.
+   */
+  void deallocate(void* block) noexcept {
+    auto free_block = static_cast<FreeBlock*>(block);
+    free_block->next = _free;
+    _free = free_block;
+  }
+
+  /**
+   * @brief Returns the number of bytes allocated for chunks, including their headers.
+   */
+  size_t allocated_bytes() const noexcept { return _chunk_count * kChunkSize; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct alignas(std::max_align_t) ChunkHeader {
+    ChunkHeader* next;
+  };
+
+  static constexpr size_t kChunkSize = sizeof(ChunkHeader) + chunk_blocks * kBlockSize;
+
+  void add_chunk() {
+    auto chunk = static_cast<ChunkHeader*>(alloc(kChunkSize));
+    chunk->next = _chunks;
+    _chunks = chunk;
+    ++_chunk_count;
+    _next = reinterpret_cast<char*>(chunk + 1);
+    _end = _next + chunk_blocks * kBlockSize;
+  }
+
+  void release() noexcept {
+    while (_chunks != nullptr) {
+      ChunkHeader* next = _chunks->next;
+      dealloc(_chunks);
+      _chunks = next;
+    }
+    _free = nullptr;
+    _next = nullptr;
+    _end = nullptr;
+    _chunk_count = 0;
+  }
+
+  ChunkHeader* _chunks;
+  FreeBlock* _free;
+  char* _next;
+  char* _end;
+  size_t _chunk_count;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_POOL_H_
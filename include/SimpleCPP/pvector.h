@@ -0,0 +1,619 @@
+#ifndef SIMPLECPP_PVECTOR_H_
+#define SIMPLECPP_PVECTOR_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A persistent vector stored as a relaxed radix balanced tree whose versions share nodes
+
+    @tparam T The type of the elements
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Nodes have up to 32 children, so indexing and updates touch O(log32 n) nodes. The last
+   leaf is kept outside the tree as a tail, so push_back and pop_back usually only touch the tail.
+   Nodes whose children are not all full store the cumulative sizes of their children, which lets
+   append() and slice() splice trees in O(log n) instead of copying elements.
+
+   Copying a PVector is O(1) and makes a snapshot. An update copies the nodes on its path that are
+   shared with another snapshot and modifies the others in place, so building a PVector that has
+   not been copied never copies a node. A single PVector object must not be modified while it is
+   read, but snapshots may be used from different threads.
+*/
+template <typename T, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator>
+class PVector {
+  struct Node;
+  using Link = Pointer<Node, alloc, dealloc>;
+
+ public:
+  using value_type = T;
+
+  static constexpr size_t kBranch = 32;
+
+  /**
+   * @brief Default constructor to create an empty PVector without allocating.
+   */
+  PVector() noexcept : _root(nullptr), _tail(nullptr), _shift(0), _size(0) {}
+
+  PVector(std::initializer_list<T> values) : PVector() {
+    for (const T& value : values) {
+      push_back(value);
+    }
+  }
+
+  size_t size() const noexcept { return _size; }
+  bool empty() const noexcept { return _size == 0; }
+
+  /**
+   * @brief Accesses the element at index without bounds checking.
+   */
+  const T& operator[](size_t index) const noexcept {
+    const size_t tail_offset = _size - _tail->items.size();
+    if (index >= tail_offset) {
+      return _tail->items[index - tail_offset];
+    }
+    const Node* node = _root.get();
+    for (unsigned shift = _shift; shift > 0; shift -= kBits) {
+      const auto [child, sub] = locate(*node, shift, index);
+      node = node->children[child].get();
+      index = sub;
+    }
+    return node->items[index];
+  }
+
+  /**
+   * @throws std::out_of_range If index is not less than size().
+   */
+  const T& at(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("PVector index out of range.");
+    }
+    return (*this)[index];
+  }
+
+  const T& front() const noexcept { return (*this)[0]; }
+  const T& back() const noexcept { return _tail->items[_tail->items.size() - 1]; }
+
+  /**
+   * @brief Replaces the element at index.
+   *
+   * @throws std::out_of_range If index is not less than size().
+   */
+  void set(size_t index, T value) {
+    if (index >= _size) {
+      throw std::out_of_range("PVector index out of range.");
+    }
+    const size_t tail_offset = _size - _tail->items.size();
+    if (index >= tail_offset) {
+      make_exclusive(_tail);
+      _tail->items[index - tail_offset] = std::move(value);
+      return;
+    }
+    Link* link = &_root;
+    for (unsigned shift = _shift; shift > 0; shift -= kBits) {
+      make_exclusive(*link);
+      const auto [child, sub] = locate(**link, shift, index);
+      link = &(*link)->children[child];
+      index = sub;
+    }
+    make_exclusive(*link);
+    (*link)->items[index] = std::move(value);
+  }
+
+  void push_back(T value) {
+    if (!_tail.is_valid()) {
+      _tail = Link(Node{});
+    } else if (_tail->items.size() == kBranch) {
+      push_tail(std::move(_tail));
+      _tail = Link(Node{});
+    } else {
+      make_exclusive(_tail);
+    }
+    _tail->items.push_back(std::move(value));
+    ++_size;
+  }
+
+  /**
+   * @warning The PVector must not be empty.
+   */
+  void pop_back() {
+    make_exclusive(_tail);
+    _tail->items.pop_back();
+    if (--_size == 0) {
+      _tail = Link(nullptr);
+    } else if (_tail->items.empty()) {
+      _tail = pop_tail();
+    }
+  }
+
+  /**
+   * @brief Returns a new version with the element at index replaced, sharing all untouched nodes.
+   */
+  PVector with(size_t index, T value) const {
+    PVector result = *this;
+    result.set(index, std::move(value));
+    return result;
+  }
+
+  /**
+   * @brief Appends the elements of other in O(log n), sharing the nodes of both.
+   */
+  PVector& append(const PVector& other) {
+    if (other.empty()) {
+      return *this;
+    }
+    if (&other == this) {
+      const PVector copy = other;
+      return append(copy);
+    }
+    if (empty()) {
+      return *this = other;
+    }
+    if (!other._root.is_valid()) {
+      for (const T& value : other._tail->items) {
+        push_back(value);
+      }
+      return *this;
+    }
+    push_tail(std::move(_tail));
+    Link left = std::move(_root);
+    Link right = other._root;
+    unsigned shift = _shift;
+    for (; shift < other._shift; shift += kBits) {
+      left = make_internal(single(std::move(left)), shift + kBits);
+    }
+    for (unsigned right_shift = other._shift; right_shift < shift; right_shift += kBits) {
+      right = make_internal(single(std::move(right)), right_shift + kBits);
+    }
+    Vector<Link, alloc, dealloc> nodes = concat(left, right, shift);
+    if (nodes.size() == 1) {
+      _root = std::move(nodes[0]);
+      _shift = shift;
+    } else {
+      _root = make_internal(std::move(nodes), shift + kBits);
+      _shift = shift + kBits;
+    }
+    _tail = other._tail;
+    _size += other._size;
+    return *this;
+  }
+
+  friend PVector operator+(PVector a, const PVector& b) {
+    a.append(b);
+    return a;
+  }
+
+  /**
+   * @brief Returns the elements in [first, last) in O(log n), sharing the nodes of this PVector.
+   *
+   * @throws std::out_of_range If the range is not within the PVector.
+   */
+  PVector slice(size_t first, size_t last) const {
+    if (first > last || last > _size) {
+      throw std::out_of_range("PVector slice out of range.");
+    }
+    PVector result{};
+    if (first == last) {
+      return result;
+    }
+    result._size = last - first;
+    const size_t tail_offset = _size - _tail->items.size();
+    if (first >= tail_offset) {
+      result._tail = leaf(_tail->items, first - tail_offset, last - tail_offset);
+      return result;
+    }
+    Link tree = _root;
+    if (last < tail_offset) {
+      tree = take(tree, _shift, last);
+    }
+    result._root = drop(tree, _shift, first);
+    result._shift = _shift;
+    result.collapse_root();
+    if (last > tail_offset) {
+      result._tail = leaf(_tail->items, 0, last - tail_offset);
+    } else {
+      result._tail = result.pop_tail();
+    }
+    return result;
+  }
+
+  /**
+   * @brief Calls fn(value) for each element in order.
+   */
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    visit(_root, _shift, fn);
+    if (_tail.is_valid()) {
+      for (const T& value : _tail->items) {
+        fn(value);
+      }
+    }
+  }
+
+  void clear() noexcept {
+    _root = Link(nullptr);
+    _tail = Link(nullptr);
+    _shift = 0;
+    _size = 0;
+  }
+
+ private:
+  static constexpr unsigned kBits = 5;
+  // A concatenation may leave this many more nodes than the minimum on each level of its seam.
+  static constexpr size_t kExtra = 2;
+
+  // Leaves hold items, the other nodes hold children. sizes is empty if every child but the last
+  // is full, otherwise it holds the cumulative sizes of the children.
+  struct Node {
+    Vector<T, alloc, dealloc> items;
+    Vector<Link, alloc, dealloc> children;
+    Vector<size_t, alloc, dealloc> sizes;
+  };
+
+  // Copies node if anything but its exclusive parent refers to it.
+  static void make_exclusive(Link& node) {
+    if (!node.is_unique()) {
+      node = Link(Node(*node));
+    }
+  }
+
+  static Vector<Link, alloc, dealloc> single(Link node) {
+    Vector<Link, alloc, dealloc> children{};
+    children.push_back(std::move(node));
+    return children;
+  }
+
+  static Link leaf(const Vector<T, alloc, dealloc>& items, size_t first, size_t last) {
+    Node node{};
+    node.items.reserve_exact(last - first);
+    for (size_t i = first; i < last; ++i) {
+      node.items.push_back_unchecked(items[i]);
+    }
+    return Link(std::move(node));
+  }
+
+  // The number of elements below a node at the given level, where leaves are at level 0.
+  static size_t tree_size(const Node& node, unsigned shift) noexcept {
+    if (shift == 0) {
+      return node.items.size();
+    }
+    if (!node.sizes.empty()) {
+      return node.sizes[node.sizes.size() - 1];
+    }
+    return ((node.children.size() - 1) << shift) +
+           tree_size(*node.children[node.children.size() - 1], shift - kBits);
+  }
+
+  // Children of a node at level shift hold up to 1 << shift elements, so the radix index is a
+  // lower bound of the child for relaxed nodes.
+  static std::pair<size_t, size_t> locate(const Node& node, unsigned shift, size_t index) noexcept {
+    size_t child = index >> shift;
+    if (node.sizes.empty()) {
+      return {child, index - (child << shift)};
+    }
+    while (node.sizes[child] <= index) {
+      ++child;
+    }
+    return {child, (child == 0) ? index : index - node.sizes[child - 1]};
+  }
+
+  static Link make_internal(Vector<Link, alloc, dealloc> children, unsigned shift) {
+    Node node{};
+    node.children = std::move(children);
+    const size_t count = node.children.size();
+    bool strict = true;
+    for (size_t i = 0; i + 1 < count && strict; ++i) {
+      strict = tree_size(*node.children[i], shift - kBits) == (size_t{1} << shift);
+    }
+    if (!strict) {
+      node.sizes.reserve_exact(count);
+      size_t total = 0;
+      for (const Link& child : node.children) {
+        total += tree_size(*child, shift - kBits);
+        node.sizes.push_back_unchecked(total);
+      }
+    }
+    return Link(std::move(node));
+  }
+
+  // Appends child to an exclusive node at level shift, keeping its sizes up to date.
+  static void add_child(Node& node, Link child, unsigned shift) {
+    const size_t size = tree_size(*child, shift - kBits);
+    if (node.sizes.empty() && !node.children.empty() &&
+        tree_size(*node.children[node.children.size() - 1], shift - kBits) !=
+            (size_t{1} << shift)) {
+      size_t total = 0;
+      node.sizes.reserve_exact(node.children.size());
+      for (const Link& existing : node.children) {
+        total += tree_size(*existing, shift - kBits);
+        node.sizes.push_back_unchecked(total);
+      }
+    }
+    if (!node.sizes.empty()) {
+      node.sizes.push_back(node.sizes[node.sizes.size() - 1] + size);
+    }
+    node.children.push_back(std::move(child));
+  }
+
+  // Wraps a leaf in single child nodes up to level shift.
+  static Link path(Link leaf, unsigned shift) {
+    for (unsigned level = kBits; level <= shift; level += kBits) {
+      leaf = make_internal(single(std::move(leaf)), level);
+    }
+    return leaf;
+  }
+
+  // Adds leaf after the last leaf below an exclusive node, or returns false if it is full.
+  static bool push_leaf(Link& link, unsigned shift, Link& leaf) {
+    Node& node = *link;
+    if (shift > kBits) {
+      Link& last = node.children[node.children.size() - 1];
+      make_exclusive(last);
+      const size_t size = leaf->items.size();
+      if (push_leaf(last, shift - kBits, leaf)) {
+        if (!node.sizes.empty()) {
+          node.sizes[node.sizes.size() - 1] += size;
+        }
+        return true;
+      }
+    }
+    if (node.children.size() == kBranch) {
+      return false;
+    }
+    add_child(node, path(std::move(leaf), shift - kBits), shift);
+    return true;
+  }
+
+  void push_tail(Link leaf) {
+    if (!_root.is_valid()) {
+      _root = std::move(leaf);
+      _shift = 0;
+      return;
+    }
+    if (_shift > 0) {
+      make_exclusive(_root);
+      if (push_leaf(_root, _shift, leaf)) {
+        return;
+      }
+    }
+    Vector<Link, alloc, dealloc> children = single(std::move(_root));
+    children.push_back(path(std::move(leaf), _shift));
+    _root = make_internal(std::move(children), _shift + kBits);
+    _shift += kBits;
+  }
+
+  // Removes the last leaf below an exclusive node at level shift.
+  static Link pop_leaf(Link& link, unsigned shift) {
+    Node& node = *link;
+    Link& last = node.children[node.children.size() - 1];
+    Link leaf(nullptr);
+    bool emptied = true;
+    if (shift == kBits) {
+      leaf = std::move(last);
+    } else {
+      make_exclusive(last);
+      leaf = pop_leaf(last, shift - kBits);
+      emptied = last->children.empty();
+    }
+    if (emptied) {
+      node.children.pop_back();
+      if (!node.sizes.empty()) {
+        node.sizes.pop_back();
+      }
+    } else if (!node.sizes.empty()) {
+      node.sizes[node.sizes.size() - 1] -= leaf->items.size();
+    }
+    return leaf;
+  }
+
+  Link pop_tail() {
+    if (_shift == 0) {
+      return std::move(_root);
+    }
+    make_exclusive(_root);
+    Link leaf = pop_leaf(_root, _shift);
+    collapse_root();
+    return leaf;
+  }
+
+  void collapse_root() {
+    while (_shift > 0 && _root->children.size() == 1) {
+      Link child = _root->children[0];
+      _root = std::move(child);
+      _shift -= kBits;
+    }
+    if (_shift > 0 && _root->children.empty()) {
+      _root = Link(nullptr);
+      _shift = 0;
+    }
+  }
+
+  // The first count elements below node, with 0 < count.
+  static Link take(const Link& node, unsigned shift, size_t count) {
+    if (count == tree_size(*node, shift)) {
+      return node;
+    }
+    if (shift == 0) {
+      return leaf(node->items, 0, count);
+    }
+    const auto [child, sub] = locate(*node, shift, count - 1);
+    Vector<Link, alloc, dealloc> children{};
+    children.reserve_exact(child + 1);
+    for (size_t i = 0; i < child; ++i) {
+      children.push_back_unchecked(node->children[i]);
+    }
+    children.push_back_unchecked(take(node->children[child], shift - kBits, sub + 1));
+    return make_internal(std::move(children), shift);
+  }
+
+  // The elements below node after the first count, with count < size.
+  static Link drop(const Link& node, unsigned shift, size_t count) {
+    if (count == 0) {
+      return node;
+    }
+    if (shift == 0) {
+      return leaf(node->items, count, node->items.size());
+    }
+    const auto [child, sub] = locate(*node, shift, count);
+    Vector<Link, alloc, dealloc> children{};
+    children.reserve_exact(node->children.size() - child);
+    children.push_back_unchecked(drop(node->children[child], shift - kBits, sub));
+    for (size_t i = child + 1; i < node->children.size(); ++i) {
+      children.push_back_unchecked(node->children[i]);
+    }
+    return make_internal(std::move(children), shift);
+  }
+
+  static size_t slot_count(const Node& node, unsigned shift) noexcept {
+    return (shift == 0) ? node.items.size() : node.children.size();
+  }
+
+  // Concatenates two nodes at level shift into one or two nodes at the same level, repacking the
+  // nodes along the seam so that there are at most kExtra more than needed.
+  static Vector<Link, alloc, dealloc> concat(const Link& left, const Link& right, unsigned shift) {
+    if (shift == 0) {
+      if (left->items.size() + right->items.size() <= kBranch) {
+        Link merged = leaf(left->items, 0, left->items.size());
+        for (const T& value : right->items) {
+          merged->items.push_back(value);
+        }
+        return single(std::move(merged));
+      }
+      Vector<Link, alloc, dealloc> nodes = single(left);
+      nodes.push_back(right);
+      return nodes;
+    }
+    const size_t left_count = left->children.size();
+    const size_t right_count = right->children.size();
+    Vector<Link, alloc, dealloc> middle =
+        concat(left->children[left_count - 1], right->children[0], shift - kBits);
+    Vector<Link, alloc, dealloc> all{};
+    all.reserve_exact(left_count + middle.size() + right_count - 2);
+    for (size_t i = 0; i + 1 < left_count; ++i) {
+      all.push_back_unchecked(left->children[i]);
+    }
+    for (Link& node : middle) {
+      all.push_back_unchecked(std::move(node));
+    }
+    for (size_t i = 1; i < right_count; ++i) {
+      all.push_back_unchecked(right->children[i]);
+    }
+    all = rebalance(std::move(all), shift - kBits);
+    if (all.size() <= kBranch) {
+      return single(make_internal(std::move(all), shift));
+    }
+    Vector<Link, alloc, dealloc> first{};
+    Vector<Link, alloc, dealloc> second{};
+    for (size_t i = 0; i < all.size(); ++i) {
+      (i < kBranch ? first : second).push_back(std::move(all[i]));
+    }
+    Vector<Link, alloc, dealloc> nodes = single(make_internal(std::move(first), shift));
+    nodes.push_back(make_internal(std::move(second), shift));
+    return nodes;
+  }
+
+  // Merges the slots of nodes at level shift into fewer nodes until there are at most kExtra more
+  // than the minimum, leaving full nodes before the first underfull one untouched.
+  static Vector<Link, alloc, dealloc> rebalance(Vector<Link, alloc, dealloc> nodes,
+                                                unsigned shift) {
+    Vector<size_t, alloc, dealloc> plan(nodes.size());
+    size_t total = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      plan[i] = slot_count(*nodes[i], shift);
+      total += plan[i];
+    }
+    const size_t optimal = (total + kBranch - 1) / kBranch;
+    size_t count = nodes.size();
+    if (count <= optimal + kExtra) {
+      return nodes;
+    }
+    size_t i = 0;
+    while (count > optimal + kExtra) {
+      while (plan[i] >= kBranch - 1) {
+        ++i;
+      }
+      // Spread the slots of node i over the following nodes, which removes one node.
+      size_t remaining = plan[i];
+      do {
+        const size_t filled = std::min(remaining + plan[i + 1], kBranch);
+        plan[i] = filled;
+        remaining = remaining + plan[i + 1] - filled;
+        ++i;
+      } while (remaining > 0);
+      for (size_t j = i; j + 1 < count; ++j) {
+        plan[j] = plan[j + 1];
+      }
+      --count;
+      --i;
+    }
+
+    Vector<Link, alloc, dealloc> result{};
+    result.reserve_exact(count);
+    size_t source = 0;
+    size_t offset = 0;
+    for (size_t k = 0; k < count; ++k) {
+      if (offset == 0 && slot_count(*nodes[source], shift) == plan[k]) {
+        result.push_back_unchecked(std::move(nodes[source++]));
+        continue;
+      }
+      Node node{};
+      Vector<Link, alloc, dealloc> children{};
+      for (size_t filled = 0; filled < plan[k];) {
+        const Node& from = *nodes[source];
+        const size_t take = std::min(plan[k] - filled, slot_count(from, shift) - offset);
+        for (size_t s = offset; s < offset + take; ++s) {
+          if (shift == 0) {
+            node.items.push_back(from.items[s]);
+          } else {
+            children.push_back(from.children[s]);
+          }
+        }
+        filled += take;
+        offset += take;
+        if (offset == slot_count(from, shift)) {
+          ++source;
+          offset = 0;
+        }
+      }
+      result.push_back_unchecked((shift == 0) ? Link(std::move(node))
+                                              : make_internal(std::move(children), shift));
+    }
+    return result;
+  }
+
+  template <typename Fn>
+  static void visit(const Link& node, unsigned shift, Fn& fn) {
+    if (!node.is_valid()) {
+      return;
+    }
+    if (shift == 0) {
+      for (const T& value : node->items) {
+        fn(value);
+      }
+      return;
+    }
+    for (const Link& child : node->children) {
+      visit(child, shift - kBits, fn);
+    }
+  }
+
+  // The tree holds every element but the tail, which is the last leaf and is only empty if the
+  // PVector is.
+  Link _root;
+  Link _tail;
+  unsigned _shift;
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_PVECTOR_H_
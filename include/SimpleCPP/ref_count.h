@@ -0,0 +1,51 @@
+#ifndef SIMPLECPP_REF_COUNT_H_
+#define SIMPLECPP_REF_COUNT_H_
+
+#include <atomic>
+#include <type_traits>
+
+namespace simplecpp {
+namespace detail {
+/**
+ * @brief Adds a reference to an intrusive reference count.
+ *
+ * @note A new reference is always made from an existing one, so no ordering is needed.
+ */
+template <typename Count>
+inline void ref_acquire(Count& refs) noexcept {
+  static_assert(std::is_unsigned_v<Count>, "A reference count must be an unsigned integer.");
+  std::atomic_ref<Count>(refs).fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Drops a reference and returns true if it was the last one, which may then free the data.
+ *
+ * @note The last release must observe every write made through the other references.
+ */
+template <typename Count>
+inline bool ref_release(Count& refs) noexcept {
+  return std::atomic_ref<Count>(refs).fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+/**
+ * @brief Returns the number of references, which may be outdated by the time it returns.
+ */
+template <typename Count>
+inline Count ref_count(const Count& refs) noexcept {
+  return std::atomic_ref<Count>(const_cast<Count&>(refs)).load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Checks if this is the only reference, so the data may be modified in place.
+ *
+ * @note The load acquires, so the reads made through references that other threads dropped
+ * happen before the caller modifies the data.
+ */
+template <typename Count>
+inline bool ref_is_unique(const Count& refs) noexcept {
+  return std::atomic_ref<Count>(const_cast<Count&>(refs)).load(std::memory_order_acquire) == 1;
+}
+}  // namespace detail
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_REF_COUNT_H_
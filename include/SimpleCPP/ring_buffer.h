@@ -0,0 +1,229 @@
+#ifndef SIMPLECPP_RING_BUFFER_H_
+#define SIMPLECPP_RING_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A first in first out queue with a fixed capacity of N elements that are all stored
+   inline
+
+    @tparam T The type of the elements
+    @tparam N The maximum number of elements
+
+    @note This never allocates and is usable in constant expressions. The checked functions throw
+   std::length_error or std::out_of_range, the unchecked and try_ variants never throw.
+*/
+template <typename T, size_t N>
+class RingBuffer {
+  static_assert(N > 0, "A RingBuffer must be able to hold an element.");
+
+ public:
+  using value_type = T;
+
+  /**
+   * @brief Default constructor to create an empty RingBuffer.
+   */
+  constexpr RingBuffer() noexcept : _head(0), _size(0) {}
+
+  constexpr RingBuffer(const RingBuffer& other)
+    requires std::is_trivially_copy_constructible_v<T>
+  = default;
+  constexpr RingBuffer(const RingBuffer& other) : RingBuffer() {
+    for (size_t i = 0; i < other._size; ++i) {
+      push_back_unchecked(other[i]);
+    }
+  }
+
+  constexpr RingBuffer(RingBuffer&& other) noexcept
+    requires std::is_trivially_move_constructible_v<T>
+  = default;
+  /**
+   * @brief Move constructor that moves each element of other.
+   *
+   * @note The moved from elements are destroyed, leaving the other RingBuffer empty
+   */
+  constexpr RingBuffer(RingBuffer&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      : RingBuffer() {
+    for (size_t i = 0; i < other._size; ++i) {
+      push_back_unchecked(std::move(other[i]));
+    }
+    other.clear();
+  }
+
+  constexpr ~RingBuffer()
+    requires std::is_trivially_destructible_v<T>
+  = default;
+  constexpr ~RingBuffer() { clear(); }
+
+  constexpr RingBuffer& operator=(const RingBuffer& other)
+    requires std::is_trivially_copy_assignable_v<T> && std::is_trivially_destructible_v<T>
+  = default;
+  constexpr RingBuffer& operator=(const RingBuffer& other) {
+    if (this != &other) {
+      clear();
+      for (size_t i = 0; i < other._size; ++i) {
+        push_back_unchecked(other[i]);
+      }
+    }
+    return *this;
+  }
+
+  constexpr RingBuffer& operator=(RingBuffer&& other) noexcept
+    requires std::is_trivially_move_assignable_v<T> && std::is_trivially_destructible_v<T>
+  = default;
+  constexpr RingBuffer& operator=(RingBuffer&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      clear();
+      for (size_t i = 0; i < other._size; ++i) {
+        push_back_unchecked(std::move(other[i]));
+      }
+      other.clear();
+    }
+    return *this;
+  }
+
+  constexpr size_t size() const noexcept { return _size; }
+  static constexpr size_t capacity() noexcept { return N; }
+  constexpr bool empty() const noexcept { return _size == 0; }
+  constexpr bool full() const noexcept { return _size == N; }
+
+  /**
+   * @brief Accesses the element index positions after the front without bounds checking.
+   */
+  constexpr T& operator[](size_t index) noexcept { return _data[wrap(_head + index)]; }
+  constexpr const T& operator[](size_t index) const noexcept { return _data[wrap(_head + index)]; }
+
+  /**
+   * @brief Accesses the element index positions after the front.
+   *
+   * @throws std::out_of_range If index is not less than size().
+   */
+  constexpr T& at(size_t index) {
+    check_index(index);
+    return (*this)[index];
+  }
+  constexpr const T& at(size_t index) const {
+    check_index(index);
+    return (*this)[index];
+  }
+
+  /**
+   * @warning The RingBuffer must not be empty.
+   */
+  constexpr T& front() noexcept { return _data[_head]; }
+  constexpr const T& front() const noexcept { return _data[_head]; }
+  constexpr T& back() noexcept { return (*this)[_size - 1]; }
+  constexpr const T& back() const noexcept { return (*this)[_size - 1]; }
+
+  /**
+   * @throws std::length_error If the RingBuffer is full.
+   */
+  template <typename... Args>
+  constexpr T& emplace_back(Args&&... args) {
+    if (full()) {
+      throw std::length_error("RingBuffer capacity exceeded.");
+    }
+    return emplace_back_unchecked(std::forward<Args>(args)...);
+  }
+
+  constexpr void push_back(const T& value) { emplace_back(value); }
+  constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  /**
+   * @brief Constructs an element at the back without checking the capacity.
+   *
+   * @warning The caller must ensure the RingBuffer is not full.
+   */
+  template <typename... Args>
+  constexpr T& emplace_back_unchecked(Args&&... args) {
+    T* slot = std::construct_at(_data + wrap(_head + _size), std::forward<Args>(args)...);
+    ++_size;
+    return *slot;
+  }
+
+  constexpr void push_back_unchecked(const T& value) { emplace_back_unchecked(value); }
+  constexpr void push_back_unchecked(T&& value) { emplace_back_unchecked(std::move(value)); }
+
+  /**
+   * @brief Appends value if there is space.
+   *
+   * @return False if the RingBuffer was full, in which case nothing is appended.
+   */
+  constexpr bool try_push_back(const T& value) {
+    if (full()) {
+      return false;
+    }
+    emplace_back_unchecked(value);
+    return true;
+  }
+  constexpr bool try_push_back(T&& value) {
+    if (full()) {
+      return false;
+    }
+    emplace_back_unchecked(std::move(value));
+    return true;
+  }
+
+  /**
+   * @brief Destroys the front element.
+   *
+   * @warning The RingBuffer must not be empty.
+   */
+  constexpr void pop_front() noexcept {
+    std::destroy_at(_data + _head);
+    _head = wrap(_head + 1);
+    --_size;
+  }
+
+  /**
+   * @brief Moves the front element into out and destroys it.
+   *
+   * @return False if the RingBuffer was empty, in which case out is untouched.
+   */
+  constexpr bool try_pop_front(T& out) {
+    if (empty()) {
+      return false;
+    }
+    out = std::move(front());
+    pop_front();
+    return true;
+  }
+
+  /**
+   * @brief Destroys every element.
+   */
+  constexpr void clear() noexcept {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+      _size = 0;
+    } else {
+      while (_size != 0) {
+        pop_front();
+      }
+    }
+    _head = 0;
+  }
+
+ private:
+  static constexpr size_t wrap(size_t index) noexcept { return (index >= N) ? index - N : index; }
+
+  constexpr void check_index(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("RingBuffer index out of range.");
+    }
+  }
+
+  union {
+    T _data[N];
+  };
+  size_t _head;
+  size_t _size;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_RING_BUFFER_H_
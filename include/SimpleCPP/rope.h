@@ -0,0 +1,295 @@
+#ifndef SIMPLECPP_ROPE_H_
+#define SIMPLECPP_ROPE_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/shared_string.h>
+#include <SimpleCPP/string.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief An immutable string stored as a balanced tree of shared chunks for cheap edits of large
+   texts
+
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Nodes are held by Pointer and never modified once built, so copying a BasicRope is O(1)
+   and edits only rebuild the O(log n) nodes on the path to the edit, sharing everything else with
+   earlier copies. Leaves view a range of a SharedString chunk, so splitting a leaf does not copy
+   its characters. The tree is an AVL tree ordered by position, insert, erase and substr are
+   O(log n) plus the length of the inserted text.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicRope {
+  struct Node;
+  using Chunk = BasicSharedString<alloc, dealloc>;
+  using Link = Pointer<Node, alloc, dealloc>;
+
+ public:
+  /**
+   * @brief The number of characters a new leaf holds at most.
+   */
+  static constexpr size_t kChunkSize = 1024;
+
+  /**
+   * @brief Default constructor to create an empty BasicRope without allocating.
+   */
+  BasicRope() noexcept : _root(nullptr) {}
+
+  explicit BasicRope(std::string_view str) : _root(build(str)) {}
+
+  size_t size() const noexcept { return length(_root); }
+  bool empty() const noexcept { return !_root.is_valid(); }
+
+  /**
+   * @brief Returns the height of the tree, which is O(log n).
+   */
+  size_t height() const noexcept { return height(_root); }
+
+  /**
+   * @throws std::out_of_range If index is not less than size().
+   */
+  char at(size_t index) const {
+    if (index >= size()) {
+      throw std::out_of_range("Rope index out of range.");
+    }
+    return (*this)[index];
+  }
+
+  /**
+   * @brief Returns the character at index in O(log n) without bounds checking.
+   */
+  char operator[](size_t index) const noexcept {
+    const Node* node = _root.get();
+    while (!node->is_leaf()) {
+      const size_t left = length(node->left);
+      if (index < left) {
+        node = node->left.get();
+      } else {
+        index -= left;
+        node = node->right.get();
+      }
+    }
+    return node->chunk[node->offset + index];
+  }
+
+  /**
+   * @throws std::out_of_range If pos is greater than size().
+   */
+  BasicRope& insert(size_t pos, std::string_view str) { return insert(pos, BasicRope(str)); }
+
+  /**
+   * @brief Inserts the contents of other at pos, sharing its nodes.
+   *
+   * @throws std::out_of_range If pos is greater than size().
+   */
+  BasicRope& insert(size_t pos, const BasicRope& other) {
+    check_pos(pos);
+    auto [left, right] = split(_root, pos);
+    _root = join(join(left, other._root), right);
+    return *this;
+  }
+
+  BasicRope& append(std::string_view str) { return insert(size(), str); }
+  BasicRope& append(const BasicRope& other) { return insert(size(), other); }
+  BasicRope& operator+=(std::string_view str) { return append(str); }
+
+  /**
+   * @brief Removes up to count characters starting at pos.
+   *
+   * @throws std::out_of_range If pos is greater than size().
+   */
+  BasicRope& erase(size_t pos, size_t count = std::string_view::npos) {
+    check_pos(pos);
+    count = std::min(count, size() - pos);
+    auto [left, rest] = split(_root, pos);
+    auto [removed, right] = split(rest, count);
+    _root = join(left, right);
+    return *this;
+  }
+
+  /**
+   * @brief Returns up to count characters starting at pos, sharing the nodes of this BasicRope.
+   *
+   * @throws std::out_of_range If pos is greater than size().
+   */
+  BasicRope substr(size_t pos, size_t count = std::string_view::npos) const {
+    check_pos(pos);
+    count = std::min(count, size() - pos);
+    auto [left, rest] = split(_root, pos);
+    auto [middle, right] = split(rest, count);
+    BasicRope result{};
+    result._root = std::move(middle);
+    return result;
+  }
+
+  /**
+   * @brief Calls fn with the characters of every leaf in order.
+   */
+  template <typename Fn>
+  void for_each_chunk(Fn&& fn) const {
+    visit(_root, fn);
+  }
+
+  /**
+   * @brief Copies the contents into a contiguous String.
+   */
+  String to_string() const {
+    String result{};
+    result.reserve(size());
+    for_each_chunk([&](std::string_view chunk) { result.append(chunk); });
+    return result;
+  }
+
+  friend bool operator==(const BasicRope& a, std::string_view b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    bool equal = true;
+    a.for_each_chunk([&](std::string_view chunk) {
+      equal = equal && chunk == b.substr(0, chunk.size());
+      b.remove_prefix(chunk.size());
+    });
+    return equal;
+  }
+
+ private:
+  // Leaves merge with a neighbour when both fit in this many characters, so repeated small edits
+  // do not leave behind a leaf per edit.
+  static constexpr size_t kMergeSize = 256;
+
+  struct Node {
+    bool is_leaf() const noexcept { return !left.is_valid(); }
+
+    Link left;
+    Link right;
+    Chunk chunk;
+    size_t offset;
+    size_t length;
+    size_t height;
+  };
+
+  static size_t length(const Link& node) noexcept { return node.is_valid() ? node->length : 0; }
+  static size_t height(const Link& node) noexcept { return node.is_valid() ? node->height : 0; }
+
+  void check_pos(size_t pos) const {
+    if (pos > size()) {
+      throw std::out_of_range("Rope position out of range.");
+    }
+  }
+
+  static Link leaf(Chunk chunk, size_t offset, size_t length) {
+    return Link(Node{Link(nullptr), Link(nullptr), std::move(chunk), offset, length, 1});
+  }
+
+  static Link make(Link left, Link right) {
+    const size_t length = left->length + right->length;
+    const size_t height = std::max(left->height, right->height) + 1;
+    return Link(Node{std::move(left), std::move(right), Chunk(), 0, length, height});
+  }
+
+  static Link build(std::string_view str) {
+    if (str.empty()) {
+      return Link(nullptr);
+    }
+    if (str.size() <= kChunkSize) {
+      return leaf(Chunk(str), 0, str.size());
+    }
+    // Splitting at a multiple of the chunk size keeps every leaf but the last one full.
+    const size_t chunks = (str.size() + kChunkSize - 1) / kChunkSize;
+    const size_t middle = chunks / 2 * kChunkSize;
+    return make(build(str.substr(0, middle)), build(str.substr(middle)));
+  }
+
+  // Joins two balanced trees whose heights differ by at most two.
+  static Link balance(Link left, Link right) {
+    if (right->height > left->height + 1) {
+      if (height(right->left) <= height(right->right)) {
+        return make(make(std::move(left), right->left), right->right);
+      }
+      const Link& inner = right->left;
+      return make(make(std::move(left), inner->left), make(inner->right, right->right));
+    }
+    if (left->height > right->height + 1) {
+      if (height(left->right) <= height(left->left)) {
+        return make(left->left, make(left->right, std::move(right)));
+      }
+      const Link& inner = left->right;
+      return make(make(left->left, inner->left), make(inner->right, std::move(right)));
+    }
+    return make(std::move(left), std::move(right));
+  }
+
+  // Concatenates two trees in O(difference of their heights).
+  static Link join(const Link& left, const Link& right) {
+    if (!left.is_valid()) {
+      return right;
+    }
+    if (!right.is_valid()) {
+      return left;
+    }
+    if (left->is_leaf() && right->is_leaf() && left->length + right->length <= kMergeSize) {
+      char chars[kMergeSize];
+      std::memcpy(chars, left->chunk.data() + left->offset, left->length);
+      std::memcpy(chars + left->length, right->chunk.data() + right->offset, right->length);
+      const size_t length = left->length + right->length;
+      return leaf(Chunk(std::string_view(chars, length)), 0, length);
+    }
+    if (left->height > right->height + 1) {
+      return balance(left->left, join(left->right, right));
+    }
+    if (right->height > left->height + 1) {
+      return balance(join(left, right->left), right->right);
+    }
+    return make(left, right);
+  }
+
+  // Splits a tree into its first pos characters and the rest in O(log n).
+  static std::pair<Link, Link> split(const Link& node, size_t pos) {
+    if (!node.is_valid() || pos == 0) {
+      return {Link(nullptr), node};
+    }
+    if (pos == node->length) {
+      return {node, Link(nullptr)};
+    }
+    if (node->is_leaf()) {
+      return {leaf(node->chunk, node->offset, pos),
+              leaf(node->chunk, node->offset + pos, node->length - pos)};
+    }
+    const size_t left = node->left->length;
+    if (pos < left) {
+      auto [first, rest] = split(node->left, pos);
+      return {std::move(first), join(rest, node->right)};
+    }
+    auto [rest, last] = split(node->right, pos - left);
+    return {join(node->left, rest), std::move(last)};
+  }
+
+  template <typename Fn>
+  static void visit(const Link& node, Fn& fn) {
+    if (!node.is_valid()) {
+      return;
+    }
+    if (node->is_leaf()) {
+      fn(std::string_view(node->chunk.data() + node->offset, node->length));
+      return;
+    }
+    visit(node->left, fn);
+    visit(node->right, fn);
+  }
+
+  Link _root;
+};
+
+using Rope = BasicRope<>;
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_ROPE_H_
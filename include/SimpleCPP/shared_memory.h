@@ -0,0 +1,635 @@
+#ifndef SIMPLECPP_SHARED_MEMORY_H_
+#define SIMPLECPP_SHARED_MEMORY_H_
+
+#include <SimpleCPP/ref_count.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A raw pointer that stores the distance from itself to its target
+
+    @tparam T The type of the target
+
+    @note A RelativePtr and its target in the same shared memory segment stay valid when the
+   segment is mapped at a different address, e.g. in another process. Copying a RelativePtr
+   recomputes the distance, so it must not be copied with memcpy.
+*/
+template <typename T>
+class RelativePtr {
+ public:
+  RelativePtr() noexcept : _offset(kNull) {}
+  RelativePtr(std::nullptr_t) noexcept : _offset(kNull) {}
+  RelativePtr(T* target) noexcept { set(target); }
+  RelativePtr(const RelativePtr& other) noexcept { set(other.get()); }
+
+  RelativePtr& operator=(const RelativePtr& other) noexcept {
+    set(other.get());
+    return *this;
+  }
+
+  RelativePtr& operator=(T* target) noexcept {
+    set(target);
+    return *this;
+  }
+
+  T* get() const noexcept {
+    if (_offset == kNull) {
+      return nullptr;
+    }
+    return reinterpret_cast<T*>(reinterpret_cast<intptr_t>(this) + _offset);
+  }
+
+  T& operator*() const noexcept { return *get(); }
+  T* operator->() const noexcept { return get(); }
+  explicit operator bool() const noexcept { return _offset != kNull; }
+
+  friend bool operator==(const RelativePtr& a, const RelativePtr& b) noexcept {
+    return a.get() == b.get();
+  }
+
+ private:
+  // A RelativePtr never targets its own second byte, so that distance encodes nullptr.
+  static constexpr intptr_t kNull = 1;
+
+  void set(T* target) noexcept {
+    _offset = (target == nullptr)
+                  ? kNull
+                  : reinterpret_cast<intptr_t>(target) - reinterpret_cast<intptr_t>(this);
+  }
+
+  intptr_t _offset;
+};
+
+namespace detail {
+/**
+ * @brief The start of a shared memory segment, every other address in it is found from here.
+ */
+struct SegmentHeader {
+  static constexpr uint64_t kMagic = 0x53696d706c655348;  // "SimpleSH"
+  static constexpr size_t kClasses = 48;
+
+  uint64_t magic;
+  uint64_t size;
+  std::atomic<uint32_t> lock;
+  uint64_t next;
+  uint64_t root;
+  uint64_t free[kClasses];
+};
+
+/**
+ * @brief Precedes every block, so a block can be freed without knowing where its segment is mapped.
+ */
+struct alignas(16) BlockHeader {
+  uint64_t offset;
+  uint32_t size_class;
+  uint32_t magic;
+};
+
+inline constexpr uint32_t kBlockMagic = 0x426c6b21;  // "Blk!"
+
+// A spin lock, since std::mutex is not guaranteed to work across processes. The critical sections
+// are a few loads and stores, so waiting is rare.
+class SegmentLock {
+ public:
+  explicit SegmentLock(SegmentHeader* header) noexcept : _lock(header->lock) {
+    while (_lock.exchange(1, std::memory_order_acquire) != 0) {
+      while (_lock.load(std::memory_order_relaxed) != 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  ~SegmentLock() noexcept { _lock.store(0, std::memory_order_release); }
+
+  SegmentLock(const SegmentLock&) = delete;
+  SegmentLock& operator=(const SegmentLock&) = delete;
+
+ private:
+  std::atomic<uint32_t>& _lock;
+};
+
+/**
+ * @brief Allocates size bytes aligned to 16 from the segment starting at header.
+ *
+ * @throws std::bad_alloc If the segment is full.
+ */
+inline void* segment_allocate(SegmentHeader* header, size_t size) {
+  const size_t payload = std::bit_ceil(std::max<size_t>(size, 16));
+  const uint32_t size_class = static_cast<uint32_t>(std::countr_zero(payload) - 4);
+  if (size_class >= SegmentHeader::kClasses) {
+    throw std::bad_alloc();
+  }
+  auto base = reinterpret_cast<uint8_t*>(header);
+  uint64_t offset;
+  {
+    SegmentLock lock(header);
+    offset = header->free[size_class];
+    if (offset != 0) {
+      header->free[size_class] = *reinterpret_cast<uint64_t*>(base + offset + sizeof(BlockHeader));
+    } else {
+      if (header->size - header->next < sizeof(BlockHeader) + payload) {
+        throw std::bad_alloc();
+      }
+      offset = header->next;
+      header->next += sizeof(BlockHeader) + payload;
+    }
+  }
+  auto block = reinterpret_cast<BlockHeader*>(base + offset);
+  block->offset = offset;
+  block->size_class = size_class;
+  block->magic = kBlockMagic;
+  return block + 1;
+}
+
+/**
+ * @brief Returns memory from segment_allocate to the free list of its segment.
+ */
+inline void segment_deallocate(void* data) noexcept {
+  auto block = static_cast<BlockHeader*>(data) - 1;
+  auto header = reinterpret_cast<SegmentHeader*>(reinterpret_cast<uint8_t*>(block) - block->offset);
+  block->magic = 0;
+  SegmentLock lock(header);
+  *static_cast<uint64_t*>(data) = header->free[block->size_class];
+  header->free[block->size_class] = block->offset;
+}
+
+/**
+ * @brief Returns the header of the segment that data was allocated from.
+ */
+inline SegmentHeader* segment_of(const void* data) noexcept {
+  auto block = static_cast<const BlockHeader*>(data) - 1;
+  return reinterpret_cast<SegmentHeader*>(
+      const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(block) - block->offset));
+}
+}  // namespace detail
+
+/**
+    @brief A shared memory segment with a process safe allocator, that may be mapped by several
+   processes at different addresses
+
+    @note Objects in the segment must refer to each other with RelativePtr, or the types built on
+   it like SegmentPointer and SegmentVector, never with raw pointers. Blocks are rounded up to a
+   power of two and freed blocks are kept in a free list per size, protected by a spin lock in the
+   segment. A process that dies while allocating leaves the lock held. The segment is released
+   when the last mapping and file descriptor are closed and, for a named segment, after unlink().
+*/
+class SharedSegment {
+ public:
+  /**
+   * @brief Creates an anonymous segment with memfd_create, whose fd() can be inherited by child
+   * processes or sent over a Unix socket.
+   *
+   * @throws std::system_error If the segment cannot be created.
+   */
+  static SharedSegment create(size_t size) {
+    const int fd = ::memfd_create("simplecpp", MFD_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "memfd_create");
+    }
+    return initialize(fd, size);
+  }
+
+  /**
+   * @brief Creates a segment named name with shm_open, which fails if it already exists.
+   *
+   * @throws std::system_error If the segment cannot be created.
+   */
+  static SharedSegment create(const char* name, size_t size) {
+    const int fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), name);
+    }
+    return initialize(fd, size);
+  }
+
+  /**
+   * @brief Maps the segment named name that another process created.
+   *
+   * @throws std::system_error If the segment cannot be opened or is not a SharedSegment.
+   */
+  static SharedSegment open(const char* name) {
+    const int fd = ::shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), name);
+    }
+    return attach_owned(fd);
+  }
+
+  /**
+   * @brief Maps the segment behind fd, e.g. one received from another process, at a new address.
+   *
+   * @throws std::system_error If fd cannot be mapped or is not a SharedSegment.
+   */
+  static SharedSegment attach(int fd) {
+    const int copy = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (copy < 0) {
+      throw std::system_error(errno, std::generic_category(), "fcntl");
+    }
+    return attach_owned(copy);
+  }
+
+  /**
+   * @brief Removes the name of a segment, it is released once every process unmapped it.
+   */
+  static void unlink(const char* name) noexcept { ::shm_unlink(name); }
+
+  SharedSegment(const SharedSegment&) = delete;
+  SharedSegment& operator=(const SharedSegment&) = delete;
+
+  /**
+   * @note This leaves the other SharedSegment unmapped.
+   */
+  SharedSegment(SharedSegment&& other) noexcept
+      : _fd(std::exchange(other._fd, -1)), _header(std::exchange(other._header, nullptr)) {}
+
+  SharedSegment& operator=(SharedSegment&& other) noexcept {
+    if (this != &other) {
+      release();
+      _fd = std::exchange(other._fd, -1);
+      _header = std::exchange(other._header, nullptr);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Unmaps the segment, the objects in it stay alive for the other mappings.
+   */
+  ~SharedSegment() noexcept { release(); }
+
+  int fd() const noexcept { return _fd; }
+  void* base() const noexcept { return _header; }
+  size_t size() const noexcept { return _header->size; }
+
+  /**
+   * @brief Returns the number of bytes handed out so far, including freed blocks.
+   */
+  size_t used() const noexcept {
+    detail::SegmentLock lock(_header);
+    return _header->next;
+  }
+
+  /**
+   * @throws std::bad_alloc If the segment is full.
+   */
+  void* allocate(size_t size) { return detail::segment_allocate(_header, size); }
+
+  /**
+   * @brief Frees memory allocated from any mapping of any SharedSegment.
+   */
+  static void deallocate(void* data) noexcept { detail::segment_deallocate(data); }
+
+  /**
+   * @brief Creates a T in the segment, passing this segment first if T needs it.
+   */
+  template <typename T, typename... Args>
+  T* construct(Args&&... args) {
+    static_assert(alignof(T) <= 16, "Types aligned above 16 bytes are not supported.");
+    void* data = allocate(sizeof(T));
+    try {
+      if constexpr (std::is_constructible_v<T, SharedSegment&, Args...>) {
+        return new (data) T(*this, std::forward<Args>(args)...);
+      } else {
+        return new (data) T(std::forward<Args>(args)...);
+      }
+    } catch (...) {
+      deallocate(data);
+      throw;
+    }
+  }
+
+  template <typename T>
+  static void destroy(T* object) noexcept {
+    object->~T();
+    deallocate(object);
+  }
+
+  /**
+   * @brief Stores the object that other processes start from, e.g. a container.
+   */
+  void set_root(void* object) noexcept {
+    detail::SegmentLock lock(_header);
+    _header->root = (object == nullptr) ? 0 : offset_of(object);
+  }
+
+  /**
+   * @brief Returns the object stored with set_root, or nullptr.
+   */
+  template <typename T>
+  T* root() const noexcept {
+    uint64_t offset;
+    {
+      detail::SegmentLock lock(_header);
+      offset = _header->root;
+    }
+    return (offset == 0) ? nullptr : static_cast<T*>(at(offset));
+  }
+
+  /**
+   * @brief Converts an address in this mapping to an offset that is valid in every mapping.
+   */
+  uint64_t offset_of(const void* data) const noexcept {
+    return static_cast<uint64_t>(static_cast<const uint8_t*>(data) -
+                                 reinterpret_cast<const uint8_t*>(_header));
+  }
+
+  void* at(uint64_t offset) const noexcept { return reinterpret_cast<uint8_t*>(_header) + offset; }
+
+ private:
+  SharedSegment(int fd, detail::SegmentHeader* header) noexcept : _fd(fd), _header(header) {}
+
+  static detail::SegmentHeader* map(int fd, size_t size) {
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "mmap");
+    }
+    return static_cast<detail::SegmentHeader*>(data);
+  }
+
+  static SharedSegment initialize(int fd, size_t size) {
+    size = std::max(size, sizeof(detail::SegmentHeader) + sizeof(detail::BlockHeader));
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      const int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "ftruncate");
+    }
+    auto header = new (map(fd, size)) detail::SegmentHeader{};
+    header->size = size;
+    header->next = (sizeof(detail::SegmentHeader) + 15) / 16 * 16;
+    header->root = 0;
+    // Another process checks the magic number last, so it is written once the rest is ready.
+    std::atomic_ref<uint64_t>(header->magic).store(detail::SegmentHeader::kMagic,
+                                                   std::memory_order_release);
+    return SharedSegment(fd, header);
+  }
+
+  static SharedSegment attach_owned(int fd) {
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      const int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "fstat");
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    if (size < sizeof(detail::SegmentHeader)) {
+      ::close(fd);
+      throw std::system_error(EINVAL, std::generic_category(), "Not a SharedSegment");
+    }
+    auto header = map(fd, size);
+    if (std::atomic_ref<uint64_t>(header->magic).load(std::memory_order_acquire) !=
+            detail::SegmentHeader::kMagic ||
+        header->size != size) {
+      ::munmap(header, size);
+      ::close(fd);
+      throw std::system_error(EINVAL, std::generic_category(), "Not a SharedSegment");
+    }
+    return SharedSegment(fd, header);
+  }
+
+  void release() noexcept {
+    if (_header != nullptr) {
+      ::munmap(_header, _header->size);
+      _header = nullptr;
+    }
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+  int _fd;
+  detail::SegmentHeader* _header;
+};
+
+/**
+    @brief A reference counted pointer to an object in a SharedSegment that may itself live in the
+   segment
+
+    @tparam T The type of the data to be managed
+
+    @note Like Pointer, the block starts with the reference count followed by the data, but the
+   block is found with a RelativePtr and freed into the segment it came from, so copies may be
+   made and destroyed by any process that maps the segment. The count is a lock free atomic, which
+   works across processes.
+*/
+template <typename T>
+class SegmentPointer {
+ public:
+  /**
+   * @brief Default constructor to create an invalid SegmentPointer.
+   */
+  SegmentPointer() noexcept = default;
+
+  /**
+   * @brief Creates a T in segment owned by a new SegmentPointer.
+   */
+  template <typename... Args>
+  static SegmentPointer make(SharedSegment& segment, Args&&... args) {
+    static_assert(alignof(Block) <= 16, "Types aligned above 16 bytes are not supported.");
+    void* data = segment.allocate(sizeof(Block));
+    SegmentPointer result{};
+    try {
+      result._block = new (data) Block(std::forward<Args>(args)...);
+    } catch (...) {
+      SharedSegment::deallocate(data);
+      throw;
+    }
+    return result;
+  }
+
+  SegmentPointer(const SegmentPointer& other) noexcept : _block(other._block) {
+    if (_block) {
+      detail::ref_acquire(_block->refs);
+    }
+  }
+
+  SegmentPointer(SegmentPointer&& other) noexcept : _block(other._block) {
+    other._block = nullptr;
+  }
+
+  ~SegmentPointer() noexcept { release(); }
+
+  SegmentPointer& operator=(const SegmentPointer& other) noexcept {
+    SegmentPointer copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  SegmentPointer& operator=(SegmentPointer&& other) noexcept {
+    SegmentPointer moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  void swap(SegmentPointer& other) noexcept {
+    Block* block = _block.get();
+    _block = other._block;
+    other._block = block;
+  }
+
+  T* get() const noexcept { return _block ? &_block->value : nullptr; }
+  T& operator*() const noexcept { return _block->value; }
+  T* operator->() const noexcept { return &_block->value; }
+
+  /**
+   * @brief Returns the number of SegmentPointers sharing the object in every process, or 0.
+   */
+  size_t get_ref_count() const noexcept {
+    return _block ? detail::ref_count(_block->refs) : 0;
+  }
+
+  bool is_valid() const noexcept { return static_cast<bool>(_block); }
+
+  friend bool operator==(const SegmentPointer& a, const SegmentPointer& b) noexcept {
+    return a._block == b._block;
+  }
+
+ private:
+  struct Block {
+    template <typename... Args>
+    explicit Block(Args&&... args) : refs(1), value(std::forward<Args>(args)...) {}
+
+    size_t refs;
+    T value;
+  };
+
+  void release() noexcept {
+    if (_block && detail::ref_release(_block->refs)) {
+      SharedSegment::destroy(_block.get());
+    }
+    _block = nullptr;
+  }
+
+  RelativePtr<Block> _block;
+};
+
+/**
+    @brief A growable array that lives in a SharedSegment and allocates its elements from it
+
+    @tparam T The type of the elements, which must not hold raw pointers into the segment
+
+    @note The vector refers to its segment and its elements with RelativePtr, so any process that
+   maps the segment may read and grow it. Elements are moved with their move constructor, which
+   keeps RelativePtr members valid. The vector is not synchronized, processes must agree on who
+   modifies it, e.g. with a lock stored next to it.
+*/
+template <typename T>
+class SegmentVector {
+  static_assert(alignof(T) <= 16, "Types aligned above 16 bytes are not supported.");
+
+ public:
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * @brief Creates an empty vector that allocates from segment, it should be created in segment
+   * with SharedSegment::construct.
+   */
+  explicit SegmentVector(SharedSegment& segment) noexcept
+      : _segment(static_cast<detail::SegmentHeader*>(segment.base())),
+        _data(nullptr),
+        _size(0),
+        _capacity(0) {}
+
+  SegmentVector(const SegmentVector&) = delete;
+  SegmentVector& operator=(const SegmentVector&) = delete;
+
+  ~SegmentVector() noexcept {
+    clear();
+    if (_data) {
+      detail::segment_deallocate(_data.get());
+    }
+  }
+
+  size_t size() const noexcept { return _size; }
+  size_t capacity() const noexcept { return _capacity; }
+  bool empty() const noexcept { return _size == 0; }
+
+  T* data() noexcept { return _data.get(); }
+  const T* data() const noexcept { return _data.get(); }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + _size; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + _size; }
+
+  T& operator[](size_t index) noexcept { return data()[index]; }
+  const T& operator[](size_t index) const noexcept { return data()[index]; }
+
+  /**
+   * @throws std::out_of_range If the index is out of range.
+   */
+  T& at(size_t index) {
+    if (index >= _size) {
+      throw std::out_of_range("SegmentVector index out of range.");
+    }
+    return data()[index];
+  }
+
+  /**
+   * @throws std::bad_alloc If the segment is full.
+   */
+  void reserve(size_t count) {
+    if (count <= _capacity) {
+      return;
+    }
+    T* grown = static_cast<T*>(detail::segment_allocate(_segment.get(), count * sizeof(T)));
+    T* old = data();
+    for (size_t i = 0; i < _size; ++i) {
+      new (grown + i) T(std::move(old[i]));
+      old[i].~T();
+    }
+    if (old != nullptr) {
+      detail::segment_deallocate(old);
+    }
+    _data = grown;
+    _capacity = count;
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (_size == _capacity) {
+      reserve(std::max<size_t>(4, 2 * _capacity));
+    }
+    T* slot = new (data() + _size) T(std::forward<Args>(args)...);
+    ++_size;
+    return *slot;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_back() noexcept { data()[--_size].~T(); }
+
+  void clear() noexcept {
+    while (_size != 0) {
+      pop_back();
+    }
+  }
+
+ private:
+  RelativePtr<detail::SegmentHeader> _segment;
+  RelativePtr<T> _data;
+  size_t _size;
+  size_t _capacity;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_SHARED_MEMORY_H_
@@ -0,0 +1,298 @@
+#ifndef SIMPLECPP_SHARED_STRING_H_
+#define SIMPLECPP_SHARED_STRING_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/flat_hash_map.h>
+#include <SimpleCPP/ref_count.h>
+#include <SimpleCPP/vector.h>
+
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief An immutable string whose copies share a single reference counted block
+
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Like a Pointer, the block starts with the atomic reference count, followed by the hash and
+   the size and then the null terminated characters, so a string is a single allocation and a copy
+   only increments the count. The hash is computed once, so comparing strings of different
+   contents rarely reads the characters and strings sharing a block compare equal without reading
+   them. The empty string does not allocate. It does not use Pointer<char[]>, whose block has no
+   room for the hash and which holds a second pointer, while a BasicSharedString is a single
+   pointer. The block is counted with the same helpers as Pointer.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator>
+class BasicSharedString {
+ public:
+  using iterator = const char*;
+  using const_iterator = const char*;
+
+  /**
+   * @brief Default constructor to create an empty BasicSharedString without allocating.
+   */
+  BasicSharedString() noexcept : _header(nullptr) {}
+
+  explicit BasicSharedString(std::string_view str)
+      : BasicSharedString(str, std::hash<std::string_view>{}(str)) {}
+
+  /**
+   * @note This is a shallow copy that only increments the reference count.
+   */
+  BasicSharedString(const BasicSharedString& other) noexcept : _header(other._header) {
+    if (_header != nullptr) {
+      detail::ref_acquire(_header->refs);
+    }
+  }
+
+  /**
+   * @note This leaves the other BasicSharedString empty.
+   */
+  BasicSharedString(BasicSharedString&& other) noexcept : _header(other._header) {
+    other._header = nullptr;
+  }
+
+  ~BasicSharedString() noexcept { release(); }
+
+  BasicSharedString& operator=(const BasicSharedString& other) noexcept {
+    BasicSharedString copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  BasicSharedString& operator=(BasicSharedString&& other) noexcept {
+    BasicSharedString moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  void swap(BasicSharedString& other) noexcept { std::swap(_header, other._header); }
+
+  const char* data() const noexcept {
+    return (_header != nullptr) ? reinterpret_cast<const char*>(_header + 1) : "";
+  }
+  const char* c_str() const noexcept { return data(); }
+  size_t size() const noexcept { return (_header != nullptr) ? _header->size : 0; }
+  bool empty() const noexcept { return _header == nullptr; }
+
+  /**
+   * @brief Returns the precomputed std::hash of the characters.
+   */
+  size_t hash() const noexcept {
+    return (_header != nullptr) ? _header->hash : std::hash<std::string_view>{}({});
+  }
+
+  /**
+   * @brief Returns the number of strings sharing the block, or 0 for the empty string.
+   */
+  size_t get_ref_count() const noexcept {
+    return (_header != nullptr) ? detail::ref_count(_header->refs) : 0;
+  }
+
+  /**
+   * @brief Checks if a and b share a block, which interned strings do exactly when they are equal.
+   */
+  friend bool is_same(const BasicSharedString& a, const BasicSharedString& b) noexcept {
+    return a._header == b._header;
+  }
+
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + size(); }
+
+  operator std::string_view() const noexcept { return {data(), size()}; }
+
+  const char& operator[](size_t index) const noexcept { return data()[index]; }
+
+  friend bool operator==(const BasicSharedString& a, const BasicSharedString& b) noexcept {
+    if (a._header == b._header) {
+      return true;
+    }
+    return a.hash() == b.hash() &&
+           static_cast<std::string_view>(a) == static_cast<std::string_view>(b);
+  }
+  friend bool operator==(const BasicSharedString& a, std::string_view b) noexcept {
+    return static_cast<std::string_view>(a) == b;
+  }
+  friend bool operator==(const BasicSharedString& a, const char* b) noexcept {
+    return static_cast<std::string_view>(a) == std::string_view(b);
+  }
+  friend std::strong_ordering operator<=>(const BasicSharedString& a,
+                                          const BasicSharedString& b) noexcept {
+    return static_cast<std::string_view>(a) <=> static_cast<std::string_view>(b);
+  }
+
+ private:
+  template <Allocator, Deallocator, size_t>
+  friend class BasicInternTable;
+
+  struct Header {
+    size_t refs;
+    size_t hash;
+    size_t size;
+  };
+
+  BasicSharedString(std::string_view str, size_t hash) : _header(nullptr) {
+    if (str.empty()) {
+      return;
+    }
+    _header = static_cast<Header*>(alloc(sizeof(Header) + str.size() + 1));
+    _header->refs = 1;
+    _header->hash = hash;
+    _header->size = str.size();
+    char* chars = reinterpret_cast<char*>(_header + 1);
+    std::memcpy(chars, str.data(), str.size());
+    chars[str.size()] = '\0';
+  }
+
+  void release() noexcept {
+    if (_header != nullptr && detail::ref_release(_header->refs)) {
+      dealloc(_header);
+    }
+    _header = nullptr;
+  }
+
+  Header* _header;
+};
+
+using SharedString = BasicSharedString<>;
+
+template <Allocator alloc, Deallocator dealloc>
+struct is_trivially_relocatable<BasicSharedString<alloc, dealloc>> : std::true_type {};
+
+/**
+    @brief A thread safe table that returns the same BasicSharedString for equal contents
+
+    @param alloc A custom allocator function used for the table and the strings
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam shard_count The number of independently locked shards, a power of two
+
+    @note Interned strings compare with a single pointer comparison. The table keeps a reference to
+   every string, call purge() to drop the strings that nobody else holds.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator,
+          size_t shard_count = 16>
+class BasicInternTable {
+  static_assert(std::has_single_bit(shard_count), "The shard count must be a power of two.");
+
+ public:
+  using string = BasicSharedString<alloc, dealloc>;
+
+  BasicInternTable() = default;
+  BasicInternTable(const BasicInternTable&) = delete;
+  BasicInternTable& operator=(const BasicInternTable&) = delete;
+
+  /**
+   * @brief Returns the interned string equal to str, creating it if needed.
+   */
+  string intern(std::string_view str) {
+    const size_t hash = std::hash<std::string_view>{}(str);
+    Shard& shard = _shards[shard_index(hash)];
+    {
+      std::shared_lock lock(shard.mutex);
+      const auto it = shard.map.find(str);
+      if (it != shard.map.end()) {
+        return it->second;
+      }
+    }
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.map.find(str);
+    if (it == shard.map.end()) {
+      string interned(str, hash);
+      // The key views the characters of the value, which never move.
+      const std::string_view key = interned;
+      it = shard.map.insert(key, std::move(interned)).first;
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Returns an interned string equal to str, reusing its block if it is not interned yet.
+   */
+  string intern(const string& str) {
+    Shard& shard = _shards[shard_index(str.hash())];
+    std::unique_lock lock(shard.mutex);
+    return shard.map.try_emplace(str, str).first->second;
+  }
+
+  /**
+   * @brief Removes the strings that are only referenced by the table.
+   *
+   * @return The number of removed strings.
+   */
+  size_t purge() {
+    size_t removed = 0;
+    for (auto& shard : _shards) {
+      std::unique_lock lock(shard.mutex);
+      Vector<std::string_view, alloc, dealloc> unused{};
+      for (const auto& [key, value] : shard.map) {
+        if (value.get_ref_count() == 1) {
+          unused.push_back(key);
+        }
+      }
+      for (const auto key : unused) {
+        shard.map.erase(key);
+      }
+      removed += unused.size();
+    }
+    return removed;
+  }
+
+  /**
+   * @note The shards are counted one at a time, so concurrent writes may be partially counted.
+   */
+  size_t size() const {
+    size_t size = 0;
+    for (const auto& shard : _shards) {
+      std::shared_lock lock(shard.mutex);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  void clear() {
+    for (auto& shard : _shards) {
+      std::unique_lock lock(shard.mutex);
+      shard.map.clear();
+    }
+  }
+
+ private:
+  struct alignas(64) Shard {
+    mutable std::shared_mutex mutex;
+    FlatHashMap<std::string_view, string, std::hash<std::string_view>,
+                std::equal_to<std::string_view>, alloc, dealloc>
+        map;
+  };
+
+  static size_t shard_index(size_t hash) noexcept {
+    if constexpr (shard_count == 1) {
+      return 0;
+    } else {
+      return detail::mix_hash(hash) >> (64 - std::countr_zero(shard_count));
+    }
+  }
+
+  Shard _shards[shard_count];
+};
+
+using InternTable = BasicInternTable<>;
+}  // namespace simplecpp
+
+template <simplecpp::Allocator alloc, simplecpp::Deallocator dealloc>
+struct std::hash<simplecpp::BasicSharedString<alloc, dealloc>> {
+  size_t operator()(const simplecpp::BasicSharedString<alloc, dealloc>& str) const noexcept {
+    return str.hash();
+  }
+};
+
+#endif  // SIMPLECPP_SHARED_STRING_H_
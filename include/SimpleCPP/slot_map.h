@@ -0,0 +1,238 @@
+#ifndef SIMPLECPP_SLOT_MAP_H_
+#define SIMPLECPP_SLOT_MAP_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace simplecpp {
+/**
+ * @brief A 64 bit handle to an entry of a SlotMap that detects when the entry has been erased.
+ */
+class SlotHandle {
+ public:
+  /**
+   * @brief Default constructor to create a handle that never refers to an entry.
+   */
+  constexpr SlotHandle() noexcept : _index(UINT32_MAX), _generation(0) {}
+  constexpr SlotHandle(uint32_t index, uint32_t generation) noexcept
+      : _index(index), _generation(generation) {}
+
+  constexpr uint32_t index() const noexcept { return _index; }
+  constexpr uint32_t generation() const noexcept { return _generation; }
+
+  /**
+   * @brief Packs the handle into 64 bits, e.g. to store it in a C API or a hash map.
+   */
+  constexpr uint64_t to_bits() const noexcept {
+    return (static_cast<uint64_t>(_generation) << 32) | _index;
+  }
+  static constexpr SlotHandle from_bits(uint64_t bits) noexcept {
+    return {static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32)};
+  }
+
+  friend constexpr bool operator==(const SlotHandle&, const SlotHandle&) noexcept = default;
+
+ private:
+  uint32_t _index;
+  uint32_t _generation;
+};
+
+/**
+    @brief A container that stores its values densely and refers to them with generational handles
+
+    @tparam T The type of the values
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note Insert, erase and lookup are O(1). Erasing moves the last value into the gap, so values
+   are always contiguous for iteration but references to them are invalidated by erase and insert.
+   Handles stay valid until their entry is erased, after which lookups with them fail.
+*/
+template <typename T, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator>
+class SlotMap {
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using pointer = Pointer<T, alloc, dealloc>;
+
+  /**
+   * @brief Default constructor to create an empty SlotMap without allocating.
+   */
+  SlotMap() noexcept : _free(kNone) {}
+
+  size_t size() const noexcept { return _values.size(); }
+  bool empty() const noexcept { return _values.empty(); }
+
+  void reserve(size_t count) {
+    _values.reserve(count);
+    _value_slots.reserve(count);
+    _slots.reserve(count);
+  }
+
+  /**
+   * @brief Iterates over the values in storage order, which changes when values are erased.
+   */
+  iterator begin() noexcept { return _values.begin(); }
+  iterator end() noexcept { return _values.end(); }
+  const_iterator begin() const noexcept { return _values.begin(); }
+  const_iterator end() const noexcept { return _values.end(); }
+
+  /**
+   * @brief Returns the handle of the value at position in storage order.
+   */
+  SlotHandle handle_at(size_t position) const noexcept {
+    const uint32_t slot = _value_slots[position];
+    return {slot, _slots[slot].generation};
+  }
+
+  template <typename... Args>
+  SlotHandle emplace(Args&&... args) {
+    uint32_t slot = _free;
+    if (slot == kNone) {
+      if (_slots.size() == kNone) {
+        throw std::length_error("SlotMap has no free slots.");
+      }
+      slot = static_cast<uint32_t>(_slots.size());
+      _slots.push_back({kNone, 0});
+    } else {
+      _free = _slots[slot].position;
+    }
+    try {
+      _value_slots.push_back(slot);
+      try {
+        _values.emplace_back(std::forward<Args>(args)...);
+      } catch (...) {
+        _value_slots.pop_back();
+        throw;
+      }
+    } catch (...) {
+      _slots[slot].position = _free;
+      _free = slot;
+      throw;
+    }
+    _slots[slot].position = static_cast<uint32_t>(_values.size() - 1);
+    return {slot, _slots[slot].generation};
+  }
+
+  SlotHandle insert(const T& value) { return emplace(value); }
+  SlotHandle insert(T&& value) { return emplace(std::move(value)); }
+
+  bool contains(SlotHandle handle) const noexcept { return is_live(handle); }
+
+  /**
+   * @brief Returns the value for handle, or nullptr if it was erased.
+   */
+  T* get(SlotHandle handle) noexcept {
+    return is_live(handle) ? &_values[_slots[handle.index()].position] : nullptr;
+  }
+  const T* get(SlotHandle handle) const noexcept {
+    return is_live(handle) ? &_values[_slots[handle.index()].position] : nullptr;
+  }
+
+  /**
+   * @brief Accesses the value for handle without checking that it is still live.
+   */
+  T& operator[](SlotHandle handle) noexcept { return _values[_slots[handle.index()].position]; }
+  const T& operator[](SlotHandle handle) const noexcept {
+    return _values[_slots[handle.index()].position];
+  }
+
+  /**
+   * @throws std::out_of_range If the entry for handle was erased.
+   */
+  T& at(SlotHandle handle) {
+    T* value = get(handle);
+    if (value == nullptr) {
+      throw std::out_of_range("SlotMap handle is stale.");
+    }
+    return *value;
+  }
+  const T& at(SlotHandle handle) const { return const_cast<SlotMap*>(this)->at(handle); }
+
+  /**
+   * @brief Removes the entry for handle.
+   *
+   * @return False if the entry was already erased.
+   */
+  bool erase(SlotHandle handle) noexcept {
+    if (!is_live(handle)) {
+      return false;
+    }
+    Slot& slot = _slots[handle.index()];
+    const uint32_t position = slot.position;
+    const uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+    if (position != last) {
+      _values[position] = std::move(_values[last]);
+      _value_slots[position] = _value_slots[last];
+      _slots[_value_slots[position]].position = position;
+    }
+    _values.pop_back();
+    _value_slots.pop_back();
+
+    // A slot whose generation would wrap around is retired so old handles can never match again.
+    if (++slot.generation != 0) {
+      slot.position = _free;
+      _free = handle.index();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Moves the value for handle into a new Pointer for shared ownership and erases it.
+   *
+   * @return The new Pointer, or an invalid Pointer if the entry was already erased.
+   */
+  pointer extract(SlotHandle handle) {
+    T* value = get(handle);
+    if (value == nullptr) {
+      return pointer(nullptr);
+    }
+    pointer shared(std::move(*value));
+    erase(handle);
+    return shared;
+  }
+
+  /**
+   * @brief Removes every entry, invalidating every handle.
+   */
+  void clear() noexcept {
+    // Erasing from the back never moves a value.
+    while (!_values.empty()) {
+      erase(handle_at(_values.size() - 1));
+    }
+  }
+
+ private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  struct Slot {
+    // The position of the value if the slot is live, otherwise the next free slot.
+    uint32_t position;
+    uint32_t generation;
+  };
+
+  bool is_live(SlotHandle handle) const noexcept {
+    if (handle.index() >= _slots.size()) {
+      return false;
+    }
+    const Slot& slot = _slots[handle.index()];
+    return slot.generation == handle.generation() && slot.position < _values.size() &&
+           _value_slots[slot.position] == handle.index();
+  }
+
+  Vector<T, alloc, dealloc> _values;
+  Vector<uint32_t, alloc, dealloc> _value_slots;
+  Vector<Slot, alloc, dealloc> _slots;
+  uint32_t _free;
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_SLOT_MAP_H_
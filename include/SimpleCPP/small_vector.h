@@ -0,0 +1,407 @@
+#ifndef SIMPLECPP_SMALL_VECTOR_H_
+#define SIMPLECPP_SMALL_VECTOR_H_
+
+#include <SimpleCPP/allocator.h>
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A Vector that stores up to N elements inline before allocating
+
+    @tparam T The type of the elements
+    @tparam N The number of elements stored without allocating
+    @param alloc A custom allocator function used once the inline storage is exceeded
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam GrowthFactor A std::ratio greater than one that the capacity is multiplied by when the
+   SmallVector runs out of space.
+
+    @note This has the same interface as Vector, except that the inline capacity is never freed.
+*/
+template <typename T, size_t N, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator, typename GrowthFactor = std::ratio<3, 2>>
+class SmallVector {
+  static_assert(N > 0, "Use Vector if no inline storage is wanted.");
+  static_assert(GrowthFactor::num > GrowthFactor::den, "The growth factor must be above one.");
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over aligned types are not supported.");
+
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * @brief Default constructor to create an empty SmallVector using the inline storage.
+   */
+  SmallVector() noexcept : _data(inline_data()), _size(0), _capacity(N) {}
+
+  /**
+   * @brief Creates a SmallVector of count value initialized elements.
+   */
+  explicit SmallVector(size_t count) : SmallVector() { resize(count); }
+
+  /**
+   * @brief Creates a SmallVector of count copies of value.
+   */
+  SmallVector(size_t count, const T& value) : SmallVector() { resize(count, value); }
+
+  SmallVector(std::initializer_list<T> values) : SmallVector() {
+    reserve_exact(values.size());
+    for (const auto& value : values) {
+      emplace_back_unchecked(value);
+    }
+  }
+
+  SmallVector(const SmallVector& other) : SmallVector() {
+    reserve_exact(other._size);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      copy_bytes(_data, other._data, other._size);
+      _size = other._size;
+    } else {
+      for (; _size < other._size; ++_size) {
+        new (_data + _size) T(other._data[_size]);
+      }
+    }
+  }
+
+  /**
+   * @brief Move constructor that takes the heap buffer of other or relocates its inline elements.
+   *
+   * @note This leaves the other SmallVector empty
+   */
+  SmallVector(SmallVector&& other) noexcept : SmallVector() { take(other); }
+
+  ~SmallVector() noexcept {
+    clear();
+    release();
+  }
+
+  SmallVector& operator=(const SmallVector& other) {
+    if (this != &other) {
+      SmallVector copy(other);
+      clear();
+      take(copy);
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& other) noexcept {
+    if (this != &other) {
+      clear();
+      take(other);
+    }
+    return *this;
+  }
+
+  T* data() noexcept { return _data; }
+  const T* data() const noexcept { return _data; }
+  size_t size() const noexcept { return _size; }
+  size_t capacity() const noexcept { return _capacity; }
+  bool empty() const noexcept { return _size == 0; }
+
+  /**
+   * @brief Checks if the elements are stored inline, i.e. nothing is allocated.
+   */
+  bool is_inline() const noexcept { return _data == inline_data(); }
+
+  iterator begin() noexcept { return _data; }
+  iterator end() noexcept { return _data + _size; }
+  const_iterator begin() const noexcept { return _data; }
+  const_iterator end() const noexcept { return _data + _size; }
+
+  /**
+   * @brief Accesses the element at index without bounds checking.
+   */
+  T& operator[](size_t index) noexcept { return _data[index]; }
+  const T& operator[](size_t index) const noexcept { return _data[index]; }
+
+  /**
+   * @brief Accesses the element at index.
+   *
+   * @throws std::out_of_range If index is not less than size().
+   */
+  T& at(size_t index) {
+    check_index(index);
+    return _data[index];
+  }
+  const T& at(size_t index) const {
+    check_index(index);
+    return _data[index];
+  }
+
+  T& front() noexcept { return _data[0]; }
+  const T& front() const noexcept { return _data[0]; }
+  T& back() noexcept { return _data[_size - 1]; }
+  const T& back() const noexcept { return _data[_size - 1]; }
+
+  /**
+   * @brief Ensures the capacity is at least count, growing by the growth factor if it must grow.
+   */
+  void reserve(size_t count) {
+    if (count > _capacity) {
+      grow_to(next_capacity(count));
+    }
+  }
+
+  /**
+   * @brief Ensures the capacity is at least count, allocating exactly count elements if it must
+   * grow.
+   */
+  void reserve_exact(size_t count) {
+    if (count > _capacity) {
+      grow_to(count);
+    }
+  }
+
+  /**
+   * @brief Moves the elements back inline if they fit, otherwise shrinks the heap buffer to size().
+   */
+  void shrink_to_fit() {
+    if (is_inline() || _size == _capacity) {
+      return;
+    }
+    if (_size <= N) {
+      T* heap = _data;
+      relocate(inline_data(), heap, _size);
+      dealloc(heap);
+      _data = inline_data();
+      _capacity = N;
+    } else {
+      grow_to(_size);
+    }
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (_size == _capacity) {
+      // The arguments may refer to an element of this SmallVector so they are consumed first.
+      T value(std::forward<Args>(args)...);
+      grow_to(next_capacity(_size + 1));
+      return emplace_back_unchecked(std::move(value));
+    }
+    return emplace_back_unchecked(std::forward<Args>(args)...);
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  /**
+   * @brief Constructs an element at the end without checking the capacity.
+   *
+   * @warning The caller must ensure size() < capacity().
+   */
+  template <typename... Args>
+  T& emplace_back_unchecked(Args&&... args) {
+    T* slot = new (_data + _size) T(std::forward<Args>(args)...);
+    ++_size;
+    return *slot;
+  }
+
+  /**
+   * @brief Appends value without checking the capacity.
+   *
+   * @warning The caller must ensure size() < capacity().
+   */
+  void push_back_unchecked(const T& value) { emplace_back_unchecked(value); }
+  void push_back_unchecked(T&& value) { emplace_back_unchecked(std::move(value)); }
+
+  /**
+   * @brief Destroys the last element.
+   *
+   * @warning The SmallVector must not be empty.
+   */
+  void pop_back() noexcept {
+    --_size;
+    _data[_size].~T();
+  }
+
+  /**
+   * @brief Inserts value before pos, shifting the following elements back.
+   *
+   * @return An iterator to the inserted element.
+   */
+  iterator insert(const_iterator pos, T value) {
+    const size_t index = pos - _data;
+    reserve(_size + 1);
+    T* slot = _data + index;
+    if constexpr (is_trivially_relocatable_v<T>) {
+      std::memmove(static_cast<void*>(slot + 1), static_cast<const void*>(slot),
+                   (_size - index) * sizeof(T));
+    } else {
+      for (T* it = _data + _size; it != slot; --it) {
+        new (it) T(std::move(*(it - 1)));
+        (it - 1)->~T();
+      }
+    }
+    new (slot) T(std::move(value));
+    ++_size;
+    return slot;
+  }
+
+  /**
+   * @brief Removes the element at pos, shifting the following elements forward.
+   *
+   * @return An iterator to the element after the erased one.
+   */
+  iterator erase(const_iterator pos) noexcept {
+    T* slot = _data + (pos - _data);
+    slot->~T();
+    if constexpr (is_trivially_relocatable_v<T>) {
+      std::memmove(static_cast<void*>(slot), static_cast<const void*>(slot + 1),
+                   (end() - slot - 1) * sizeof(T));
+    } else {
+      for (T* it = slot; it + 1 != end(); ++it) {
+        new (it) T(std::move(*(it + 1)));
+        (it + 1)->~T();
+      }
+    }
+    --_size;
+    return slot;
+  }
+
+  /**
+   * @brief Resizes to count elements, value initializing any new elements.
+   */
+  void resize(size_t count) {
+    if (count < _size) {
+      truncate(count);
+      return;
+    }
+    reserve_exact(count);
+    for (; _size < count; ++_size) {
+      new (_data + _size) T();
+    }
+  }
+
+  void resize(size_t count, const T& value) {
+    if (count < _size) {
+      truncate(count);
+      return;
+    }
+    reserve_exact(count);
+    for (; _size < count; ++_size) {
+      new (_data + _size) T(value);
+    }
+  }
+
+  /**
+   * @brief Destroys every element but keeps the capacity.
+   */
+  void clear() noexcept { truncate(0); }
+
+  friend bool operator==(const SmallVector& a, const SmallVector& b) {
+    if (a._size != b._size) {
+      return false;
+    }
+    for (size_t i = 0; i < a._size; ++i) {
+      if (!(a._data[i] == b._data[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  T* inline_data() noexcept { return reinterpret_cast<T*>(_inline); }
+  const T* inline_data() const noexcept { return reinterpret_cast<const T*>(_inline); }
+
+  void check_index(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("SmallVector index out of range.");
+    }
+  }
+
+  size_t next_capacity(size_t count) const noexcept {
+    const size_t grown = _capacity * GrowthFactor::num / GrowthFactor::den;
+    if (grown > count) {
+      return grown;
+    }
+    return (count > _capacity + 1) ? count : _capacity + 1;
+  }
+
+  static void copy_bytes(T* dest, const T* src, size_t count) noexcept {
+    if (count != 0) {
+      std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+    }
+  }
+
+  /**
+   * @brief Moves count elements from src to uninitialized dest and ends their lifetime in src.
+   */
+  static void relocate(T* dest, T* src, size_t count) noexcept {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      copy_bytes(dest, src, count);
+    } else {
+      static_assert(std::is_nothrow_move_constructible_v<T>,
+                    "SmallVector elements must be trivially relocatable or nothrow movable.");
+      for (size_t i = 0; i < count; ++i) {
+        new (dest + i) T(std::move(src[i]));
+        src[i].~T();
+      }
+    }
+  }
+
+  void grow_to(size_t capacity) {
+    if constexpr (is_trivially_relocatable_v<T> && is_reallocatable<alloc, dealloc>) {
+      if (!is_inline()) {
+        _data = static_cast<T*>(default_reallocator(_data, capacity * sizeof(T)));
+        _capacity = capacity;
+        return;
+      }
+    }
+    T* data = static_cast<T*>(alloc(capacity * sizeof(T)));
+    relocate(data, _data, _size);
+    release();
+    _data = data;
+    _capacity = capacity;
+  }
+
+  /**
+   * @brief Takes the elements of other, whose elements must already be destroyed or moved.
+   */
+  void take(SmallVector& other) noexcept {
+    release();
+    if (other.is_inline()) {
+      relocate(_data, other._data, other._size);
+    } else {
+      _data = other._data;
+      _capacity = other._capacity;
+      other._data = other.inline_data();
+      other._capacity = N;
+    }
+    _size = other._size;
+    other._size = 0;
+  }
+
+  void truncate(size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_t i = count; i < _size; ++i) {
+        _data[i].~T();
+      }
+    }
+    _size = count;
+  }
+
+  void release() noexcept {
+    if (!is_inline()) {
+      dealloc(_data);
+    }
+    _data = inline_data();
+    _capacity = N;
+  }
+
+  T* _data;
+  size_t _size;
+  size_t _capacity;
+  alignas(T) unsigned char _inline[N * sizeof(T)];
+};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_SMALL_VECTOR_H_
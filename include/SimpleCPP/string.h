@@ -0,0 +1,357 @@
+#ifndef SIMPLECPP_STRING_H_
+#define SIMPLECPP_STRING_H_
+
+#include <SimpleCPP/allocator.h>
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A null terminated string that stores short contents inline and longer ones on the heap
+
+    @tparam inline_size The number of characters stored without allocating. The default of 23 keeps
+   the object at 24 bytes.
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+
+    @note The last byte of the object holds inline_size - size() for inline contents, so it doubles
+   as the null terminator of a full inline string, and 0xFF for heap contents. The heap layout
+   stores the pointer, the size and a 56 bit capacity in the leading bytes. The object never
+   stores its own address, so it is trivially relocatable and cheap to hold in a Pointer.
+*/
+template <size_t inline_size = 23, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator>
+class BasicString {
+  static_assert(inline_size >= 2 * sizeof(size_t) + 7,
+                "The inline buffer must be able to hold the heap layout.");
+  static_assert(inline_size < 255, "The inline size must fit in the tag byte.");
+
+ public:
+  using value_type = char;
+  using iterator = char*;
+  using const_iterator = const char*;
+
+  static constexpr size_t kInlineSize = inline_size;
+
+  /**
+   * @brief Default constructor to create an empty BasicString without allocating.
+   */
+  BasicString() noexcept { set_inline_size(0); }
+
+  explicit BasicString(std::string_view str) : BasicString() {
+    reserve(str.size());
+    append(str);
+  }
+  BasicString(const char* str) : BasicString(std::string_view(str)) {}
+  BasicString(size_t count, char c) : BasicString() { resize(count, c); }
+
+  BasicString(const BasicString& other) : BasicString(static_cast<std::string_view>(other)) {}
+
+  /**
+   * @note This leaves the other BasicString empty.
+   */
+  BasicString(BasicString&& other) noexcept {
+    std::memcpy(_bytes, other._bytes, sizeof(_bytes));
+    other.set_inline_size(0);
+  }
+
+  ~BasicString() noexcept { release(); }
+
+  BasicString& operator=(const BasicString& other) {
+    if (this != &other) {
+      assign(other);
+    }
+    return *this;
+  }
+
+  BasicString& operator=(BasicString&& other) noexcept {
+    if (this != &other) {
+      release();
+      std::memcpy(_bytes, other._bytes, sizeof(_bytes));
+      other.set_inline_size(0);
+    }
+    return *this;
+  }
+
+  BasicString& operator=(std::string_view str) { return assign(str); }
+
+  /**
+   * @brief Replaces the contents with str, which may refer to this BasicString.
+   */
+  BasicString& assign(std::string_view str) {
+    if (str.size() > capacity()) {
+      BasicString copy(str);
+      swap(copy);
+    } else {
+      std::memmove(data(), str.data(), str.size());
+      set_size(str.size());
+    }
+    return *this;
+  }
+
+  void swap(BasicString& other) noexcept {
+    unsigned char bytes[sizeof(_bytes)];
+    std::memcpy(bytes, _bytes, sizeof(_bytes));
+    std::memcpy(_bytes, other._bytes, sizeof(_bytes));
+    std::memcpy(other._bytes, bytes, sizeof(_bytes));
+  }
+
+  /**
+   * @brief Checks if the characters are stored in the object itself.
+   */
+  bool is_inline() const noexcept { return tag() != kHeapTag; }
+
+  char* data() noexcept { return is_inline() ? reinterpret_cast<char*>(_bytes) : heap_data(); }
+  const char* data() const noexcept {
+    return is_inline() ? reinterpret_cast<const char*>(_bytes) : heap_data();
+  }
+  const char* c_str() const noexcept { return data(); }
+  size_t size() const noexcept { return is_inline() ? inline_size - tag() : heap_size(); }
+  size_t capacity() const noexcept { return is_inline() ? inline_size : heap_capacity(); }
+  bool empty() const noexcept { return size() == 0; }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + size(); }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + size(); }
+
+  operator std::string_view() const noexcept { return {data(), size()}; }
+
+  /**
+   * @brief Accesses the character at index without bounds checking.
+   */
+  char& operator[](size_t index) noexcept { return data()[index]; }
+  const char& operator[](size_t index) const noexcept { return data()[index]; }
+
+  /**
+   * @throws std::out_of_range If index is not less than size().
+   */
+  char& at(size_t index) {
+    if (index >= size()) {
+      throw std::out_of_range("String index out of range.");
+    }
+    return data()[index];
+  }
+  const char& at(size_t index) const { return const_cast<BasicString*>(this)->at(index); }
+
+  char& front() noexcept { return data()[0]; }
+  const char& front() const noexcept { return data()[0]; }
+  char& back() noexcept { return data()[size() - 1]; }
+  const char& back() const noexcept { return data()[size() - 1]; }
+
+  /**
+   * @brief Ensures the capacity is at least count characters, excluding the null terminator.
+   */
+  void reserve(size_t count) {
+    if (count > capacity()) {
+      grow_to(count);
+    }
+  }
+
+  void push_back(char c) {
+    const size_t old_size = size();
+    if (old_size == capacity()) {
+      grow_to(next_capacity(old_size + 1));
+    }
+    data()[old_size] = c;
+    set_size(old_size + 1);
+  }
+
+  /**
+   * @warning The BasicString must not be empty.
+   */
+  void pop_back() noexcept { set_size(size() - 1); }
+
+  /**
+   * @brief Appends str, which may refer to this BasicString.
+   */
+  BasicString& append(std::string_view str) {
+    const size_t old_size = size();
+    if (old_size + str.size() > capacity()) {
+      const char* old_data = data();
+      const bool aliased = std::less_equal<>{}(old_data, str.data()) &&
+                           std::less<>{}(str.data(), old_data + old_size);
+      const size_t offset = aliased ? str.data() - old_data : 0;
+      grow_to(next_capacity(old_size + str.size()));
+      if (aliased) {
+        str = std::string_view(data() + offset, str.size());
+      }
+    }
+    std::memmove(data() + old_size, str.data(), str.size());
+    set_size(old_size + str.size());
+    return *this;
+  }
+
+  BasicString& operator+=(std::string_view str) { return append(str); }
+  BasicString& operator+=(char c) {
+    push_back(c);
+    return *this;
+  }
+
+  /**
+   * @brief Resizes to count characters, filling new ones with c.
+   */
+  void resize(size_t count, char c = '\0') {
+    const size_t old_size = size();
+    if (count > old_size) {
+      reserve(count);
+      std::memset(data() + old_size, c, count - old_size);
+    }
+    set_size(count);
+  }
+
+  /**
+   * @brief Empties the BasicString, keeping its capacity.
+   */
+  void clear() noexcept { set_size(0); }
+
+  /**
+   * @brief Moves the contents back inline if they fit, otherwise shrinks the heap buffer.
+   */
+  void shrink_to_fit() {
+    if (!is_inline() && heap_size() < heap_capacity()) {
+      BasicString copy(static_cast<std::string_view>(*this));
+      swap(copy);
+    }
+  }
+
+  BasicString substr(size_t pos, size_t count = std::string_view::npos) const {
+    return BasicString(static_cast<std::string_view>(*this).substr(pos, count));
+  }
+
+  friend BasicString operator+(const BasicString& a, std::string_view b) {
+    BasicString result{};
+    result.reserve(a.size() + b.size());
+    result.append(a).append(b);
+    return result;
+  }
+
+  friend bool operator==(const BasicString& a, const BasicString& b) noexcept {
+    return static_cast<std::string_view>(a) == static_cast<std::string_view>(b);
+  }
+  friend bool operator==(const BasicString& a, std::string_view b) noexcept {
+    return static_cast<std::string_view>(a) == b;
+  }
+  friend bool operator==(const BasicString& a, const char* b) noexcept {
+    return static_cast<std::string_view>(a) == std::string_view(b);
+  }
+  friend std::strong_ordering operator<=>(const BasicString& a, const BasicString& b) noexcept {
+    return static_cast<std::string_view>(a) <=> static_cast<std::string_view>(b);
+  }
+  friend std::strong_ordering operator<=>(const BasicString& a, std::string_view b) noexcept {
+    return static_cast<std::string_view>(a) <=> b;
+  }
+
+ private:
+  static constexpr unsigned char kHeapTag = 0xFF;
+  static constexpr size_t kSizeOffset = sizeof(char*);
+  static constexpr size_t kCapacityOffset = kSizeOffset + sizeof(size_t);
+  static constexpr size_t kCapacityBytes = 7;
+
+  unsigned char tag() const noexcept { return _bytes[inline_size]; }
+
+  char* heap_data() const noexcept {
+    char* heap;
+    std::memcpy(&heap, _bytes, sizeof(heap));
+    return heap;
+  }
+
+  size_t heap_size() const noexcept {
+    size_t size;
+    std::memcpy(&size, _bytes + kSizeOffset, sizeof(size));
+    return size;
+  }
+
+  // The capacity is spelled out byte by byte so it never overlaps the tag, whatever the
+  // endianness. On little endian targets the first seven bytes of a word are those bytes.
+  size_t heap_capacity() const noexcept {
+    if constexpr (std::endian::native == std::endian::little) {
+      size_t word;
+      std::memcpy(&word, _bytes + kCapacityOffset, sizeof(word));
+      return word & ((size_t{1} << (8 * kCapacityBytes)) - 1);
+    }
+    size_t capacity = 0;
+    for (size_t i = 0; i < kCapacityBytes; ++i) {
+      capacity |= static_cast<size_t>(_bytes[kCapacityOffset + i]) << (8 * i);
+    }
+    return capacity;
+  }
+
+  void set_heap(char* heap, size_t size, size_t capacity) noexcept {
+    std::memcpy(_bytes, &heap, sizeof(heap));
+    std::memcpy(_bytes + kSizeOffset, &size, sizeof(size));
+    for (size_t i = 0; i < kCapacityBytes; ++i) {
+      _bytes[kCapacityOffset + i] = static_cast<unsigned char>(capacity >> (8 * i));
+    }
+    _bytes[inline_size] = kHeapTag;
+  }
+
+  void set_inline_size(size_t size) noexcept {
+    _bytes[size] = '\0';
+    _bytes[inline_size] = static_cast<unsigned char>(inline_size - size);
+  }
+
+  void set_size(size_t size) noexcept {
+    if (is_inline()) {
+      set_inline_size(size);
+    } else {
+      std::memcpy(_bytes + kSizeOffset, &size, sizeof(size));
+      heap_data()[size] = '\0';
+    }
+  }
+
+  size_t next_capacity(size_t count) const noexcept {
+    const size_t grown = capacity() * 2;
+    return (grown > count) ? grown : count;
+  }
+
+  void grow_to(size_t capacity) {
+    if (capacity >= (size_t{1} << (8 * kCapacityBytes))) {
+      throw std::length_error("String capacity is too large.");
+    }
+    const size_t size = this->size();
+    char* heap;
+    if constexpr (is_reallocatable<alloc, dealloc>) {
+      if (!is_inline()) {
+        heap = static_cast<char*>(default_reallocator(heap_data(), capacity + 1));
+        set_heap(heap, size, capacity);
+        return;
+      }
+    }
+    heap = static_cast<char*>(alloc(capacity + 1));
+    std::memcpy(heap, data(), size + 1);
+    release();
+    set_heap(heap, size, capacity);
+  }
+
+  void release() noexcept {
+    if (!is_inline()) {
+      dealloc(heap_data());
+    }
+  }
+
+  alignas(char*) unsigned char _bytes[inline_size + 1];
+};
+
+using String = BasicString<>;
+
+template <size_t inline_size, Allocator alloc, Deallocator dealloc>
+struct is_trivially_relocatable<BasicString<inline_size, alloc, dealloc>> : std::true_type {};
+}  // namespace simplecpp
+
+template <size_t inline_size, simplecpp::Allocator alloc, simplecpp::Deallocator dealloc>
+struct std::hash<simplecpp::BasicString<inline_size, alloc, dealloc>> {
+  size_t operator()(const simplecpp::BasicString<inline_size, alloc, dealloc>& str) const noexcept {
+    return std::hash<std::string_view>{}(str);
+  }
+};
+
+#endif  // SIMPLECPP_STRING_H_
@@ -0,0 +1,598 @@
+#ifndef SIMPLECPP_THREAD_POOL_H_
+#define SIMPLECPP_THREAD_POOL_H_
+
+#include <SimpleCPP/allocator.h>
+#include <SimpleCPP/deque.h>
+#include <SimpleCPP/futex.h>
+#include <SimpleCPP/pool.h>
+#include <SimpleCPP/vector.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+namespace detail {
+/**
+ * @brief Tells the CPU that this is a spin loop, which saves power and frees the core for the
+ * other hyperthread.
+ */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+/**
+    @brief A Chase-Lev work stealing deque of pointers
+
+    @note The owning thread pushes and pops at the bottom without locking, any other thread steals
+   from the top with a single compare and swap, so the owner works on its newest tasks while
+   thieves take the oldest, which tend to be the largest. The ring grows by doubling and retired
+   rings are only freed with the deque, since a thief may still read them. Based on "Correct and
+   Efficient Work-Stealing for Weak Memory Models" by Le et al.
+*/
+template <typename T, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator>
+class WorkStealingDeque {
+  static_assert(std::is_pointer_v<T>, "The deque holds pointers, nullptr means empty.");
+
+ public:
+  explicit WorkStealingDeque(size_t capacity = 256)
+      : _top(0), _bottom(0), _array(make_array(std::bit_ceil(std::max<size_t>(capacity, 2)))) {}
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  ~WorkStealingDeque() noexcept {
+    Array* array = _array.load(std::memory_order_relaxed);
+    while (array != nullptr) {
+      Array* previous = array->previous;
+      dealloc(array);
+      array = previous;
+    }
+  }
+
+  /**
+   * @brief Adds value at the bottom, only the owner may call this.
+   */
+  void push(T value) {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    const int64_t top = _top.load(std::memory_order_acquire);
+    Array* array = _array.load(std::memory_order_relaxed);
+    if (bottom - top >= static_cast<int64_t>(array->capacity)) {
+      array = grow(array, top, bottom);
+    }
+    array->at(bottom).store(value, std::memory_order_relaxed);
+    // Publishes the value, and whatever it points to, to thieves that read the new bottom.
+    _bottom.store(bottom + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Takes the newest value, or nullptr if empty, only the owner may call this.
+   */
+  T pop() noexcept {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    Array* array = _array.load(std::memory_order_relaxed);
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      _bottom.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T value = array->at(bottom).load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // The last value may be stolen at the same time, the compare and swap picks one winner.
+      if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        value = nullptr;
+      }
+      _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  /**
+   * @brief Takes the oldest value, or nullptr if empty or another thread won the race for it.
+   */
+  T steal() noexcept {
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    Array* array = _array.load(std::memory_order_acquire);
+    T value = array->at(top).load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return value;
+  }
+
+  /**
+   * @brief Checks if the deque looked empty, which may be outdated by the time it returns.
+   */
+  bool empty() const noexcept {
+    return _top.load(std::memory_order_relaxed) >= _bottom.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Array {
+    size_t capacity;
+    Array* previous;
+
+    std::atomic<T>& at(int64_t index) noexcept {
+      return reinterpret_cast<std::atomic<T>*>(this + 1)[static_cast<size_t>(index) &
+                                                         (capacity - 1)];
+    }
+  };
+
+  static Array* make_array(size_t capacity, Array* previous = nullptr) {
+    auto array = static_cast<Array*>(alloc(sizeof(Array) + capacity * sizeof(std::atomic<T>)));
+    array->capacity = capacity;
+    array->previous = previous;
+    for (size_t i = 0; i < capacity; ++i) {
+      new (&array->at(static_cast<int64_t>(i))) std::atomic<T>(nullptr);
+    }
+    return array;
+  }
+
+  Array* grow(Array* array, int64_t top, int64_t bottom) {
+    Array* grown = make_array(2 * array->capacity, array);
+    for (int64_t i = top; i < bottom; ++i) {
+      grown->at(i).store(array->at(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    _array.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  alignas(64) std::atomic<int64_t> _top;
+  alignas(64) std::atomic<int64_t> _bottom;
+  std::atomic<Array*> _array;
+};
+}  // namespace detail
+
+/**
+    @brief A work stealing thread pool for many small tasks
+
+    @param alloc A custom allocator function used for the tasks, the deques and the workers
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam inline_size The number of bytes a callable may take to be stored in its task
+
+    @note Every worker owns a Chase-Lev deque. Tasks submitted from a worker go to the bottom of its
+   own deque, tasks submitted from other threads go to a global queue behind a mutex. An idle
+   worker pops its own deque, then takes from the global queue, then steals from the top of the
+   other deques. Tasks are blocks of a Pool owned by the submitting worker, callables up to
+   inline_size bytes are stored in the block and larger ones are allocated with alloc, so unlike
+   std::function a steady stream of small tasks does not allocate. A task run by another worker is
+   handed back to its Pool through a lock free list. A worker without work spins for a while and
+   then parks on a futex. Submitting wakes a parked worker only if no worker is already searching
+   for tasks, and a worker takes a batch of the global queue at once. An exception escaping a task
+   submitted with submit() calls std::terminate, use a Group to propagate it. The destructor runs
+   every submitted task before joining the workers.
+*/
+template <Allocator alloc = default_allocator, Deallocator dealloc = default_deallocator,
+          size_t inline_size = 48>
+class BasicThreadPool {
+  struct Task;
+  struct Worker;
+
+ public:
+  /**
+   * @brief Tracks a set of tasks so they can be waited for, for fork join parallelism.
+   *
+   * @note A worker that waits runs other tasks in the meantime, so tasks may wait for the tasks
+   * they start without blocking a thread. Other threads block on a futex. The destructor waits
+   * too, but drops the exception.
+   */
+  class Group {
+   public:
+    explicit Group(BasicThreadPool& pool) noexcept : _pool(pool), _state(0), _failed(false) {}
+
+    Group(const Group&) = delete;
+    Group& operator=(const Group&) = delete;
+
+    ~Group() noexcept { join(); }
+
+    /**
+     * @brief Submits fn to the pool as part of this group.
+     */
+    template <typename Fn>
+    void run(Fn&& fn) {
+      _state.fetch_add(1, std::memory_order_relaxed);
+      try {
+        _pool.submit([this, fn = std::forward<Fn>(fn)]() mutable {
+          try {
+            fn();
+          } catch (...) {
+            if (!_failed.exchange(true, std::memory_order_relaxed)) {
+              _error = std::current_exception();
+            }
+          }
+          finish();
+        });
+      } catch (...) {
+        finish();
+        throw;
+      }
+    }
+
+    /**
+     * @brief Waits until every task of the group has run.
+     *
+     * @throws The first exception thrown by one of the tasks.
+     */
+    void wait() {
+      join();
+      if (_failed.exchange(false, std::memory_order_relaxed)) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+      }
+    }
+
+   private:
+    // The low bits count the tasks that did not finish, the top bit marks a blocked waiter.
+    static constexpr uint32_t kWaiting = 0x80000000;
+
+    void join() noexcept {
+      if (Worker* worker = _pool.current()) {
+        uint32_t idle = 0;
+        while ((_state.load(std::memory_order_acquire) & ~kWaiting) != 0) {
+          if (Task* task = _pool.find_task(worker)) {
+            _pool.execute(task, worker);
+            idle = 0;
+          } else if (++idle % 64 == 0) {
+            std::this_thread::yield();
+          } else {
+            detail::cpu_relax();
+          }
+        }
+        return;
+      }
+      _state.fetch_or(kWaiting, std::memory_order_relaxed);
+      while (true) {
+        const uint32_t state = _state.load(std::memory_order_acquire);
+        if ((state & ~kWaiting) == 0) {
+          break;
+        }
+        detail::futex_wait(_state, state);
+      }
+      _state.fetch_and(~kWaiting, std::memory_order_relaxed);
+    }
+
+    void finish() noexcept {
+      // The group may be destroyed as soon as the count reaches 0, so only the value returned by
+      // the decrement is used. A wake up of an address that was freed is harmless.
+      if (_state.fetch_sub(1, std::memory_order_acq_rel) == (kWaiting | 1)) {
+        detail::futex_wake(_state);
+      }
+    }
+
+    BasicThreadPool& _pool;
+    std::atomic<uint32_t> _state;
+    std::atomic<bool> _failed;
+    std::exception_ptr _error;
+  };
+
+  /**
+   * @brief Starts threads workers, at least one.
+   */
+  explicit BasicThreadPool(size_t threads = std::thread::hardware_concurrency())
+      : _injected_count(0), _epoch(0), _sleepers(0), _searching(0), _waking(false), _stop(false) {
+    threads = std::max<size_t>(threads, 1);
+    _workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      // alloc only aligns to std::max_align_t, so the block is padded to align the worker.
+      void* block = alloc(sizeof(Worker) + alignof(Worker));
+      auto address = reinterpret_cast<uintptr_t>(block);
+      auto worker = new (reinterpret_cast<void*>((address + alignof(Worker) - 1) /
+                                                 alignof(Worker) * alignof(Worker))) Worker();
+      worker->block = block;
+      worker->index = static_cast<uint32_t>(i);
+      worker->seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+      _workers.push_back(worker);
+    }
+    for (Worker* worker : _workers) {
+      worker->thread = std::thread([this, worker] { work(worker); });
+    }
+  }
+
+  BasicThreadPool(const BasicThreadPool&) = delete;
+  BasicThreadPool& operator=(const BasicThreadPool&) = delete;
+
+  /**
+   * @brief Runs the remaining tasks and joins the workers.
+   */
+  ~BasicThreadPool() noexcept {
+    _stop.store(true, std::memory_order_release);
+    _epoch.fetch_add(1, std::memory_order_acq_rel);
+    detail::futex_wake(_epoch);
+    for (Worker* worker : _workers) {
+      worker->thread.join();
+    }
+    for (Worker* worker : _workers) {
+      void* block = worker->block;
+      worker->~Worker();
+      dealloc(block);
+    }
+  }
+
+  size_t size() const noexcept { return _workers.size(); }
+
+  /**
+   * @brief Runs fn on one of the workers.
+   *
+   * @throws std::bad_alloc If the task cannot be allocated.
+   */
+  template <typename Fn>
+  void submit(Fn&& fn) {
+    if (Worker* worker = current()) {
+      reclaim(worker);
+      Task* task = static_cast<Task*>(worker->tasks.allocate());
+      task->owner = worker->index;
+      try {
+        emplace(task, std::forward<Fn>(fn));
+      } catch (...) {
+        worker->tasks.deallocate(task);
+        throw;
+      }
+      worker->deque.push(task);
+    } else {
+      std::lock_guard lock(_mutex);
+      Task* task = static_cast<Task*>(_external_tasks.allocate());
+      task->owner = kExternal;
+      try {
+        emplace(task, std::forward<Fn>(fn));
+        _injected.push_back(task);
+      } catch (...) {
+        _external_tasks.deallocate(task);
+        throw;
+      }
+      _injected_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake_one();
+  }
+
+ private:
+  static constexpr uint32_t kExternal = UINT32_MAX;
+  // The number of rounds an idle worker looks for tasks before it parks.
+  static constexpr int kSpins = 64;
+  // The most tasks a worker moves from the injected queue to its deque at once.
+  static constexpr size_t kBatch = 32;
+
+  struct Task {
+    void (*invoke)(Task*);
+    Task* next;
+    uint32_t owner;
+    alignas(std::max_align_t) unsigned char storage[inline_size];
+  };
+
+  struct alignas(64) Worker {
+    detail::WorkStealingDeque<Task*, alloc, dealloc> deque;
+    Pool<sizeof(Task), alloc, dealloc> tasks;
+    // Tasks of this worker that other threads ran, they go back to the Pool on the next submit.
+    std::atomic<Task*> returned{nullptr};
+    uint32_t index;
+    uint64_t seed;
+    std::thread thread;
+    void* block;
+  };
+
+  Worker* current() const noexcept { return (_current_pool == this) ? _current_worker : nullptr; }
+
+  template <typename Fn>
+  static void emplace(Task* task, Fn&& fn) {
+    using F = std::decay_t<Fn>;
+    static_assert(alignof(F) <= alignof(std::max_align_t), "Over aligned tasks are not supported.");
+    if constexpr (sizeof(F) <= inline_size) {
+      new (task->storage) F(std::forward<Fn>(fn));
+      task->invoke = [](Task* self) {
+        F* f = std::launder(reinterpret_cast<F*>(self->storage));
+        (*f)();
+        f->~F();
+      };
+    } else {
+      F* f = static_cast<F*>(alloc(sizeof(F)));
+      try {
+        new (f) F(std::forward<Fn>(fn));
+      } catch (...) {
+        dealloc(f);
+        throw;
+      }
+      std::memcpy(task->storage, &f, sizeof(f));
+      task->invoke = [](Task* self) {
+        F* f;
+        std::memcpy(&f, self->storage, sizeof(f));
+        (*f)();
+        f->~F();
+        dealloc(f);
+      };
+    }
+  }
+
+  // Runs and frees a task, exceptions terminate the program.
+  void execute(Task* task, Worker* worker) noexcept {
+    task->invoke(task);
+    if (task->owner == worker->index) {
+      worker->tasks.deallocate(task);
+    } else if (task->owner == kExternal) {
+      std::lock_guard lock(_mutex);
+      _external_tasks.deallocate(task);
+    } else {
+      std::atomic<Task*>& returned = _workers[task->owner]->returned;
+      task->next = returned.load(std::memory_order_relaxed);
+      while (!returned.compare_exchange_weak(task->next, task, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+      }
+    }
+  }
+
+  // Moves the tasks other threads returned back into the Pool of worker.
+  static void reclaim(Worker* worker) noexcept {
+    if (worker->returned.load(std::memory_order_relaxed) == nullptr) {
+      return;
+    }
+    Task* task = worker->returned.exchange(nullptr, std::memory_order_acquire);
+    while (task != nullptr) {
+      Task* next = task->next;
+      worker->tasks.deallocate(task);
+      task = next;
+    }
+  }
+
+  Task* find_task(Worker* worker) {
+    if (Task* task = worker->deque.pop()) {
+      return task;
+    }
+    if (_injected_count.load(std::memory_order_relaxed) != 0) {
+      // Takes a share of the injected tasks at once, the rest of the batch can be stolen.
+      std::lock_guard lock(_mutex);
+      const size_t batch = std::min(_injected.size(), kBatch);
+      if (batch != 0) {
+        Task* task = _injected.front();
+        _injected.pop_front();
+        for (size_t i = 1; i < batch; ++i) {
+          worker->deque.push(_injected.front());
+          _injected.pop_front();
+        }
+        _injected_count.fetch_sub(batch, std::memory_order_relaxed);
+        return task;
+      }
+    }
+    const size_t count = _workers.size();
+    worker->seed ^= worker->seed << 13;
+    worker->seed ^= worker->seed >> 7;
+    worker->seed ^= worker->seed << 17;
+    const size_t start = worker->seed % count;
+    for (size_t i = 0; i < count; ++i) {
+      Worker* victim = _workers[(start + i) % count];
+      if (victim != worker) {
+        if (Task* task = victim->deque.steal()) {
+          return task;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  void work(Worker* worker) {
+    _current_pool = this;
+    _current_worker = worker;
+    // Searching workers pick up new tasks on their own, so submit only wakes a parked worker when
+    // there are none.
+    bool searching = false;
+    while (true) {
+      Task* task = worker->deque.pop();
+      if (task == nullptr) {
+        if (!searching) {
+          _searching.fetch_add(1, std::memory_order_seq_cst);
+          searching = true;
+        }
+        for (int i = 0; i < kSpins && task == nullptr; ++i) {
+          task = find_task(worker);
+          if (task == nullptr) {
+            detail::cpu_relax();
+          }
+        }
+        if (task != nullptr) {
+          searching = false;
+          stop_searching();
+        } else if (!_stop.load(std::memory_order_acquire)) {
+          task = park(worker);
+          searching = (task == nullptr);
+        } else {
+          searching = false;
+          _searching.fetch_sub(1, std::memory_order_relaxed);
+          if ((task = find_task(worker)) == nullptr) {
+            // Nothing was submitted before the pool was stopped, and only tasks can submit more.
+            return;
+          }
+        }
+      }
+      if (task != nullptr) {
+        execute(task, worker);
+      }
+    }
+  }
+
+  // The last searching worker to find a task hands the search over, there may be more tasks.
+  void stop_searching() noexcept {
+    if (_searching.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+      wake_one();
+    }
+  }
+
+  // Announces the worker as asleep, looks for a task once more and blocks until woken if there is
+  // none. Either this finds a task submitted before, or the submitter sees the sleeper, no
+  // searching worker and no pending wake, and wakes it. A woken worker returns nullptr and is
+  // searching again.
+  Task* park(Worker* worker) {
+    const uint32_t epoch = _epoch.load(std::memory_order_acquire);
+    _sleepers.fetch_add(1, std::memory_order_relaxed);
+    _searching.fetch_sub(1, std::memory_order_relaxed);
+    _waking.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Task* task = find_task(worker);
+    if (task == nullptr) {
+      if (!_stop.load(std::memory_order_acquire)) {
+        detail::futex_wait(_epoch, epoch);
+      }
+      _searching.fetch_add(1, std::memory_order_seq_cst);
+    }
+    _waking.store(false, std::memory_order_seq_cst);
+    _sleepers.fetch_sub(1, std::memory_order_relaxed);
+    if (task != nullptr) {
+      wake_one();
+    }
+    return task;
+  }
+
+  // Wakes a parked worker unless one is searching already or a wake has not been picked up yet, so
+  // a burst of submits from one thread costs one futex_wake.
+  void wake_one() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_searching.load(std::memory_order_relaxed) == 0 &&
+        _sleepers.load(std::memory_order_relaxed) != 0 &&
+        !_waking.exchange(true, std::memory_order_seq_cst)) {
+      _epoch.fetch_add(1, std::memory_order_release);
+      detail::futex_wake(_epoch, 1);
+    }
+  }
+
+  static inline thread_local const BasicThreadPool* _current_pool = nullptr;
+  static inline thread_local Worker* _current_worker = nullptr;
+
+  Vector<Worker*, alloc, dealloc> _workers;
+
+  // Guarded by _mutex.
+  std::mutex _mutex;
+  Deque<Task*, alloc, dealloc> _injected;
+  Pool<sizeof(Task), alloc, dealloc> _external_tasks;
+
+  std::atomic<size_t> _injected_count;
+  std::atomic<uint32_t> _epoch;
+  std::atomic<uint32_t> _sleepers;
+  std::atomic<uint32_t> _searching;
+  std::atomic<bool> _waking;
+  std::atomic<bool> _stop;
+};
+
+using ThreadPool = BasicThreadPool<>;
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_THREAD_POOL_H_
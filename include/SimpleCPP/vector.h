@@ -0,0 +1,453 @@
+#ifndef SIMPLECPP_VECTOR_H_
+#define SIMPLECPP_VECTOR_H_
+
+#include <SimpleCPP/allocator.h>
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace simplecpp {
+/**
+    @brief A dynamically sized array that stores its elements contiguously
+
+    @tparam T The type of the elements
+    @param alloc A custom allocator function, see Pointer for the requirements
+    @param dealloc A custom deallocator function that frees the allocated memory
+    @tparam GrowthFactor A std::ratio greater than one that the capacity is multiplied by when the
+   Vector runs out of space.
+
+    @note Trivially relocatable elements are moved with realloc when the default allocator is used
+   and with memcpy otherwise, so growing never runs element constructors for them.
+*/
+template <typename T, Allocator alloc = default_allocator,
+          Deallocator dealloc = default_deallocator, typename GrowthFactor = std::ratio<3, 2>>
+class Vector {
+  static_assert(GrowthFactor::num > GrowthFactor::den, "The growth factor must be above one.");
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over aligned types are not supported.");
+
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * @brief Default constructor to create an empty Vector without allocating.
+   */
+  Vector() noexcept : _data(nullptr), _size(0), _capacity(0) {}
+
+  /**
+   * @brief Creates a Vector of count value initialized elements.
+   */
+  explicit Vector(size_t count) : Vector() {
+    reserve_exact(count);
+    for (; _size < count; ++_size) {
+      new (_data + _size) T();
+    }
+  }
+
+  /**
+   * @brief Creates a Vector of count copies of value.
+   */
+  Vector(size_t count, const T& value) : Vector() {
+    reserve_exact(count);
+    for (; _size < count; ++_size) {
+      new (_data + _size) T(value);
+    }
+  }
+
+  Vector(std::initializer_list<T> values) : Vector() {
+    reserve_exact(values.size());
+    for (const auto& value : values) {
+      new (_data + _size) T(value);
+      ++_size;
+    }
+  }
+
+  /**
+   * @brief Copy constructor that copies every element into a buffer of exactly other.size().
+   */
+  Vector(const Vector& other) : Vector() {
+    reserve_exact(other._size);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      copy_bytes(_data, other._data, other._size);
+      _size = other._size;
+    } else {
+      for (; _size < other._size; ++_size) {
+        new (_data + _size) T(other._data[_size]);
+      }
+    }
+  }
+
+  /**
+   * @brief Move constructor that takes the buffer of other.
+   *
+   * @note This leaves the other Vector empty
+   */
+  Vector(Vector&& other) noexcept
+      : _data(other._data), _size(other._size), _capacity(other._capacity) {
+    other._data = nullptr;
+    other._size = 0;
+    other._capacity = 0;
+  }
+
+  ~Vector() noexcept {
+    clear();
+    release();
+  }
+
+  Vector& operator=(const Vector& other) {
+    if (this != &other) {
+      Vector copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  Vector& operator=(Vector&& other) noexcept {
+    if (this != &other) {
+      clear();
+      release();
+      _data = other._data;
+      _size = other._size;
+      _capacity = other._capacity;
+      other._data = nullptr;
+      other._size = 0;
+      other._capacity = 0;
+    }
+    return *this;
+  }
+
+  void swap(Vector& other) noexcept {
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+  }
+
+  T* data() noexcept { return _data; }
+  const T* data() const noexcept { return _data; }
+  size_t size() const noexcept { return _size; }
+  size_t capacity() const noexcept { return _capacity; }
+  bool empty() const noexcept { return _size == 0; }
+
+  iterator begin() noexcept { return _data; }
+  iterator end() noexcept { return _data + _size; }
+  const_iterator begin() const noexcept { return _data; }
+  const_iterator end() const noexcept { return _data + _size; }
+
+  /**
+   * @brief Accesses the element at index without bounds checking.
+   */
+  T& operator[](size_t index) noexcept { return _data[index]; }
+  const T& operator[](size_t index) const noexcept { return _data[index]; }
+
+  /**
+   * @brief Accesses the element at index.
+   *
+   * @throws std::out_of_range If index is not less than size().
+   */
+  T& at(size_t index) {
+    check_index(index);
+    return _data[index];
+  }
+  const T& at(size_t index) const {
+    check_index(index);
+    return _data[index];
+  }
+
+  T& front() noexcept { return _data[0]; }
+  const T& front() const noexcept { return _data[0]; }
+  T& back() noexcept { return _data[_size - 1]; }
+  const T& back() const noexcept { return _data[_size - 1]; }
+
+  /**
+   * @brief Ensures the capacity is at least count, growing by the growth factor if it must grow.
+   */
+  void reserve(size_t count) {
+    if (count > _capacity) {
+      grow_to(next_capacity(count));
+    }
+  }
+
+  /**
+   * @brief Ensures the capacity is at least count, allocating exactly count elements if it must
+   * grow.
+   *
+   * @note Use this when the final size is known to avoid the slack of geometric growth.
+   */
+  void reserve_exact(size_t count) {
+    if (count > _capacity) {
+      grow_to(count);
+    }
+  }
+
+  /**
+   * @brief Shrinks the capacity to size(), freeing the buffer if the Vector is empty.
+   */
+  void shrink_to_fit() {
+    if (_size == 0) {
+      release();
+    } else if (_size < _capacity) {
+      grow_to(_size);
+    }
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (_size == _capacity) {
+      return emplace_back_slow(std::forward<Args>(args)...);
+    }
+    return emplace_back_unchecked(std::forward<Args>(args)...);
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  /**
+   * @brief Constructs an element at the end without checking the capacity.
+   *
+   * @warning The caller must ensure size() < capacity(), e.g. with reserve_exact.
+   */
+  template <typename... Args>
+  T& emplace_back_unchecked(Args&&... args) {
+    T* slot = new (_data + _size) T(std::forward<Args>(args)...);
+    ++_size;
+    return *slot;
+  }
+
+  /**
+   * @brief Appends value without checking the capacity.
+   *
+   * @warning The caller must ensure size() < capacity(), e.g. with reserve_exact.
+   */
+  void push_back_unchecked(const T& value) { emplace_back_unchecked(value); }
+  void push_back_unchecked(T&& value) { emplace_back_unchecked(std::move(value)); }
+
+  /**
+   * @brief Destroys the last element.
+   *
+   * @warning The Vector must not be empty.
+   */
+  void pop_back() noexcept {
+    --_size;
+    _data[_size].~T();
+  }
+
+  /**
+   * @brief Inserts value before pos, shifting the following elements back.
+   *
+   * @return An iterator to the inserted element.
+   */
+  iterator insert(const_iterator pos, T value) {
+    const size_t index = pos - _data;
+    if constexpr (!is_trivially_relocatable_v<T>) {
+      if (_size == _capacity || !std::is_nothrow_move_constructible_v<T>) {
+        // Shifting in place could throw halfway, so the elements are copied into a new buffer.
+        const size_t capacity = (_size == _capacity) ? next_capacity(_size + 1) : _capacity;
+        T* data = static_cast<T*>(alloc(capacity * sizeof(T)));
+        try {
+          new (data + index) T(std::move(value));
+        } catch (...) {
+          dealloc(data);
+          throw;
+        }
+        try {
+          copy_into(data, index);
+        } catch (...) {
+          data[index].~T();
+          dealloc(data);
+          throw;
+        }
+        replace_buffer(data, capacity);
+        ++_size;
+        return _data + index;
+      }
+    }
+    reserve(_size + 1);
+    T* slot = _data + index;
+    if constexpr (is_trivially_relocatable_v<T>) {
+      std::memmove(static_cast<void*>(slot + 1), static_cast<const void*>(slot),
+                   (_size - index) * sizeof(T));
+    } else {
+      for (T* it = _data + _size; it != slot; --it) {
+        new (it) T(std::move(*(it - 1)));
+        (it - 1)->~T();
+      }
+    }
+    new (slot) T(std::move(value));
+    ++_size;
+    return slot;
+  }
+
+  /**
+   * @brief Removes the element at pos, shifting the following elements forward.
+   *
+   * @return An iterator to the element after the erased one.
+   */
+  iterator erase(const_iterator pos) noexcept {
+    T* slot = _data + (pos - _data);
+    slot->~T();
+    if constexpr (is_trivially_relocatable_v<T>) {
+      std::memmove(static_cast<void*>(slot), static_cast<const void*>(slot + 1),
+                   (end() - slot - 1) * sizeof(T));
+    } else {
+      for (T* it = slot; it + 1 != end(); ++it) {
+        new (it) T(std::move(*(it + 1)));
+        (it + 1)->~T();
+      }
+    }
+    --_size;
+    return slot;
+  }
+
+  /**
+   * @brief Resizes to count elements, value initializing any new elements.
+   */
+  void resize(size_t count) {
+    if (count < _size) {
+      truncate(count);
+      return;
+    }
+    reserve_exact(count);
+    for (; _size < count; ++_size) {
+      new (_data + _size) T();
+    }
+  }
+
+  void resize(size_t count, const T& value) {
+    if (count < _size) {
+      truncate(count);
+      return;
+    }
+    reserve_exact(count);
+    for (; _size < count; ++_size) {
+      new (_data + _size) T(value);
+    }
+  }
+
+  /**
+   * @brief Destroys every element but keeps the capacity.
+   */
+  void clear() noexcept { truncate(0); }
+
+  friend bool operator==(const Vector& a, const Vector& b) {
+    if (a._size != b._size) {
+      return false;
+    }
+    for (size_t i = 0; i < a._size; ++i) {
+      if (!(a._data[i] == b._data[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  void check_index(size_t index) const {
+    if (index >= _size) {
+      throw std::out_of_range("Vector index out of range.");
+    }
+  }
+
+  size_t next_capacity(size_t count) const noexcept {
+    const size_t grown = _capacity * GrowthFactor::num / GrowthFactor::den;
+    if (grown > count) {
+      return grown;
+    }
+    return (count > _capacity + 1) ? count : _capacity + 1;
+  }
+
+  template <typename... Args>
+  T& emplace_back_slow(Args&&... args) {
+    // The arguments may refer to an element of this Vector so they are consumed before growing.
+    T value(std::forward<Args>(args)...);
+    grow_to(next_capacity(_size + 1));
+    return emplace_back_unchecked(std::move(value));
+  }
+
+  static void copy_bytes(T* dest, const T* src, size_t count) noexcept {
+    if (count != 0) {
+      std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+    }
+  }
+
+  void grow_to(size_t capacity) {
+    if constexpr (is_trivially_relocatable_v<T> && is_reallocatable<alloc, dealloc>) {
+      _data = static_cast<T*>(default_reallocator(_data, capacity * sizeof(T)));
+      _capacity = capacity;
+    } else if constexpr (is_trivially_relocatable_v<T>) {
+      T* data = static_cast<T*>(alloc(capacity * sizeof(T)));
+      copy_bytes(data, _data, _size);
+      release();
+      _data = data;
+      _capacity = capacity;
+    } else {
+      T* data = static_cast<T*>(alloc(capacity * sizeof(T)));
+      try {
+        copy_into(data, _size);
+      } catch (...) {
+        dealloc(data);
+        throw;
+      }
+      replace_buffer(data, capacity);
+    }
+  }
+
+  // Moves, or copies if moving may throw, every element into data, skipping the slot at gap. If
+  // that throws, the elements built so far are destroyed and the Vector is left unchanged.
+  void copy_into(T* data, size_t gap) {
+    size_t built = 0;
+    try {
+      for (; built < _size; ++built) {
+        new (data + built + (built >= gap)) T(std::move_if_noexcept(_data[built]));
+      }
+    } catch (...) {
+      for (size_t i = 0; i < built; ++i) {
+        data[i + (i >= gap)].~T();
+      }
+      throw;
+    }
+  }
+
+  // Destroys the elements in the old buffer and frees it, keeping the size.
+  void replace_buffer(T* data, size_t capacity) noexcept {
+    for (size_t i = 0; i < _size; ++i) {
+      _data[i].~T();
+    }
+    release();
+    _data = data;
+    _capacity = capacity;
+  }
+
+  void truncate(size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_t i = count; i < _size; ++i) {
+        _data[i].~T();
+      }
+    }
+    _size = count;
+  }
+
+  void release() noexcept {
+    if (_data != nullptr) {
+      dealloc(_data);
+    }
+    _data = nullptr;
+    _capacity = 0;
+  }
+
+  T* _data;
+  size_t _size;
+  size_t _capacity;
+};
+
+template <typename T, Allocator alloc, Deallocator dealloc, typename GrowthFactor>
+struct is_trivially_relocatable<Vector<T, alloc, dealloc, GrowthFactor>> : std::true_type {};
+}  // namespace simplecpp
+
+#endif  // SIMPLECPP_VECTOR_H_
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/async_reader.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using pool = simplecpp::BufferPool<4096, 16>;
+using reader = simplecpp::AsyncReader<pool>;
+
+class AsyncReaderTest : public ::testing::TestWithParam<reader::Backend> {
+ protected:
+  void SetUp() override {
+    _fd = -1;
+    if (!available(GetParam())) {
+      GTEST_SKIP() << "io_uring is not available.";
+    }
+    char path[] = "/tmp/simplecpp_async_reader_XXXXXX";
+    _fd = mkstemp(path);
+    ASSERT_GE(_fd, 0);
+    unlink(path);
+    for (size_t i = 0; i < 100000; ++i) {
+      _contents.push_back(static_cast<char>('a' + i % 23));
+    }
+    ASSERT_EQ(write(_fd, _contents.data(), _contents.size()),
+              static_cast<ssize_t>(_contents.size()));
+  }
+
+  void TearDown() override {
+    if (_fd >= 0) {
+      close(_fd);
+    }
+  }
+
+  // io_uring may be disabled by the kernel or a seccomp filter.
+  static bool available(reader::Backend backend) {
+    try {
+      reader r(1, backend);
+      return true;
+    } catch (const std::system_error&) {
+      return false;
+    }
+  }
+
+  int _fd;
+  std::string _contents;
+};
+
+TEST_P(AsyncReaderTest, ReadsIntoPooledBuffers) {
+  reader r(4, GetParam());
+  EXPECT_EQ(r.backend(), GetParam());
+
+  std::vector<reader::Completion> completions;
+  for (uint64_t i = 0; i < 20; ++i) {
+    r.read(_fd, i * 4096, 4096, i);
+  }
+  EXPECT_EQ(r.in_flight(), 20);
+  while (r.in_flight() != 0) {
+    r.poll([&](reader::Completion&& c) { completions.push_back(std::move(c)); }, 1);
+  }
+
+  ASSERT_EQ(completions.size(), 20);
+  std::vector<bool> seen(20);
+  for (const auto& c : completions) {
+    EXPECT_EQ(c.error, 0);
+    EXPECT_EQ(c.data, std::string_view(_contents).substr(c.tag * 4096, 4096));
+    EXPECT_EQ(c.data.get_ref_count(), 1);
+    seen[c.tag] = true;
+  }
+  EXPECT_EQ(std::count(seen.begin(), seen.end(), true), 20);
+  EXPECT_EQ(pool::available(), 0);
+
+  completions.clear();
+  EXPECT_EQ(pool::available(), 16);
+}
+
+TEST_P(AsyncReaderTest, EndOfFileAndErrors) {
+  reader r(8, GetParam());
+  r.read(_fd, _contents.size() - 10, 4096, 1);
+  r.read(_fd, _contents.size() + 10, 4096, 2);
+  r.read(-1, 0, 4096, 3);
+  r.read(_fd, 0, 10000, 4);
+
+  size_t delivered = 0;
+  while (delivered < 4) {
+    delivered += r.poll(
+        [&](reader::Completion&& c) {
+          switch (c.tag) {
+            case 1:
+              EXPECT_EQ(c.data, std::string_view(_contents).substr(_contents.size() - 10));
+              break;
+            case 2:
+              EXPECT_EQ(c.error, 0);
+              EXPECT_TRUE(c.data.empty());
+              break;
+            case 3:
+              EXPECT_EQ(c.error, EBADF);
+              break;
+            case 4:
+              EXPECT_EQ(c.data, std::string_view(_contents).substr(0, 10000));
+              break;
+          }
+        },
+        4 - delivered);
+  }
+  EXPECT_EQ(r.poll([](reader::Completion&&) {}), 0);
+  EXPECT_EQ(pool::available(), 16);
+}
+
+TEST_P(AsyncReaderTest, DropsPendingReads) {
+  {
+    reader r(8, GetParam());
+    for (uint64_t i = 0; i < 8; ++i) {
+      r.read(_fd, i * 4096, 4096, i);
+    }
+    r.submit();
+  }
+  EXPECT_EQ(pool::available(), 16);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, AsyncReaderTest,
+                         ::testing::Values(reader::Backend::kIoUring,
+                                           reader::Backend::kThreadPool));
+
+TEST(BufferPoolTest, OwnsBeforeTheArenaIsMapped) {
+  // Not used by any other test, so its arena is only mapped by allocate below.
+  using fresh = simplecpp::BufferPool<1024, 2>;
+  void* data = std::malloc(16);
+  EXPECT_FALSE(fresh::owns(data));
+  fresh::deallocate(data);
+
+  void* block = fresh::allocate(16);
+  EXPECT_TRUE(fresh::owns(block));
+  fresh::deallocate(block);
+  EXPECT_EQ(fresh::available(), 2);
+}
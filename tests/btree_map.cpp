@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/btree_map.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using map = simplecpp::BTreeMap<int, int, std::less<int>, 64>;
+
+template <typename Map>
+void expect_same(const Map& m, const std::map<int, int>& reference) {
+  ASSERT_EQ(m.size(), reference.size());
+  auto it = reference.begin();
+  for (const auto [key, value] : m) {
+    ASSERT_EQ(key, it->first);
+    ASSERT_EQ(value, it->second);
+    ++it;
+  }
+}
+
+TEST(BTreeMapTest, Empty) {
+  map m{};
+
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.begin(), m.end());
+  EXPECT_FALSE(m.contains(1));
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_EQ(m.memory_usage(), 0);
+}
+
+TEST(BTreeMapTest, InsertFind) {
+  map m{};
+  std::map<int, int> reference{};
+  for (int i = 0; i < 5000; ++i) {
+    const int key = (i * 7919) % 5003;
+    EXPECT_TRUE(m.insert(key, i).second);
+    reference.emplace(key, i);
+  }
+  EXPECT_FALSE(m.insert(0, 1).second);
+
+  expect_same(m, reference);
+  EXPECT_EQ(m.at(7919 % 5003), 1);
+  EXPECT_THROW(m.at(-1), std::out_of_range);
+}
+
+TEST(BTreeMapTest, RandomInsertErase) {
+  map m{};
+  std::map<int, int> reference{};
+  unsigned state = 7;
+  for (int i = 0; i < 200000; ++i) {
+    state = state * 1103515245 + 12345;
+    const int key = static_cast<int>((state >> 8) % 2000);
+    if ((state >> 4) % 3 != 0) {
+      m[key] = i;
+      reference[key] = i;
+    } else {
+      ASSERT_EQ(m.erase(key), reference.erase(key) == 1);
+    }
+  }
+
+  expect_same(m, reference);
+  for (const auto& [key, value] : reference) {
+    ASSERT_TRUE(m.erase(key));
+  }
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(BTreeMapTest, Range) {
+  map m{};
+  for (int i = 0; i < 1000; ++i) {
+    m.insert(i * 2, i);
+  }
+  auto [first, last] = m.range(101, 201);
+  int count = 0;
+  for (auto it = first; it != last; ++it) {
+    EXPECT_EQ(it.key(), 102 + 2 * count);
+    ++count;
+  }
+
+  EXPECT_EQ(count, 50);
+  EXPECT_EQ(m.lower_bound(2000), m.end());
+}
+
+TEST(BTreeMapTest, BulkLoad) {
+  std::map<int, int> reference{};
+  for (int i = 0; i < 10000; ++i) {
+    reference.emplace(i * 3, i);
+  }
+  map m{};
+  m.bulk_load(reference.begin(), reference.end());
+  expect_same(m, reference);
+
+  for (int i = 0; i < 10000; i += 2) {
+    m.erase(i * 3);
+    reference.erase(i * 3);
+    m.insert(i * 3 + 1, i);
+    reference.emplace(i * 3 + 1, i);
+  }
+  expect_same(m, reference);
+
+  map copy{m};
+  expect_same(copy, reference);
+}
+
+TEST(BTreeMapTest, NonTrivialEntries) {
+  simplecpp::BTreeMap<std::string, std::string> m{};
+  for (int i = 0; i < 1000; ++i) {
+    m.insert(std::to_string(i), "value" + std::to_string(i));
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    m.erase(std::to_string(i));
+  }
+
+  EXPECT_EQ(m.size(), 500);
+  EXPECT_EQ(m.at("999"), "value999");
+  EXPECT_FALSE(m.contains("998"));
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/buffered_writer.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+std::atomic<size_t> alloc_count;
+std::atomic<size_t> dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using writer = simplecpp::BasicBufferedWriter<alloc, dealloc, 1024>;
+
+class BufferedWriterTest : public ::testing::TestWithParam<writer::Flush> {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+    char path[] = "/tmp/simplecpp_buffered_writer_XXXXXX";
+    _fd = mkstemp(path);
+    ASSERT_GE(_fd, 0);
+    unlink(path);
+  }
+
+  void TearDown() override { close(_fd); }
+
+  std::string contents() const {
+    std::string result(file_size(), '\0');
+    EXPECT_EQ(pread(_fd, result.data(), result.size(), 0), static_cast<ssize_t>(result.size()));
+    return result;
+  }
+
+  size_t file_size() const {
+    struct stat info {};
+    fstat(_fd, &info);
+    return static_cast<size_t>(info.st_size);
+  }
+
+  int _fd;
+};
+
+TEST_P(BufferedWriterTest, WritesInOrder) {
+  std::string expected;
+  {
+    writer w(_fd, GetParam(), 4096, std::chrono::milliseconds(0), 2);
+    for (int i = 0; i < 10000; ++i) {
+      const std::string record = "record " + std::to_string(i) + "\n";
+      w.write(record);
+      expected += record;
+    }
+    w.put('!');
+    expected += '!';
+    w.write(std::string(5000, 'x'));
+    expected += std::string(5000, 'x');
+    EXPECT_LT(w.buffered(), 4096);
+  }
+  EXPECT_EQ(contents(), expected);
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_P(BufferedWriterTest, SteadyStateDoesNotAllocate) {
+  writer w(_fd, GetParam(), 4096, std::chrono::milliseconds(0));
+  const std::string record(100, 'r');
+  for (int i = 0; i < 1000; ++i) {
+    w.write(record);
+  }
+  w.flush();
+  const size_t allocs = alloc_count;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      w.write(record);
+    }
+    w.flush();
+  }
+  EXPECT_EQ(alloc_count, allocs);
+  EXPECT_EQ(file_size(), 11000 * record.size());
+}
+
+TEST_P(BufferedWriterTest, FlushesAfterInterval) {
+  writer w(_fd, GetParam(), 1 << 20, std::chrono::milliseconds(5));
+  w.write("first\n");
+  if (GetParam() == writer::Flush::kInline) {
+    // The background thread may already have flushed the idle writer.
+    EXPECT_EQ(file_size(), 0);
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (file_size() == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    w.put('.');
+  }
+  EXPECT_GT(file_size(), 0);
+  w.flush();
+  EXPECT_EQ(contents().substr(0, 6), "first\n");
+  EXPECT_EQ(w.buffered(), 0);
+}
+
+TEST_F(BufferedWriterTest, BackgroundFlushesIdleWriter) {
+  writer w(_fd, writer::Flush::kBackground, 1 << 20, std::chrono::milliseconds(5));
+  w.write("only\n");
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (file_size() == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(contents(), "only\n");
+  EXPECT_EQ(w.buffered(), 0);
+
+  w.write("more\n");
+  w.flush();
+  EXPECT_EQ(contents(), "only\nmore\n");
+}
+
+TEST_P(BufferedWriterTest, ReportsErrors) {
+  writer w(-1, GetParam(), 16, std::chrono::milliseconds(0));
+  EXPECT_THROW(
+      {
+        w.write("more than sixteen bytes");
+        w.flush();
+      },
+      std::system_error);
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, BufferedWriterTest,
+                         ::testing::Values(writer::Flush::kInline, writer::Flush::kBackground));
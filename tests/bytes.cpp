@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/bytes.h>
+
+#include <string>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using bytes = simplecpp::BasicBytes<alloc, dealloc>;
+using bytes_mut = simplecpp::BasicBytesMut<alloc, dealloc>;
+
+class BytesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(BytesTest, Empty) {
+  bytes b{};
+  bytes_mut m{};
+
+  EXPECT_TRUE(b.empty());
+  EXPECT_TRUE(m.freeze().empty());
+  EXPECT_EQ(b.slice(0, 0).size(), 0);
+  EXPECT_THROW(b.slice(0, 1), std::out_of_range);
+  EXPECT_EQ(alloc_count, 0);
+}
+
+TEST_F(BytesTest, SlicesShareTheBuffer) {
+  {
+    bytes message("GET /index.html HTTP/1.1");
+    bytes method = message.split_to(3);
+    message.split_to(1);
+    bytes version = message.split_off(message.size() - 8);
+
+    EXPECT_EQ(method, "GET");
+    EXPECT_EQ(message, "/index.html ");
+    EXPECT_EQ(version, "HTTP/1.1");
+    EXPECT_EQ(version.slice(5, 8), "1.1");
+    EXPECT_EQ(method.get_ref_count(), 3);
+    EXPECT_EQ(alloc_count, 1);
+  }
+  EXPECT_EQ(dealloc_count, 1);
+}
+
+TEST_F(BytesTest, FreezeDoesNotCopy) {
+  {
+    bytes_mut m(4);
+    m.append("head");
+    const uint8_t* data = m.data();
+    m.push_back(':');
+    m.append(std::string(100, 'x'));
+
+    EXPECT_EQ(m.size(), 105);
+    EXPECT_GE(m.capacity(), 105);
+    EXPECT_NE(m.data(), data);
+    const uint8_t* grown = m.data();
+
+    bytes frozen = m.freeze();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(frozen.data(), grown);
+    EXPECT_EQ(frozen.size(), 105);
+    EXPECT_EQ(frozen.slice(0, 5), "head:");
+    EXPECT_EQ(frozen[104], 'x');
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(BytesTest, FromBuffer) {
+  simplecpp::Pointer<uint8_t[], alloc, dealloc> buffer(10, 'a');
+  bytes whole(buffer);
+  bytes part(buffer, 2, 3);
+
+  EXPECT_EQ(whole.size(), 10);
+  EXPECT_EQ(part, "aaa");
+  EXPECT_EQ(buffer.get_ref_count(), 3);
+  EXPECT_THROW(bytes(buffer, 8, 3), std::out_of_range);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/cache.h>
+
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lru = simplecpp::Cache<int, int>;
+using clock_cache = simplecpp::Cache<int, int, simplecpp::ClockPolicy>;
+
+size_t allocs_left = SIZE_MAX;
+
+// Fails the allocation after allocs_left others, once.
+void* failing_alloc(const size_t& size) {
+  if (allocs_left == 0) {
+    allocs_left = SIZE_MAX;
+    throw std::bad_alloc();
+  }
+  --allocs_left;
+  return simplecpp::default_allocator(size);
+}
+
+TEST(CacheTest, LruEviction) {
+  lru c{3};
+  for (int i = 0; i < 3; ++i) {
+    c.put(i, lru::pointer{i});
+  }
+  c.get(0);
+  c.put(3, lru::pointer{3});
+
+  EXPECT_EQ(c.size(), 3);
+  EXPECT_TRUE(c.contains(0));
+  EXPECT_FALSE(c.contains(1));
+  EXPECT_TRUE(c.contains(2));
+  EXPECT_TRUE(c.contains(3));
+}
+
+TEST(CacheTest, ClockEviction) {
+  clock_cache c{3};
+  for (int i = 0; i < 3; ++i) {
+    c.put(i, clock_cache::pointer{i});
+  }
+  c.get(0);
+  c.get(2);
+  c.put(3, clock_cache::pointer{3});
+
+  EXPECT_EQ(c.size(), 3);
+  EXPECT_TRUE(c.contains(0));
+  EXPECT_FALSE(c.contains(1));
+  EXPECT_TRUE(c.contains(2));
+  EXPECT_EQ(*c.get(3), 3);
+}
+
+TEST(CacheTest, EvictedValueStaysAlive) {
+  simplecpp::Cache<int, std::string> c{1};
+  c.put(1, simplecpp::Pointer<std::string>{std::string("one")});
+  auto value = c.get(1);
+  c.put(2, simplecpp::Pointer<std::string>{std::string("two")});
+
+  EXPECT_FALSE(c.contains(1));
+  EXPECT_EQ(value.get_ref_count(), 1);
+  EXPECT_EQ(*value, "one");
+  EXPECT_FALSE(c.get(1).is_valid());
+}
+
+TEST(CacheTest, ByteCapacity) {
+  using bytes = simplecpp::Cache<int, double, simplecpp::LruPolicy, simplecpp::AllocSizeWeigher>;
+  const size_t entry = sizeof(size_t) + sizeof(double);
+  bytes c{entry * 4};
+  for (int i = 0; i < 10; ++i) {
+    c.put(i, bytes::pointer{1.0 * i});
+  }
+
+  EXPECT_EQ(c.size(), 4);
+  EXPECT_EQ(c.weight(), entry * 4);
+  EXPECT_TRUE(c.contains(9));
+  EXPECT_FALSE(c.contains(5));
+  c.set_capacity(entry);
+  EXPECT_EQ(c.size(), 1);
+  EXPECT_TRUE(c.contains(9));
+}
+
+TEST(CacheTest, ReplaceAndErase) {
+  lru c{2};
+  c.put(1, lru::pointer{1});
+  c.put(1, lru::pointer{10});
+
+  EXPECT_EQ(c.size(), 1);
+  EXPECT_EQ(*c.peek(1), 10);
+  EXPECT_TRUE(c.erase(1));
+  EXPECT_FALSE(c.erase(1));
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(c.weight(), 0);
+}
+
+TEST(CacheTest, Sharded) {
+  simplecpp::ShardedCache<int, int, simplecpp::ClockPolicy> c{1024};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 10000; ++i) {
+        const int key = (i * 13 + t) % 4096;
+        const auto value = c.get(key);
+        if (value.is_valid()) {
+          EXPECT_EQ(*value, key);
+        } else {
+          c.put(key, simplecpp::Pointer<int>{key});
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_LE(c.size(), 1024);
+  EXPECT_EQ(c.size(), c.weight());
+}
+
+TEST(CacheTest, ShardedSmallCapacity) {
+  EXPECT_THROW((simplecpp::ShardedCache<int, int>{15}), std::invalid_argument);
+
+  // 16 shards share 20 entries, so 4 of them hold two entries and the rest one.
+  simplecpp::ShardedCache<int, int> c{20};
+  for (int key = 0; key < 1000; ++key) {
+    c.put(key, simplecpp::Pointer<int>{key});
+  }
+  EXPECT_EQ(c.size(), 20);
+  EXPECT_TRUE(c.get(999).is_valid());
+}
+
+TEST(CacheTest, ThrowingPutLosesNothing) {
+  using failing_cache =
+      simplecpp::Cache<int, int, simplecpp::LruPolicy, simplecpp::CountWeigher, std::hash<int>,
+                       std::equal_to<int>, failing_alloc, simplecpp::default_deallocator>;
+  const failing_cache::pointer value{1};
+  // Fails each allocation of the run in turn, until the run has fewer allocations than fail_after.
+  for (size_t fail_after = 0, failures = 1; failures != 0; ++fail_after) {
+    failing_cache c{32};
+    allocs_left = fail_after;
+    failures = 0;
+    for (int i = 0; i < 500; ++i) {
+      try {
+        c.put(i * 7 % 97, value);
+      } catch (const std::bad_alloc&) {
+        ++failures;
+      }
+      // The Cache holds one reference per entry, and none for a put that threw.
+      ASSERT_EQ(value.get_ref_count(), 1 + c.size());
+      ASSERT_EQ(c.weight(), c.size());
+    }
+    allocs_left = SIZE_MAX;
+    EXPECT_EQ(c.size(), 32);
+  }
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/compact_pointer.h>
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+std::atomic<size_t> constructed;
+std::atomic<size_t> destroyed;
+
+struct Node {
+  explicit Node(int value) : value(value) { ++constructed; }
+  Node(const Node& other) : value(other.value) { ++constructed; }
+  ~Node() { ++destroyed; }
+
+  int value;
+  simplecpp::CompactPointer<Node> left;
+  simplecpp::CompactPointer<Node> right;
+};
+
+struct Throws {
+  Throws() { throw std::runtime_error("Throws"); }
+};
+
+struct SmallTag {};
+using small_arena = simplecpp::CompactArena<4096, 8, SmallTag>;
+using ptr = simplecpp::CompactPointer<Node>;
+
+class CompactPointerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    constructed = 0;
+    destroyed = 0;
+  }
+};
+
+TEST_F(CompactPointerTest, Size) {
+  EXPECT_EQ(sizeof(ptr), 4);
+  EXPECT_EQ(sizeof(Node), 12);
+}
+
+TEST_F(CompactPointerTest, DefaultConstructor) {
+  ptr p{};
+  EXPECT_FALSE(p.is_valid());
+  EXPECT_EQ(p.handle(), 0);
+  EXPECT_EQ(p.get(), nullptr);
+  EXPECT_EQ(p.get_ref_count(), 0);
+  EXPECT_THROW(*p, std::runtime_error);
+}
+
+TEST_F(CompactPointerTest, RefCount) {
+  {
+    auto p = ptr::make(3);
+    EXPECT_TRUE(p.is_valid());
+    EXPECT_NE(p.handle(), 0);
+    EXPECT_EQ(p->value, 3);
+    EXPECT_EQ(p.get_ref_count(), 1);
+
+    ptr copy = p;
+    EXPECT_EQ(copy, p);
+    EXPECT_EQ(p.get_ref_count(), 2);
+
+    ptr moved = std::move(copy);
+    EXPECT_FALSE(copy.is_valid());
+    EXPECT_EQ(moved.get_ref_count(), 2);
+
+    moved = ptr(Node(4));
+    EXPECT_EQ(p.get_ref_count(), 1);
+    EXPECT_EQ(moved->value, 4);
+    EXPECT_NE(moved, p);
+  }
+  EXPECT_EQ(constructed, destroyed);
+}
+
+TEST_F(CompactPointerTest, HandleRoundTrip) {
+  auto p = ptr::make(5);
+  using arena = simplecpp::CompactArena<>;
+  EXPECT_EQ(arena::handle_of(p.get()), p.handle());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(arena::at(p.handle())) % arena::kAlignment, 0);
+}
+
+TEST_F(CompactPointerTest, Tree) {
+  {
+    std::vector<ptr> level;
+    for (int i = 0; i < 1024; ++i) {
+      level.push_back(ptr::make(i));
+    }
+    while (level.size() > 1) {
+      std::vector<ptr> parents;
+      for (size_t i = 0; i < level.size(); i += 2) {
+        auto parent = ptr::make(level[i]->value + level[i + 1]->value);
+        parent->left = std::move(level[i]);
+        parent->right = std::move(level[i + 1]);
+        parents.push_back(std::move(parent));
+      }
+      level = std::move(parents);
+    }
+    EXPECT_EQ(level[0]->value, 1023 * 1024 / 2);
+    EXPECT_EQ(level[0]->left->left->value + level[0]->left->right->value, level[0]->left->value);
+  }
+  EXPECT_EQ(constructed, 2047);
+  EXPECT_EQ(destroyed, constructed);
+}
+
+TEST_F(CompactPointerTest, ArenaReusesFreedBlocks) {
+  const uint32_t first = small_arena::allocate(12);
+  const size_t used = small_arena::used();
+  small_arena::deallocate(first, 16);
+  EXPECT_EQ(small_arena::allocate(9), first);
+  EXPECT_EQ(small_arena::used(), used);
+
+  // A different size class does not take the freed block.
+  small_arena::deallocate(first, 16);
+  const uint32_t other = small_arena::allocate(600);
+  EXPECT_NE(other, first);
+  EXPECT_EQ(small_arena::used(), used + 1024);
+  small_arena::deallocate(other, 600);
+}
+
+TEST_F(CompactPointerTest, ArenaFull) {
+  using tiny_arena = simplecpp::CompactArena<256, 8, Throws>;
+  std::vector<uint32_t> handles;
+  for (int i = 0; i < 31; ++i) {
+    handles.push_back(tiny_arena::allocate(8));
+  }
+  EXPECT_THROW(tiny_arena::allocate(8), std::bad_alloc);
+  tiny_arena::deallocate(handles.back(), 8);
+  EXPECT_EQ(tiny_arena::allocate(8), handles.back());
+}
+
+TEST_F(CompactPointerTest, ConstructorThrows) {
+  using throws_ptr = simplecpp::CompactPointer<Throws, small_arena>;
+  EXPECT_THROW(throws_ptr::make(), std::runtime_error);
+  // The block was freed, so allocating one of the same size does not grow the arena.
+  const size_t used = small_arena::used();
+  const uint32_t handle = small_arena::allocate(sizeof(uint32_t) + sizeof(Throws));
+  EXPECT_EQ(small_arena::used(), used);
+  small_arena::deallocate(handle, sizeof(uint32_t) + sizeof(Throws));
+}
+
+TEST_F(CompactPointerTest, ConcurrentCopies) {
+  auto shared = ptr::make(1);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&shared] {
+      for (int i = 0; i < 10000; ++i) {
+        ptr copy = shared;
+        auto own = ptr::make(i);
+        own->left = copy;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(shared.get_ref_count(), 1);
+}
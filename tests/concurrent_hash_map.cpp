@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/concurrent_hash_map.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using map = simplecpp::ConcurrentHashMap<int, std::string>;
+
+TEST(ConcurrentHashMapTest, InsertFind) {
+  map m{};
+
+  EXPECT_TRUE(m.insert(1, map::pointer{std::string("one")}));
+  EXPECT_FALSE(m.insert(1, map::pointer{std::string("uno")}));
+  EXPECT_EQ(*m.find(1), "one");
+  EXPECT_FALSE(m.find(2).is_valid());
+  EXPECT_TRUE(m.contains(1));
+  EXPECT_EQ(m.size(), 1);
+}
+
+TEST(ConcurrentHashMapTest, ValueOutlivesErase) {
+  map m{};
+  m.insert(1, map::pointer{std::string("one")});
+  auto value = m.find(1);
+
+  EXPECT_EQ(value.get_ref_count(), 2);
+  auto erased = m.erase(1);
+  EXPECT_EQ(erased, value);
+  erased = map::pointer(nullptr);
+  EXPECT_EQ(value.get_ref_count(), 1);
+  EXPECT_EQ(*value, "one");
+  EXPECT_FALSE(m.erase(1).is_valid());
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(ConcurrentHashMapTest, FindOrInsert) {
+  map m{};
+  int calls = 0;
+  auto make = [&] {
+    ++calls;
+    return std::string("made");
+  };
+  auto first = m.find_or_insert(1, make);
+  auto second = m.find_or_insert(1, make);
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(ConcurrentHashMapTest, ConcurrentReadersAndWriters) {
+  simplecpp::ConcurrentHashMap<int, int> m{};
+  constexpr int keys = 1000;
+  for (int i = 0; i < keys; ++i) {
+    m.insert(i, simplecpp::Pointer<int>{i});
+  }
+
+  std::atomic<bool> failed = false;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 20000; ++i) {
+        const int key = (i * 7 + t) % keys;
+        if (t == 0 && i % 10 == 0) {
+          m.insert_or_assign(key, simplecpp::Pointer<int>{key});
+          continue;
+        }
+        const auto value = m.find(key);
+        if (!value.is_valid() || *value != key) {
+          failed = true;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(m.size(), keys);
+  size_t visited = 0;
+  m.for_each([&](const int& key, const auto& value) {
+    EXPECT_EQ(*value, key);
+    ++visited;
+  });
+  EXPECT_EQ(visited, keys);
+}
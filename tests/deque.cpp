@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/deque.h>
+
+#include <deque>
+#include <string>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using deque = simplecpp::Deque<int, alloc, dealloc, 64>;
+
+class DequeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(DequeTest, DefaultConstructor) {
+  deque d{};
+
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(d.begin(), d.end());
+  EXPECT_EQ(alloc_count, 0);
+}
+
+TEST_F(DequeTest, PushPopBothEnds) {
+  {
+    deque d{};
+    std::deque<int> reference{};
+    for (int i = 1; i < 1000; ++i) {
+      if (i % 3 == 0) {
+        d.push_front(i);
+        reference.push_front(i);
+      } else {
+        d.push_back(i);
+        reference.push_back(i);
+      }
+      if (i % 7 == 0) {
+        d.pop_back();
+        reference.pop_back();
+      }
+      if (i % 11 == 0) {
+        d.pop_front();
+        reference.pop_front();
+      }
+    }
+
+    ASSERT_EQ(d.size(), reference.size());
+    EXPECT_EQ(d.front(), reference.front());
+    EXPECT_EQ(d.back(), reference.back());
+    EXPECT_TRUE(std::equal(d.begin(), d.end(), reference.begin()));
+    EXPECT_EQ(d.at(5), reference[5]);
+    EXPECT_THROW(d.at(d.size()), std::out_of_range);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(DequeTest, StableReferences) {
+  deque d{};
+  d.push_back(1);
+  int* first = &d.front();
+  for (int i = 0; i < 1000; ++i) {
+    d.push_back(i);
+    d.push_front(i);
+  }
+
+  EXPECT_EQ(first, &d[1000]);
+  EXPECT_EQ(*first, 1);
+}
+
+TEST_F(DequeTest, SteadyStateDoesNotAllocate) {
+  deque d{};
+  for (int i = 0; i < 100; ++i) {
+    d.push_back(i);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    d.push_back(i);
+    d.pop_front();
+  }
+  const size_t warm = alloc_count;
+  for (int i = 0; i < 100000; ++i) {
+    d.push_back(i);
+    d.pop_front();
+  }
+
+  EXPECT_EQ(alloc_count, warm);
+  EXPECT_EQ(d.size(), 100);
+  EXPECT_EQ(d.back(), 99999);
+}
+
+TEST_F(DequeTest, FreesBlocksAfterSpike) {
+  deque d{};
+  for (int i = 0; i < 100000; ++i) {
+    d.push_back(i);
+  }
+  while (!d.empty()) {
+    d.pop_front();
+  }
+
+  // Only the spare blocks and the block map outlive the spike.
+  EXPECT_EQ(alloc_count - dealloc_count, deque::kSpareBlocks + 1);
+}
+
+TEST_F(DequeTest, CopyMove) {
+  simplecpp::Deque<std::string> d{"a", "b", "c"};
+  d.push_front("z");
+  auto copy = d;
+  auto moved = std::move(d);
+
+  EXPECT_TRUE(d.empty());
+  EXPECT_EQ(copy.size(), 4);
+  EXPECT_EQ(moved.front(), "z");
+  EXPECT_EQ(moved.back(), "c");
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), moved.begin()));
+}
+
+TEST_F(DequeTest, Clear) {
+  {
+    deque d{1, 2, 3};
+    d.clear();
+
+    EXPECT_TRUE(d.empty());
+    d.push_front(4);
+    EXPECT_EQ(d.front(), 4);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
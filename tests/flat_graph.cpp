@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/flat_graph.h>
+#include <SimpleCPP/mapped_file.h>
+#include <SimpleCPP/vector.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using simplecpp::FlatArray;
+using simplecpp::FlatRef;
+using simplecpp::FlatView;
+using simplecpp::FlatWriter;
+using simplecpp::Pointer;
+
+struct Point {
+  double x;
+  double y;
+};
+
+struct Node {
+  int value;
+  Pointer<Node> left{nullptr};
+  Pointer<Node> right{nullptr};
+  simplecpp::Vector<Pointer<Point>> points;
+};
+
+struct FlatNode {
+  int value;
+  FlatRef<FlatNode> left;
+  FlatRef<FlatNode> right;
+  FlatArray<FlatRef<Point>> points;
+};
+
+/**
+ * @brief Encodes a Node and everything it points to.
+ */
+struct Encode {
+  FlatNode operator()(const Node& node, FlatWriter& writer) const {
+    simplecpp::Vector<FlatRef<Point>> points;
+    for (const auto& point : node.points) {
+      points.push_back(writer.write(point));
+    }
+    return FlatNode{node.value, writer.write(node.left, *this), writer.write(node.right, *this),
+                    writer.write_array(points.data(), points.size())};
+  }
+};
+
+Pointer<Node> make_node(int value, Pointer<Node> left = Pointer<Node>(nullptr),
+                        Pointer<Node> right = Pointer<Node>(nullptr)) {
+  return Pointer<Node>(Node{value, std::move(left), std::move(right), {}});
+}
+
+TEST(FlatGraphTest, TriviallyCopyable) {
+  FlatWriter writer;
+  Pointer<Point> point(Point{1.5, -2});
+  const auto ref = writer.write(point);
+  EXPECT_EQ(writer.write(point), ref);
+  EXPECT_FALSE(writer.write(Pointer<Point>(nullptr)));
+
+  const auto bytes = writer.finish(ref);
+  FlatView view(bytes);
+  EXPECT_EQ(view.size(), bytes.size());
+  EXPECT_EQ(view.root<Point>().x, 1.5);
+  EXPECT_EQ(view.root<Point>().y, -2);
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(&view.root<Point>()), bytes.data() + ref.offset);
+}
+
+TEST(FlatGraphTest, FreedAddressIsNotReused) {
+  FlatWriter writer;
+  const auto first = writer.write(Pointer<Point>(Point{1, 2}));
+  const auto second = writer.write(Pointer<Point>(Point{3, 4}));
+  EXPECT_NE(first, second);
+
+  const auto bytes = writer.finish(second);
+  FlatView view(bytes);
+  EXPECT_EQ(view.get(first)->x, 1);
+  EXPECT_EQ(view.root<Point>().x, 3);
+}
+
+TEST(FlatGraphTest, Tree) {
+  auto root = make_node(1, make_node(2, make_node(4)), make_node(3));
+  root->points.push_back(Pointer<Point>(Point{1, 2}));
+  root->points.push_back(Pointer<Point>(Point{3, 4}));
+
+  FlatWriter writer;
+  const auto bytes = writer.finish(writer.write(root, Encode{}));
+  FlatView view(bytes);
+
+  const FlatNode& flat = view.root<FlatNode>();
+  EXPECT_EQ(flat.value, 1);
+  EXPECT_EQ(view.get(flat.left)->value, 2);
+  EXPECT_EQ(view.get(view.get(flat.left)->left)->value, 4);
+  EXPECT_EQ(view.get(view.get(flat.left)->right), nullptr);
+  EXPECT_EQ(view.get(flat.right)->value, 3);
+
+  const auto points = view.get(flat.points);
+  ASSERT_EQ(points.size(), 2);
+  EXPECT_EQ(view.get(points[1])->y, 4);
+  EXPECT_TRUE(view.get(view.get(flat.right)->points).empty());
+}
+
+TEST(FlatGraphTest, SharedNodesAreWrittenOnce) {
+  auto shared = make_node(7, make_node(8), make_node(9));
+  auto dag = make_node(1, shared, shared);
+  auto tree = make_node(1, make_node(7, make_node(8), make_node(9)),
+                        make_node(7, make_node(8), make_node(9)));
+
+  FlatWriter dag_writer;
+  const auto dag_bytes = dag_writer.finish(dag_writer.write(dag, Encode{}));
+  FlatWriter tree_writer;
+  const auto tree_bytes = tree_writer.finish(tree_writer.write(tree, Encode{}));
+  EXPECT_LT(dag_bytes.size(), tree_bytes.size());
+
+  FlatView view(dag_bytes);
+  const FlatNode& root = view.root<FlatNode>();
+  EXPECT_EQ(root.left, root.right);
+  EXPECT_EQ(view.get(view.get(root.right)->right)->value, 9);
+}
+
+TEST(FlatGraphTest, CycleThrows) {
+  auto first = make_node(1);
+  auto second = make_node(2, first);
+  first->left = second;
+
+  FlatWriter writer;
+  EXPECT_THROW(writer.write(first, Encode{}), std::invalid_argument);
+  first->left = Pointer<Node>(nullptr);
+
+  const auto bytes = writer.finish(writer.write(second, Encode{}));
+  FlatView view(bytes);
+  EXPECT_EQ(view.root<FlatNode>().value, 2);
+  EXPECT_EQ(view.get(view.root<FlatNode>().left)->value, 1);
+}
+
+TEST(FlatGraphTest, WriterIsReusedAfterFinish) {
+  auto root = make_node(1, make_node(2));
+  FlatWriter writer;
+  const auto first = writer.finish(writer.write(root, Encode{}));
+  EXPECT_EQ(writer.size(), sizeof(simplecpp::detail::FlatHeader));
+
+  const auto second = writer.finish(writer.write(root, Encode{}));
+  EXPECT_EQ(second.size(), first.size());
+  FlatView view(second);
+  EXPECT_EQ(view.root<FlatNode>().value, 1);
+  EXPECT_EQ(view.get(view.root<FlatNode>().left)->value, 2);
+}
+
+TEST(FlatGraphTest, MappedFile) {
+  auto root = make_node(1, make_node(2), make_node(3));
+  FlatWriter writer;
+  const auto bytes = writer.finish(writer.write(root, Encode{}));
+
+  char path[] = "/tmp/simplecpp_flat_graph_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(write(fd, bytes.data(), bytes.size()), static_cast<ssize_t>(bytes.size()));
+  close(fd);
+
+  simplecpp::MappedFile file(path);
+  FlatView view(file);
+  const FlatNode& flat = view.root<FlatNode>();
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(&flat), file.data());
+  EXPECT_LT(reinterpret_cast<const uint8_t*>(&flat), file.data() + file.size());
+  EXPECT_EQ(view.get(flat.left)->value + view.get(flat.right)->value, 5);
+  unlink(path);
+}
+
+TEST(FlatGraphTest, Validation) {
+  auto root = make_node(1, make_node(2));
+  FlatWriter writer;
+  const auto bytes = writer.finish(writer.write(root, Encode{}));
+  FlatView view(bytes);
+
+  EXPECT_THROW(FlatView(bytes.data(), bytes.size() - 1), std::runtime_error);
+  EXPECT_THROW(FlatView(bytes.data(), 8), std::runtime_error);
+  EXPECT_THROW(view.root<FlatNode[2]>(), std::out_of_range);
+
+  FlatRef<FlatNode> past_end{bytes.size()};
+  EXPECT_THROW(view.get(past_end), std::out_of_range);
+  FlatRef<FlatNode> in_header{8};
+  EXPECT_THROW(view.get(in_header), std::out_of_range);
+  FlatRef<FlatNode> misaligned{view.root<FlatNode>().left.offset + 1};
+  EXPECT_THROW(view.get(misaligned), std::out_of_range);
+  FlatArray<FlatNode> too_long{view.root<FlatNode>().left.offset, UINT64_MAX / 8};
+  EXPECT_THROW(view.get(too_long), std::out_of_range);
+
+  std::string corrupt(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  corrupt[0] ^= 1;
+  alignas(16) char copy[1024];
+  ASSERT_LE(corrupt.size(), sizeof(copy));
+  std::memcpy(copy, corrupt.data(), corrupt.size());
+  EXPECT_THROW(FlatView(copy, corrupt.size()), std::runtime_error);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/flat_hash_map.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using map = simplecpp::FlatHashMap<int, int, std::hash<int>, std::equal_to<int>, alloc, dealloc>;
+
+class FlatHashMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(FlatHashMapTest, DefaultConstructor) {
+  map m{};
+
+  EXPECT_EQ(alloc_count, 0);
+  EXPECT_TRUE(m.empty());
+  EXPECT_FALSE(m.contains(1));
+  EXPECT_EQ(m.find(1), m.end());
+  EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST_F(FlatHashMapTest, InsertFind) {
+  {
+    map m{};
+    for (int i = 0; i < 1000; ++i) {
+      EXPECT_TRUE(m.insert(i, i * 2).second);
+    }
+    EXPECT_FALSE(m.insert(5, 0).second);
+
+    EXPECT_EQ(m.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_EQ(m.at(i), i * 2);
+    }
+    EXPECT_FALSE(m.contains(1000));
+    EXPECT_THROW(m.at(1000), std::out_of_range);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(FlatHashMapTest, Erase) {
+  map m{};
+  for (int i = 0; i < 1000; ++i) {
+    m[i] = i;
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(m.erase(i));
+  }
+  EXPECT_FALSE(m.erase(0));
+
+  EXPECT_EQ(m.size(), 500);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(m.contains(i), i % 2 == 1);
+  }
+}
+
+TEST_F(FlatHashMapTest, Churn) {
+  map m{};
+  std::unordered_map<int, int> reference{};
+  unsigned state = 1;
+  for (int i = 0; i < 100000; ++i) {
+    state = state * 1103515245 + 12345;
+    const int key = static_cast<int>((state >> 8) % 512);
+    if (state & 1) {
+      m.insert_or_assign(key, i);
+      reference[key] = i;
+    } else {
+      EXPECT_EQ(m.erase(key), reference.erase(key) == 1);
+    }
+  }
+
+  EXPECT_EQ(m.size(), reference.size());
+  EXPECT_LE(m.capacity(), 2048);
+  for (const auto& [key, value] : m) {
+    EXPECT_EQ(reference.at(key), value);
+  }
+}
+
+TEST_F(FlatHashMapTest, NonTrivialEntries) {
+  simplecpp::FlatHashMap<std::string, std::string> m{};
+  for (int i = 0; i < 100; ++i) {
+    m.try_emplace(std::to_string(i), "value" + std::to_string(i));
+  }
+  auto copy = m;
+  m.clear();
+
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(copy.size(), 100);
+  EXPECT_EQ(copy.at("42"), "value42");
+  size_t count = 0;
+  for (auto it = copy.begin(); it != copy.end(); ++it) {
+    ++count;
+  }
+  EXPECT_EQ(count, 100);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/flat_map.h>
+
+#include <map>
+#include <string>
+
+using map = simplecpp::FlatMap<int, int>;
+
+map make_map(int n) {
+  simplecpp::Vector<std::pair<int, int>> entries{};
+  for (int i = 0; i < n; ++i) {
+    entries.push_back({i * 2, i});
+  }
+  return map(simplecpp::sorted_unique, std::move(entries));
+}
+
+TEST(FlatMapTest, LowerBoundMatchesAcrossLayouts) {
+  for (int n = 0; n < 70; ++n) {
+    map m = make_map(n);
+    map frozen = make_map(n);
+    frozen.freeze();
+
+    EXPECT_TRUE(frozen.is_frozen());
+    for (int key = -1; key <= 2 * n + 1; ++key) {
+      ASSERT_EQ(m.lower_bound(key) - m.begin(), frozen.lower_bound(key) - frozen.begin())
+          << "n = " << n << ", key = " << key;
+    }
+  }
+}
+
+TEST(FlatMapTest, Find) {
+  map m = make_map(1000);
+  m.freeze();
+
+  EXPECT_EQ(m.at(500), 250);
+  EXPECT_FALSE(m.contains(501));
+  EXPECT_EQ(m.find(501), m.end());
+  EXPECT_THROW(m.at(2000), std::out_of_range);
+}
+
+TEST(FlatMapTest, Range) {
+  map m = make_map(100);
+  m.freeze();
+  auto [first, last] = m.range(10, 20);
+
+  EXPECT_EQ(last - first, 5);
+  int expected = 10;
+  for (auto it = first; it != last; ++it) {
+    EXPECT_EQ(it->first, expected);
+    expected += 2;
+  }
+  EXPECT_EQ(m.upper_bound(10)->first, 12);
+}
+
+TEST(FlatMapTest, InsertUnfreezes) {
+  simplecpp::FlatMap<std::string, int> m{{"b", 2}, {"a", 1}, {"c", 3}, {"a", 4}};
+  m.freeze();
+
+  EXPECT_EQ(m.size(), 3);
+  EXPECT_EQ(m.begin()->second, 1);
+  EXPECT_TRUE(m.insert("d", 4).second);
+  EXPECT_FALSE(m.insert("a", 5).second);
+  EXPECT_FALSE(m.is_frozen());
+  EXPECT_TRUE(m.erase("b"));
+  m.freeze();
+  EXPECT_EQ(m.at("d"), 4);
+  EXPECT_FALSE(m.contains("b"));
+}
+
+TEST(FlatMapTest, SortedRange) {
+  std::map<int, int> source{{1, 1}, {3, 3}, {5, 5}};
+  simplecpp::FlatMap<int, int> m(simplecpp::sorted_unique, source.begin(), source.end());
+  m.freeze();
+
+  EXPECT_EQ(m.size(), 3);
+  EXPECT_EQ(m.lower_bound(4)->first, 5);
+  EXPECT_EQ(m.lower_bound(6), m.end());
+}
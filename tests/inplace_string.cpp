@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/inplace_string.h>
+
+#include <cstring>
+#include <string_view>
+
+using str = simplecpp::InplaceString<8>;
+
+constexpr str constexpr_concat() {
+  str s{"abc"};
+  s += "def";
+  s.pop_back();
+  return s;
+}
+
+static_assert(constexpr_concat() == "abcde");
+
+TEST(InplaceStringTest, Append) {
+  str s{"hello"};
+  s.push_back(' ');
+  s.append("w");
+
+  EXPECT_EQ(s, "hello w");
+  EXPECT_EQ(std::strlen(s.c_str()), 7);
+  EXPECT_THROW(s.append("orld"), std::length_error);
+  EXPECT_EQ(s.size(), 7);
+}
+
+TEST(InplaceStringTest, TryAppend) {
+  str s{"hello"};
+
+  EXPECT_FALSE(s.try_append(" world"));
+  EXPECT_EQ(s, "hello wo");
+  EXPECT_TRUE(s.full());
+  EXPECT_STREQ(s.c_str(), "hello wo");
+}
+
+TEST(InplaceStringTest, Compare) {
+  str a{"abc"};
+  str b{"abd"};
+
+  EXPECT_LT(a, b);
+  EXPECT_NE(a, b);
+  EXPECT_THROW(str{"too long string"}, std::length_error);
+  EXPECT_THROW(a.at(3), std::out_of_range);
+}
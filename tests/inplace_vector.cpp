@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/inplace_vector.h>
+#include <SimpleCPP/pointer.h>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using vec = simplecpp::InplaceVector<int, 4>;
+
+constexpr int constexpr_sum() {
+  vec v{1, 2};
+  v.push_back(3);
+  v.erase(v.begin());
+  int sum = 0;
+  for (const auto i : v) {
+    sum += i;
+  }
+  return sum;
+}
+
+static_assert(constexpr_sum() == 5);
+static_assert(std::is_trivially_copyable_v<vec>);
+
+TEST(InplaceVectorTest, PushBack) {
+  vec v{};
+  for (int i = 0; i < 4; ++i) {
+    v.push_back(i);
+  }
+
+  EXPECT_TRUE(v.full());
+  EXPECT_EQ(v.back(), 3);
+  EXPECT_THROW(v.push_back(4), std::length_error);
+  EXPECT_FALSE(v.try_push_back(4));
+  EXPECT_EQ(v.size(), 4);
+}
+
+TEST(InplaceVectorTest, At) {
+  vec v{1, 2, 3};
+
+  EXPECT_EQ(v.at(2), 3);
+  EXPECT_THROW(v.at(3), std::out_of_range);
+  EXPECT_THROW((vec{1, 2, 3, 4, 5}), std::length_error);
+}
+
+TEST(InplaceVectorTest, NonTrivialElements) {
+  simplecpp::InplaceVector<std::string, 4> v{"a", "b"};
+  auto copy = v;
+  auto moved = std::move(v);
+  copy.pop_back();
+
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(moved.size(), 2);
+  EXPECT_EQ(moved[1], "b");
+  EXPECT_EQ(copy.size(), 1);
+}
+
+struct ThrowingMove {
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove&&) noexcept(false) {}
+  ThrowingMove& operator=(ThrowingMove&&) noexcept(false) { return *this; }
+};
+
+static_assert(std::is_nothrow_move_constructible_v<simplecpp::InplaceVector<std::string, 2>>);
+static_assert(std::is_nothrow_move_assignable_v<simplecpp::InplaceVector<std::string, 2>>);
+static_assert(!std::is_nothrow_move_constructible_v<simplecpp::InplaceVector<ThrowingMove, 2>>);
+static_assert(!std::is_nothrow_move_assignable_v<simplecpp::InplaceVector<ThrowingMove, 2>>);
+
+TEST(InplaceVectorTest, PointerPayload) {
+  simplecpp::Pointer<simplecpp::InplaceVector<int, 16>> p{};
+  p->push_back(1);
+  simplecpp::Pointer<simplecpp::InplaceVector<int, 16>> p2{p};
+
+  EXPECT_EQ(p2->size(), 1);
+  EXPECT_EQ((*p2)[0], 1);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/iobuf.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using iobuf = simplecpp::BasicIOBuf<alloc, dealloc>;
+using bytes = simplecpp::BasicBytes<alloc, dealloc>;
+
+class IOBufTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(IOBufTest, Empty) {
+  iobuf buf{};
+
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(buf.segment_count(), 0);
+  EXPECT_EQ(buf.headroom(), 0);
+  EXPECT_EQ(buf.tailroom(), 0);
+  EXPECT_TRUE(buf.coalesce().empty());
+  EXPECT_THROW(buf.trim_front(1), std::out_of_range);
+  EXPECT_EQ(alloc_count, 0);
+}
+
+TEST_F(IOBufTest, SharesSegments) {
+  {
+    const bytes body("<html>cached</html>");
+    iobuf response{};
+    response.append(body);
+    response.prepend(body.slice(0, 6));
+    response.append(body.slice(12, 19));
+
+    EXPECT_EQ(response, "<html><html>cached</html></html>");
+    EXPECT_EQ(response.segment_count(), 3);
+    EXPECT_EQ(body.get_ref_count(), 4);
+    EXPECT_EQ(response.tailroom(), 0);
+
+    iobuf copy = response;
+    copy.append(copy);
+    EXPECT_EQ(copy.size(), 2 * response.size());
+    EXPECT_EQ(body.get_ref_count(), 10);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(IOBufTest, HeadroomAndTailroom) {
+  {
+    iobuf buf(100, 16);
+    EXPECT_EQ(buf.headroom(), 16);
+    EXPECT_EQ(buf.tailroom(), 100);
+
+    buf.append("body");
+    buf.prepend("HEAD");
+    EXPECT_EQ(buf, "HEADbody");
+    EXPECT_EQ(buf.segment_count(), 1);
+    EXPECT_EQ(buf.headroom(), 12);
+    EXPECT_EQ(buf.tailroom(), 96);
+
+    buf.append(std::string(200, 'x'));
+    buf.prepend(std::string(20, 'y'));
+    EXPECT_EQ(buf.segment_count(), 3);
+    EXPECT_EQ(buf.size(), 228);
+
+    iobuf shared = buf;
+    EXPECT_EQ(buf.headroom(), 0);
+    EXPECT_EQ(buf.tailroom(), 0);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(IOBufTest, TrimSplitAndCoalesce) {
+  iobuf buf{};
+  buf.append(bytes("hello "));
+  buf.append(bytes("world"));
+  buf.append(bytes("!"));
+
+  bytes single = iobuf(buf).split_to(5).coalesce();
+  EXPECT_EQ(single, "hello");
+
+  iobuf head = buf.split_to(8);
+  EXPECT_EQ(head, "hello wo");
+  EXPECT_EQ(head.segment_count(), 2);
+  EXPECT_EQ(buf, "rld!");
+
+  buf.trim_front(3);
+  EXPECT_EQ(buf, "!");
+  EXPECT_EQ(buf.segment_count(), 1);
+
+  const size_t allocs = alloc_count;
+  const bytes merged = head.coalesce();
+  EXPECT_EQ(merged, "hello wo");
+  EXPECT_EQ(head.segment_count(), 1);
+  EXPECT_EQ(alloc_count, allocs + 1);
+  EXPECT_EQ(head.coalesce().data(), merged.data());
+}
+
+TEST_F(IOBufTest, WriteAndRead) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  {
+    iobuf out{};
+    out.append("HTTP/1.1 200 OK\r\n\r\n");
+    out.append(bytes("body"));
+    out.append(std::string(5000, 'z'));
+    const std::string expected = "HTTP/1.1 200 OK\r\n\r\nbody" + std::string(5000, 'z');
+
+    EXPECT_EQ(out.write_to(fds[1]), expected.size());
+    EXPECT_TRUE(out.empty());
+    close(fds[1]);
+
+    iobuf in(10, 0);
+    size_t total = 0;
+    while (auto read = in.read_from(fds[0], 3000)) {
+      if (*read == 0) {
+        break;
+      }
+      total += *read;
+    }
+    EXPECT_EQ(total, expected.size());
+    EXPECT_EQ(in, expected);
+    EXPECT_EQ(in.coalesce(), expected);
+    close(fds[0]);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(IOBufTest, NonBlocking) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  iobuf in{};
+
+  EXPECT_FALSE(in.read_from(fds[0]).has_value());
+  EXPECT_THROW(in.read_from(-1), std::system_error);
+  EXPECT_THROW(iobuf().append("x").write_to(-1), std::system_error);
+  close(fds[0]);
+  close(fds[1]);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/iobuf.h>
+#include <SimpleCPP/mapped_file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+
+size_t alloc_count;
+size_t dealloc_count;
+size_t largest_alloc;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  largest_alloc = std::max(largest_alloc, size);
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using mapped_file = simplecpp::BasicMappedFile<alloc, dealloc>;
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+    largest_alloc = 0;
+    char path[] = "/tmp/simplecpp_mapped_file_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    _path = path;
+    _contents = "header:" + std::string(10000, 'x') + ":trailer";
+    ASSERT_EQ(write(fd, _contents.data(), _contents.size()),
+              static_cast<ssize_t>(_contents.size()));
+    close(fd);
+  }
+
+  void TearDown() override { unlink(_path.c_str()); }
+
+  std::string _path;
+  std::string _contents;
+};
+
+TEST_F(MappedFileTest, Empty) {
+  mapped_file file{};
+
+  EXPECT_TRUE(file.empty());
+  EXPECT_EQ(file.get_ref_count(), 0);
+  EXPECT_TRUE(file.advise(mapped_file::Advice::kWillNeed));
+  EXPECT_THROW(file.slice(0, 1), std::out_of_range);
+
+  truncate(_path.c_str(), 0);
+  EXPECT_TRUE(mapped_file(_path).empty());
+  EXPECT_EQ(alloc_count, 0);
+}
+
+TEST_F(MappedFileTest, MissingFile) {
+  EXPECT_THROW(mapped_file("/nonexistent/simplecpp"), std::system_error);
+}
+
+TEST_F(MappedFileTest, MapsContents) {
+  mapped_file file(_path, true);
+
+  EXPECT_EQ(file.size(), _contents.size());
+  EXPECT_EQ(file, _contents);
+  EXPECT_EQ(file[0], 'h');
+  EXPECT_EQ(alloc_count, 1);
+  EXPECT_TRUE(file.advise(mapped_file::Advice::kSequential));
+  EXPECT_TRUE(file.advise(mapped_file::Advice::kWillNeed));
+  file.advise(mapped_file::Advice::kHugePage);
+}
+
+TEST_F(MappedFileTest, SlicesShareTheMapping) {
+  void* addr = nullptr;
+  size_t size = 0;
+  {
+    mapped_file trailer{};
+    {
+      mapped_file file(_path);
+      addr = const_cast<uint8_t*>(file.data());
+      size = file.size();
+      unlink(_path.c_str());
+
+      mapped_file header = file.split_to(7);
+      trailer = file.split_off(file.size() - 8);
+      EXPECT_EQ(header, "header:");
+      EXPECT_EQ(trailer, ":trailer");
+      EXPECT_EQ(file.slice(0, 3), "xxx");
+      EXPECT_EQ(file.get_ref_count(), 3);
+      EXPECT_TRUE(file.slice(100, 200).advise(mapped_file::Advice::kRandom));
+    }
+    EXPECT_EQ(trailer.get_ref_count(), 1);
+    EXPECT_EQ(trailer, ":trailer");
+    EXPECT_EQ(msync(addr, size, MS_ASYNC), 0);
+  }
+  EXPECT_EQ(msync(addr, size, MS_ASYNC), -1);
+  EXPECT_EQ(errno, ENOMEM);
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(MappedFileTest, IOBufSharesTheMapping) {
+  void* addr = nullptr;
+  size_t size = 0;
+  {
+    simplecpp::BasicIOBuf<alloc, dealloc> buf{};
+    {
+      mapped_file file(_path);
+      addr = const_cast<uint8_t*>(file.data());
+      size = file.size();
+      buf.append("<");
+      buf.append(file.slice(7, file.size() - 8).as_bytes());
+      buf.append(file.as_bytes().slice(file.size() - 8, file.size()));
+      buf.prepend(file.as_bytes().split_to(7));
+      EXPECT_EQ(file.get_ref_count(), 4);
+    }
+    EXPECT_EQ(buf, "header:<" + _contents.substr(7));
+    EXPECT_LT(largest_alloc, size);
+
+    buf.trim_front(8);
+    const auto body = buf.split_to(size - 15);
+    buf.for_each_segment([&](const auto& bytes) {
+      EXPECT_EQ(bytes, ":trailer");
+      EXPECT_EQ(bytes.data(), static_cast<const uint8_t*>(addr) + size - 8);
+      EXPECT_EQ(bytes.get_ref_count(), 2);
+    });
+    EXPECT_EQ(buf.coalesce().data(), static_cast<const uint8_t*>(addr) + size - 8);
+    EXPECT_EQ(body, std::string(10000, 'x'));
+    EXPECT_EQ(msync(addr, size, MS_ASYNC), 0);
+  }
+  EXPECT_EQ(msync(addr, size, MS_ASYNC), -1);
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
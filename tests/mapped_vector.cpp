@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/mapped_vector.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+using mapped_vector = simplecpp::MappedVector<uint64_t>;
+
+class MappedVectorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/simplecpp_mapped_vector_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    _path = path;
+  }
+
+  void TearDown() override { unlink(_path.c_str()); }
+
+  // Flips a byte of element index in the file, like a torn write would.
+  void corrupt(size_t index) {
+    const int fd = open(_path.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    const off_t offset = mapped_vector::kHeaderSize + index * sizeof(uint64_t);
+    uint8_t byte = 0;
+    ASSERT_EQ(pread(fd, &byte, 1, offset), 1);
+    byte ^= 0xff;
+    ASSERT_EQ(pwrite(fd, &byte, 1, offset), 1);
+    close(fd);
+  }
+
+  std::string _path;
+};
+
+TEST_F(MappedVectorTest, Empty) {
+  mapped_vector vector(_path);
+  EXPECT_TRUE(vector.empty());
+  EXPECT_GT(vector.capacity(), 0);
+  EXPECT_THROW(vector.at(0), std::out_of_range);
+}
+
+TEST_F(MappedVectorTest, SurvivesReopen) {
+  {
+    mapped_vector vector(_path);
+    for (uint64_t i = 0; i < 100000; ++i) {
+      vector.push_back(i * i);
+    }
+    EXPECT_EQ(vector.size(), 100000);
+    EXPECT_GE(vector.capacity(), 100000);
+    vector.sync();
+  }
+  mapped_vector vector(_path);
+  ASSERT_EQ(vector.size(), 100000);
+  for (uint64_t i = 0; i < 100000; ++i) {
+    ASSERT_EQ(vector[i], i * i);
+  }
+}
+
+TEST_F(MappedVectorTest, OnlySyncRecordsTheLength) {
+  {
+    mapped_vector vector(_path);
+    const uint64_t values[] = {1, 2, 3};
+    vector.append(values, 3);
+    vector.resize(5);
+    vector.sync();
+    vector.push_back(6);
+  }
+  mapped_vector vector(_path);
+  ASSERT_EQ(vector.size(), 5);
+  EXPECT_EQ(vector.at(2), 3);
+  EXPECT_EQ(vector.back(), 0);
+
+  vector.pop_back();
+  EXPECT_EQ(vector.size(), 4);
+  vector.clear();
+  EXPECT_TRUE(vector.empty());
+}
+
+TEST_F(MappedVectorTest, FallsBackToPreviousSync) {
+  {
+    mapped_vector vector(_path);
+    for (uint64_t i = 0; i < 100; ++i) {
+      vector.push_back(i);
+    }
+    vector.sync();
+    for (uint64_t i = 100; i < 150; ++i) {
+      vector.push_back(i);
+    }
+    vector.sync();
+  }
+  // Appended elements that did not reach the disk fail the newest checksum only.
+  corrupt(120);
+  {
+    mapped_vector vector(_path);
+    ASSERT_EQ(vector.size(), 100);
+    EXPECT_EQ(vector.back(), 99);
+  }
+}
+
+TEST_F(MappedVectorTest, CorruptElementsThrow) {
+  {
+    mapped_vector vector(_path);
+    vector.resize(64);
+    vector.sync();
+    vector.resize(128);
+    vector.sync();
+  }
+  corrupt(10);
+  EXPECT_THROW(mapped_vector vector(_path), std::runtime_error);
+
+  mapped_vector vector(_path, false);
+  EXPECT_EQ(vector.size(), 128);
+}
+
+TEST_F(MappedVectorTest, WrongElementType) {
+  { mapped_vector vector(_path); }
+  EXPECT_THROW(simplecpp::MappedVector<uint32_t> vector(_path), std::runtime_error);
+}
+
+TEST_F(MappedVectorTest, Move) {
+  mapped_vector vector(_path);
+  vector.push_back(7);
+  mapped_vector moved(std::move(vector));
+  EXPECT_EQ(moved.size(), 1);
+  EXPECT_EQ(moved[0], 7);
+  EXPECT_EQ(vector.size(), 0);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/pmap.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+
+using map = simplecpp::PMap<int, int>;
+
+size_t alloc_count;
+
+void* counting_alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void counting_dealloc(void* data) noexcept { free(data); }
+
+using counted_map =
+    simplecpp::PMap<int, int, std::hash<int>, std::equal_to<int>, counting_alloc, counting_dealloc>;
+
+struct CollidingHash {
+  size_t operator()(int key) const noexcept { return key % 4; }
+};
+
+TEST(PMapTest, Empty) {
+  map m{};
+
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.find(1), nullptr);
+  EXPECT_FALSE(m.erase(1));
+  EXPECT_THROW(m.at(1), std::out_of_range);
+}
+
+TEST(PMapTest, SetFindErase) {
+  map m{};
+  std::map<int, int> reference{};
+  uint64_t seed = 7;
+  for (int i = 0; i < 20000; ++i) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    const int key = seed % 5000;
+    if (seed % 4 == 0) {
+      EXPECT_EQ(m.erase(key), reference.erase(key) == 1);
+    } else {
+      EXPECT_EQ(m.set(key, i), reference.insert_or_assign(key, i).second);
+    }
+  }
+
+  ASSERT_EQ(m.size(), reference.size());
+  for (const auto& [key, value] : reference) {
+    ASSERT_EQ(m.at(key), value);
+  }
+  size_t visited = 0;
+  m.for_each([&](int key, int value) {
+    EXPECT_EQ(reference.at(key), value);
+    ++visited;
+  });
+  EXPECT_EQ(visited, reference.size());
+}
+
+TEST(PMapTest, SnapshotsShareNodes) {
+  counted_map v1{};
+  for (int i = 0; i < 100000; ++i) {
+    v1.set(i, i);
+  }
+  // Only the few nodes on the path to the key are copied, at most three allocations each, while
+  // copying the trie would take thousands.
+  alloc_count = 0;
+  counted_map v2 = v1.with(5, 50);
+  EXPECT_LT(alloc_count, 32);
+  alloc_count = 0;
+  counted_map v3 = v2.without(6);
+  EXPECT_LT(alloc_count, 32);
+
+  EXPECT_EQ(v1.at(5), 5);
+  EXPECT_EQ(v2.at(5), 50);
+  EXPECT_EQ(v3.at(5), 50);
+  EXPECT_TRUE(v2.contains(6));
+  EXPECT_FALSE(v3.contains(6));
+  EXPECT_EQ(v1.size(), 100000);
+  EXPECT_EQ(v3.size(), 99999);
+
+  v1.clear();
+  EXPECT_EQ(v2.at(99999), 99999);
+}
+
+TEST(PMapTest, FullHashCollisions) {
+  simplecpp::PMap<int, std::string, CollidingHash> m{{1, "a"}, {5, "b"}, {9, "c"}, {2, "d"}};
+
+  EXPECT_EQ(m.size(), 4);
+  EXPECT_EQ(m.at(5), "b");
+  auto snapshot = m;
+  EXPECT_TRUE(m.erase(5));
+  EXPECT_FALSE(m.contains(5));
+  EXPECT_EQ(m.at(9), "c");
+  EXPECT_TRUE(m.erase(1));
+  EXPECT_EQ(m.at(9), "c");
+  EXPECT_EQ(snapshot.at(5), "b");
+  EXPECT_EQ(snapshot.size(), 4);
+}
+
+TEST(PMapTest, SnapshotDroppedByAnotherThread) {
+  map m{};
+  for (int i = 0; i < 1000; ++i) {
+    m.set(i, i);
+  }
+  for (int round = 1; round <= 20; ++round) {
+    std::thread reader([snapshot = m, round]() mutable {
+      long sum = 0;
+      snapshot.for_each([&](int, int value) { sum += value; });
+      EXPECT_EQ(sum, 999 * 1000 / 2 + (round - 1) * 1000);
+      snapshot = map{};
+    });
+    // Copies the nodes the reader still shares and updates the ones it dropped in place.
+    for (int i = 0; i < 1000; ++i) {
+      m.set(i, m.at(i) + 1);
+    }
+    reader.join();
+  }
+  EXPECT_EQ(m.at(0), 20);
+}
@@ -124,4 +124,58 @@ TEST_F(PointerTest, ComparisonOperators) {
     EXPECT_TRUE(p3 < p2);
     EXPECT_TRUE(p3 < p2.get());
   }
-}
\ No newline at end of file
+}
+
+TEST_F(PointerTest, DestroysData) {
+  struct Counter {
+    size_t* count;
+    ~Counter() { ++*count; }
+  };
+  size_t destroyed = 0;
+  {
+    simplecpp::Pointer<Counter, alloc, dealloc> p2{nullptr};
+    {
+      simplecpp::Pointer<Counter, alloc, dealloc> p{Counter{&destroyed}};
+      destroyed = 0;
+      p2 = p;
+    }
+    EXPECT_EQ(destroyed, 0);
+  }
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST_F(PointerTest, Array) {
+  {
+    simplecpp::Pointer<int[], alloc, dealloc> p(5);
+
+    EXPECT_EQ(alloc_count, 1);
+    EXPECT_EQ(alloc_size, 2 * sizeof(size_t) + 5 * sizeof(int));
+    EXPECT_EQ(p.size(), 5);
+    EXPECT_EQ(p[4], 0);
+    p[4] = 7;
+
+    simplecpp::Pointer<int[], alloc, dealloc> p2 = p;
+    EXPECT_EQ(p.get_ref_count(), 2);
+    EXPECT_EQ(p2[4], 7);
+    EXPECT_TRUE(p == p2);
+
+    simplecpp::Pointer<int[], alloc, dealloc> empty{};
+    EXPECT_FALSE(empty.is_valid());
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+  }
+  EXPECT_EQ(alloc_count, 1);
+}
+
+TEST_F(PointerTest, ArrayDestroysElements) {
+  struct Counter {
+    size_t* count;
+    ~Counter() { ++*count; }
+  };
+  size_t destroyed = 0;
+  {
+    simplecpp::Pointer<Counter[], alloc, dealloc> p(3, Counter{&destroyed});
+    destroyed = 0;
+  }
+  EXPECT_EQ(destroyed, 3);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/pvector.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using pvector = simplecpp::PVector<int>;
+
+template <typename Vec>
+void expect_same(const Vec& v, const std::vector<int>& reference) {
+  ASSERT_EQ(v.size(), reference.size());
+  for (size_t i = 0; i < reference.size(); ++i) {
+    ASSERT_EQ(v[i], reference[i]) << "index " << i;
+  }
+  size_t i = 0;
+  v.for_each([&](int value) { ASSERT_EQ(value, reference[i++]); });
+  ASSERT_EQ(i, reference.size());
+}
+
+pvector make(int first, int count) {
+  pvector v{};
+  for (int i = 0; i < count; ++i) {
+    v.push_back(first + i);
+  }
+  return v;
+}
+
+std::vector<int> make_reference(int first, int count) {
+  std::vector<int> v{};
+  for (int i = 0; i < count; ++i) {
+    v.push_back(first + i);
+  }
+  return v;
+}
+
+TEST(PVectorTest, Empty) {
+  pvector v{};
+
+  EXPECT_TRUE(v.empty());
+  EXPECT_THROW(v.at(0), std::out_of_range);
+  EXPECT_TRUE(v.slice(0, 0).empty());
+  EXPECT_THROW(v.slice(0, 1), std::out_of_range);
+}
+
+TEST(PVectorTest, PushPopSet) {
+  pvector v = make(0, 100000);
+  std::vector<int> reference = make_reference(0, 100000);
+  expect_same(v, reference);
+
+  for (int i = 0; i < 100000; i += 7) {
+    v.set(i, -i);
+    reference[i] = -i;
+  }
+  for (int i = 0; i < 50000; ++i) {
+    v.pop_back();
+    reference.pop_back();
+  }
+  expect_same(v, reference);
+  EXPECT_EQ(v.back(), reference.back());
+  EXPECT_EQ(v.front(), 0);
+}
+
+TEST(PVectorTest, SnapshotsAreIndependent) {
+  pvector v1 = make(0, 5000);
+  pvector v2 = v1.with(10, -1);
+  pvector v3 = v2;
+  v3.push_back(5000);
+  v3.pop_back();
+  v3.pop_back();
+
+  EXPECT_EQ(v1[10], 10);
+  EXPECT_EQ(v2[10], -1);
+  EXPECT_EQ(v2.size(), 5000);
+  EXPECT_EQ(v3.size(), 4999);
+  EXPECT_EQ(v1.back(), 4999);
+}
+
+TEST(PVectorTest, Append) {
+  for (const int left : {0, 1, 31, 32, 33, 100, 1024, 1057, 40000}) {
+    for (const int right : {0, 1, 32, 33, 500, 1100, 33000}) {
+      pvector v = make(0, left);
+      const pvector other = make(left, right);
+      v.append(other);
+      expect_same(v, make_reference(0, left + right));
+      expect_same(other, make_reference(left, right));
+    }
+  }
+}
+
+TEST(PVectorTest, Slice) {
+  const pvector v = make(0, 40000);
+  const std::vector<int> reference = make_reference(0, 40000);
+  for (const auto& [first, last] : {std::pair{0, 40000}, {0, 1}, {5, 39990}, {1000, 1031},
+                                    {39990, 40000}, {32, 32800}, {12345, 12346}}) {
+    const pvector slice = v.slice(first, last);
+    expect_same(slice, std::vector<int>(reference.begin() + first, reference.begin() + last));
+  }
+}
+
+TEST(PVectorTest, RandomSplices) {
+  pvector v{};
+  std::vector<int> reference{};
+  uint64_t seed = 99;
+  for (int round = 0; round < 300; ++round) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    const size_t size = reference.size();
+    switch (seed % 4) {
+      case 0: {
+        const int count = seed >> 40 & 1023;
+        v.append(make(round * 10000, count));
+        const auto extra = make_reference(round * 10000, count);
+        reference.insert(reference.end(), extra.begin(), extra.end());
+        break;
+      }
+      case 1: {
+        const size_t first = (seed >> 8) % (size + 1);
+        const size_t last = first + (seed >> 24) % (size - first + 1);
+        v = v.slice(first, last);
+        reference = std::vector<int>(reference.begin() + first, reference.begin() + last);
+        break;
+      }
+      case 2:
+        v = v + v;
+        reference.insert(reference.end(), reference.begin(), reference.end());
+        if (reference.size() > 200000) {
+          v = v.slice(0, 100000);
+          reference.resize(100000);
+        }
+        break;
+      default:
+        for (int i = 0; i < 40 && !reference.empty(); ++i) {
+          v.pop_back();
+          reference.pop_back();
+        }
+        v.push_back(round);
+        reference.push_back(round);
+        if (!reference.empty()) {
+          const size_t index = (seed >> 16) % reference.size();
+          v.set(index, -round);
+          reference[index] = -round;
+        }
+    }
+    expect_same(v, reference);
+  }
+}
+
+TEST(PVectorTest, SnapshotDroppedByAnotherThread) {
+  pvector v = make(0, 5000);
+  for (int round = 1; round <= 20; ++round) {
+    std::thread reader([snapshot = v, round]() mutable {
+      long sum = 0;
+      snapshot.for_each([&](int value) { sum += value; });
+      EXPECT_EQ(sum, 4999L * 5000 / 2 + (round - 1) * 5000L);
+      snapshot = pvector{};
+    });
+    // Copies the nodes the reader still shares and updates the ones it dropped in place.
+    for (size_t i = 0; i < v.size(); ++i) {
+      v.set(i, v[i] + 1);
+    }
+    reader.join();
+  }
+  EXPECT_EQ(v[0], 20);
+}
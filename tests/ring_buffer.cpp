@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/ring_buffer.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+using ring = simplecpp::RingBuffer<int, 4>;
+
+constexpr int constexpr_drain() {
+  ring r{};
+  int sum = 0;
+  for (int i = 0; i < 10; ++i) {
+    if (r.full()) {
+      sum += r.front();
+      r.pop_front();
+    }
+    r.push_back(i);
+  }
+  return sum;
+}
+
+static_assert(constexpr_drain() == 0 + 1 + 2 + 3 + 4 + 5);
+
+TEST(RingBufferTest, Wraparound) {
+  ring r{};
+  for (int i = 0; i < 4; ++i) {
+    r.push_back(i);
+  }
+  r.pop_front();
+  r.pop_front();
+  r.push_back(4);
+  r.push_back(5);
+
+  EXPECT_TRUE(r.full());
+  EXPECT_EQ(r.front(), 2);
+  EXPECT_EQ(r.back(), 5);
+  EXPECT_EQ(r[3], 5);
+  EXPECT_THROW(r.push_back(6), std::length_error);
+  EXPECT_FALSE(r.try_push_back(6));
+}
+
+TEST(RingBufferTest, TryPopFront) {
+  simplecpp::RingBuffer<std::string, 2> r{};
+  r.push_back("a");
+  std::string out;
+
+  EXPECT_TRUE(r.try_pop_front(out));
+  EXPECT_EQ(out, "a");
+  EXPECT_FALSE(r.try_pop_front(out));
+  EXPECT_EQ(out, "a");
+  EXPECT_THROW(r.at(0), std::out_of_range);
+}
+
+struct ThrowingMove {
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove&&) noexcept(false) {}
+};
+
+static_assert(std::is_nothrow_move_constructible_v<simplecpp::RingBuffer<std::string, 2>>);
+static_assert(!std::is_nothrow_move_constructible_v<simplecpp::RingBuffer<ThrowingMove, 2>>);
+
+TEST(RingBufferTest, Move) {
+  ring r{};
+  for (int i = 0; i < 6; ++i) {
+    r.try_push_back(i);
+    if (i == 2) {
+      r.pop_front();
+    }
+  }
+  ring moved{std::move(r)};
+  EXPECT_EQ(moved.size(), 4);
+  EXPECT_EQ(moved.front(), 1);
+  EXPECT_EQ(moved.back(), 4);
+
+  simplecpp::RingBuffer<std::string, 3> strings{};
+  strings.push_back("a");
+  strings.push_back("b");
+  simplecpp::RingBuffer<std::string, 3> assigned{};
+  assigned.push_back("c");
+  assigned = std::move(strings);
+  EXPECT_TRUE(strings.empty());
+  ASSERT_EQ(assigned.size(), 2);
+  EXPECT_EQ(assigned[1], "b");
+}
+
+TEST(RingBufferTest, MoveOnlyElements) {
+  simplecpp::RingBuffer<std::unique_ptr<int>, 2> r{};
+  r.push_back(std::make_unique<int>(1));
+  r.push_back(std::make_unique<int>(2));
+  r.pop_front();
+  r.push_back(std::make_unique<int>(3));
+
+  auto moved = std::move(r);
+  EXPECT_TRUE(r.empty());
+  ASSERT_EQ(moved.size(), 2);
+  EXPECT_EQ(*moved.front(), 2);
+  EXPECT_EQ(*moved.back(), 3);
+
+  r = std::move(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(*r[1], 3);
+}
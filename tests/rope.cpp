@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/rope.h>
+
+#include <cstdint>
+#include <string>
+
+std::string make_text(size_t size) {
+  std::string text(size, ' ');
+  for (size_t i = 0; i < size; ++i) {
+    text[i] = static_cast<char>('a' + i % 26);
+  }
+  return text;
+}
+
+TEST(RopeTest, Empty) {
+  simplecpp::Rope rope{};
+
+  EXPECT_TRUE(rope.empty());
+  EXPECT_EQ(rope.size(), 0);
+  EXPECT_EQ(rope, "");
+  EXPECT_THROW(rope.at(0), std::out_of_range);
+  EXPECT_THROW(rope.insert(1, "a"), std::out_of_range);
+}
+
+TEST(RopeTest, BuildIsBalanced) {
+  const std::string text = make_text(1 << 20);
+  simplecpp::Rope rope(text);
+
+  EXPECT_EQ(rope.size(), text.size());
+  EXPECT_EQ(rope, text);
+  EXPECT_LE(rope.height(), 12);
+  EXPECT_EQ(rope[500000], text[500000]);
+  EXPECT_EQ(std::string_view(rope.to_string()), text);
+}
+
+TEST(RopeTest, EditsMatchString) {
+  std::string reference = make_text(10000);
+  simplecpp::Rope rope(reference);
+  uint64_t seed = 42;
+  for (int i = 0; i < 2000; ++i) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    const size_t pos = seed % (reference.size() + 1);
+    if (seed % 3 == 0) {
+      const size_t count = (seed >> 8) % 50;
+      rope.erase(pos, count);
+      reference.erase(pos, count);
+    } else {
+      const std::string str(1 + (seed >> 8) % 20, static_cast<char>('A' + i % 26));
+      rope.insert(pos, str);
+      reference.insert(pos, str);
+    }
+  }
+
+  EXPECT_EQ(rope.size(), reference.size());
+  EXPECT_EQ(rope, reference);
+  EXPECT_LE(rope.height(), 40);
+}
+
+TEST(RopeTest, Substr) {
+  const std::string text = make_text(5000);
+  simplecpp::Rope rope(text);
+
+  EXPECT_EQ(rope.substr(1000, 2500), text.substr(1000, 2500));
+  EXPECT_EQ(rope.substr(4990), text.substr(4990));
+  EXPECT_EQ(rope.substr(5000), "");
+  EXPECT_THROW(rope.substr(5001), std::out_of_range);
+}
+
+TEST(RopeTest, SnapshotsAreIndependent) {
+  simplecpp::Rope rope(make_text(100000));
+  simplecpp::Rope snapshot = rope;
+  rope.insert(50000, "inserted");
+  rope.erase(0, 10);
+
+  EXPECT_EQ(snapshot, make_text(100000));
+  EXPECT_EQ(rope.size(), 100000 - 2);
+  EXPECT_EQ(rope.substr(49990, 8), "inserted");
+
+  simplecpp::Rope doubled = snapshot;
+  doubled.append(snapshot);
+  EXPECT_EQ(doubled.size(), 200000);
+  EXPECT_EQ(doubled[150000], snapshot[50000]);
+}
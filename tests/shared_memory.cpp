@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/shared_memory.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <new>
+#include <string>
+#include <system_error>
+
+using simplecpp::RelativePtr;
+using simplecpp::SegmentPointer;
+using simplecpp::SegmentVector;
+using simplecpp::SharedSegment;
+
+struct Record {
+  Record(int id, int value) : id(id), value(value) {}
+
+  int id;
+  int value;
+  RelativePtr<Record> next;
+};
+
+using records = SegmentVector<SegmentPointer<Record>>;
+
+class SharedMemoryTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kSize = 1 << 20;
+};
+
+TEST_F(SharedMemoryTest, RelativePtr) {
+  int values[2] = {1, 2};
+  RelativePtr<int> ptr;
+  EXPECT_FALSE(ptr);
+  EXPECT_EQ(ptr.get(), nullptr);
+
+  ptr = &values[1];
+  EXPECT_TRUE(ptr);
+  EXPECT_EQ(*ptr, 2);
+
+  RelativePtr<int> copy(ptr);
+  EXPECT_EQ(copy.get(), &values[1]);
+  EXPECT_EQ(copy, ptr);
+
+  copy = nullptr;
+  EXPECT_FALSE(copy);
+}
+
+TEST_F(SharedMemoryTest, AllocateReusesFreedBlocks) {
+  SharedSegment segment = SharedSegment::create(kSize);
+  EXPECT_GE(segment.size(), kSize);
+
+  void* first = segment.allocate(100);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 16, 0);
+  void* second = segment.allocate(100);
+  EXPECT_NE(first, second);
+  const size_t used = segment.used();
+
+  SharedSegment::deallocate(first);
+  EXPECT_EQ(segment.allocate(128), first);
+  EXPECT_EQ(segment.used(), used);
+
+  SharedSegment::deallocate(first);
+  SharedSegment::deallocate(second);
+}
+
+TEST_F(SharedMemoryTest, AllocateThrowsWhenFull) {
+  SharedSegment segment = SharedSegment::create(4096);
+  EXPECT_THROW(segment.allocate(4096), std::bad_alloc);
+  EXPECT_THROW(segment.allocate(SIZE_MAX / 2), std::bad_alloc);
+  EXPECT_NO_THROW(SharedSegment::deallocate(segment.allocate(1024)));
+}
+
+TEST_F(SharedMemoryTest, SegmentPointer) {
+  SharedSegment segment = SharedSegment::create(kSize);
+  SegmentPointer<Record> empty;
+  EXPECT_FALSE(empty.is_valid());
+  EXPECT_EQ(empty.get_ref_count(), 0);
+
+  size_t used = 0;
+  {
+    auto ptr = SegmentPointer<Record>::make(segment, 1, 10);
+    used = segment.used();
+    EXPECT_TRUE(ptr.is_valid());
+    EXPECT_EQ(ptr->value, 10);
+    EXPECT_EQ(ptr.get_ref_count(), 1);
+
+    auto copy = ptr;
+    EXPECT_EQ(copy, ptr);
+    EXPECT_EQ(ptr.get_ref_count(), 2);
+
+    auto moved = std::move(copy);
+    EXPECT_FALSE(copy.is_valid());
+    EXPECT_EQ(moved.get_ref_count(), 2);
+  }
+  // The last release freed the block, so the next object of the same size reuses it.
+  auto again = SegmentPointer<Record>::make(segment, 2, 20);
+  EXPECT_EQ(segment.used(), used);
+}
+
+TEST_F(SharedMemoryTest, VectorGrowsInSegment) {
+  SharedSegment segment = SharedSegment::create(kSize);
+  auto vector = segment.construct<SegmentVector<int>>();
+  EXPECT_TRUE(vector->empty());
+  for (int i = 0; i < 1000; ++i) {
+    vector->push_back(i);
+  }
+  EXPECT_EQ(vector->size(), 1000);
+  EXPECT_GE(vector->capacity(), 1000);
+  EXPECT_EQ(vector->at(999), 999);
+  EXPECT_THROW(vector->at(1000), std::out_of_range);
+  const auto data = reinterpret_cast<const uint8_t*>(vector->data());
+  const auto base = static_cast<const uint8_t*>(segment.base());
+  EXPECT_GE(data, base);
+  EXPECT_LT(data, base + segment.size());
+
+  vector->pop_back();
+  EXPECT_EQ(vector->size(), 999);
+  SharedSegment::destroy(vector);
+}
+
+TEST_F(SharedMemoryTest, MappedAtAnotherAddress) {
+  SharedSegment segment = SharedSegment::create(kSize);
+  auto list = segment.construct<records>();
+  segment.set_root(list);
+  for (int i = 0; i < 100; ++i) {
+    list->push_back(SegmentPointer<Record>::make(segment, i, i * i));
+    if (i != 0) {
+      (*list)[i]->next = (*list)[i - 1].get();
+    }
+  }
+
+  SharedSegment other = SharedSegment::attach(segment.fd());
+  ASSERT_NE(other.base(), segment.base());
+  auto view = other.root<records>();
+  ASSERT_NE(view, nullptr);
+  EXPECT_EQ(other.offset_of(view), segment.offset_of(list));
+  ASSERT_EQ(view->size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ((*view)[i]->id, i);
+    EXPECT_EQ((*view)[i]->value, i * i);
+    EXPECT_EQ((*view)[i].get_ref_count(), 1);
+    if (i != 0) {
+      EXPECT_EQ((*view)[i]->next->id, i - 1);
+    }
+  }
+
+  // Growing through the second mapping allocates from the same segment.
+  for (int i = 100; i < 200; ++i) {
+    view->push_back(SegmentPointer<Record>::make(other, i, -i));
+  }
+  ASSERT_EQ(list->size(), 200);
+  EXPECT_EQ((*list)[150]->value, -150);
+  EXPECT_EQ((*list)[50]->value, 2500);
+
+  SharedSegment::destroy(view);
+  other.set_root(nullptr);
+  EXPECT_EQ(segment.root<records>(), nullptr);
+}
+
+TEST_F(SharedMemoryTest, AttachRejectsOtherFiles) {
+  char path[] = "/tmp/simplecpp_shared_memory_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  unlink(path);
+  ASSERT_EQ(ftruncate(fd, 4096), 0);
+  EXPECT_THROW(SharedSegment::attach(fd), std::system_error);
+  close(fd);
+}
+
+TEST_F(SharedMemoryTest, Named) {
+  const std::string name = "/simplecpp_test_" + std::to_string(getpid());
+  SharedSegment::unlink(name.c_str());
+  SharedSegment segment = SharedSegment::create(name.c_str(), kSize);
+  EXPECT_THROW(SharedSegment::create(name.c_str(), kSize), std::system_error);
+  auto ptr = SegmentPointer<Record>::make(segment, 7, 49);
+  segment.set_root(ptr.get());
+
+  SharedSegment opened = SharedSegment::open(name.c_str());
+  EXPECT_EQ(opened.root<Record>()->value, 49);
+  SharedSegment::unlink(name.c_str());
+  EXPECT_THROW(SharedSegment::open(name.c_str()), std::system_error);
+}
+
+TEST_F(SharedMemoryTest, ProcessesShareReferenceCounts) {
+  constexpr int kIterations = 20000;
+  SharedSegment segment = SharedSegment::create(kSize);
+  auto list = segment.construct<records>();
+  list->push_back(SegmentPointer<Record>::make(segment, 0, 0));
+  segment.set_root(list);
+
+  // Both processes copy the same pointer and allocate from the segment at the same time.
+  auto churn = [](SharedSegment& mapping, int id) {
+    auto& shared = mapping.root<records>()->at(0);
+    for (int i = 0; i < kIterations; ++i) {
+      SegmentPointer<Record> copy = shared;
+      auto own = SegmentPointer<Record>::make(mapping, id, i);
+      if (copy.get_ref_count() < 2 || own->value != i) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    SharedSegment mapping = SharedSegment::attach(segment.fd());
+    _exit(churn(mapping, 1) ? 0 : 1);
+  }
+  EXPECT_TRUE(churn(segment, 2));
+  int status = 0;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+
+  EXPECT_EQ((*list)[0].get_ref_count(), 1);
+  SharedSegment::destroy(list);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/shared_string.h>
+
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using string = simplecpp::BasicSharedString<alloc, dealloc>;
+
+class SharedStringTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(SharedStringTest, Empty) {
+  static_assert(sizeof(string) == sizeof(void*));
+  string s{};
+  string from_view("");
+
+  EXPECT_TRUE(s.empty());
+  EXPECT_STREQ(s.c_str(), "");
+  EXPECT_EQ(s, from_view);
+  EXPECT_EQ(s.hash(), std::hash<std::string_view>{}(""));
+  EXPECT_EQ(alloc_count, 0);
+}
+
+TEST_F(SharedStringTest, CopiesShareTheBlock) {
+  {
+    string s("metric.label");
+    string copy = s;
+    string moved = std::move(copy);
+
+    EXPECT_EQ(alloc_count, 1);
+    EXPECT_EQ(s.get_ref_count(), 2);
+    EXPECT_TRUE(is_same(s, moved));
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(s, "metric.label");
+    EXPECT_EQ(s.c_str()[s.size()], '\0');
+    EXPECT_EQ(s.hash(), std::hash<std::string_view>{}("metric.label"));
+  }
+  EXPECT_EQ(dealloc_count, 1);
+}
+
+TEST_F(SharedStringTest, Compare) {
+  simplecpp::SharedString a("a");
+  simplecpp::SharedString b("b");
+  simplecpp::SharedString other_a("a");
+
+  EXPECT_EQ(a, other_a);
+  EXPECT_FALSE(is_same(a, other_a));
+  EXPECT_NE(a, b);
+  EXPECT_LT(a, b);
+
+  std::unordered_set<simplecpp::SharedString> set{a, b, other_a};
+  EXPECT_EQ(set.size(), 2);
+}
+
+TEST_F(SharedStringTest, Intern) {
+  {
+    simplecpp::BasicInternTable<alloc, dealloc> table{};
+    string a = table.intern("host");
+    string b = table.intern(std::string("ho") + "st");
+    string c = table.intern("port");
+
+    EXPECT_TRUE(is_same(a, b));
+    EXPECT_FALSE(is_same(a, c));
+    EXPECT_EQ(table.size(), 2);
+
+    string existing("region");
+    string interned = table.intern(existing);
+    EXPECT_TRUE(is_same(existing, interned));
+    EXPECT_TRUE(is_same(table.intern("region"), existing));
+
+    c = string();
+    EXPECT_EQ(table.purge(), 1);
+    EXPECT_EQ(table.size(), 2);
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(SharedStringTest, ConcurrentIntern) {
+  simplecpp::InternTable table{};
+  std::vector<std::thread> threads{};
+  std::vector<std::vector<simplecpp::SharedString>> results(4);
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 1000; ++i) {
+        results[t].push_back(table.intern("key" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(table.size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(is_same(results[0][i], results[3][i]));
+  }
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <SimpleCPP/slot_map.h>
+
+#include <string>
+
+using slot_map = simplecpp::SlotMap<std::string>;
+
+TEST(SlotMapTest, InsertAndGet) {
+  slot_map m{};
+  auto a = m.insert("a");
+  auto b = m.emplace(3, 'b');
+
+  EXPECT_EQ(m.size(), 2);
+  EXPECT_EQ(m.at(a), "a");
+  EXPECT_EQ(m[b], "bbb");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(simplecpp::SlotHandle::from_bits(b.to_bits()), b);
+  EXPECT_FALSE(m.contains(simplecpp::SlotHandle()));
+}
+
+TEST(SlotMapTest, EraseDetectsStaleHandles) {
+  slot_map m{};
+  auto a = m.insert("a");
+  auto b = m.insert("b");
+
+  EXPECT_TRUE(m.erase(a));
+  EXPECT_FALSE(m.erase(a));
+  EXPECT_EQ(m.get(a), nullptr);
+  EXPECT_THROW(m.at(a), std::out_of_range);
+  EXPECT_EQ(m.at(b), "b");
+
+  // The slot is reused with a new generation, so the old handle stays stale.
+  auto c = m.insert("c");
+  EXPECT_EQ(c.index(), a.index());
+  EXPECT_NE(c.generation(), a.generation());
+  EXPECT_FALSE(m.contains(a));
+  EXPECT_EQ(m.at(c), "c");
+}
+
+TEST(SlotMapTest, ValuesStayDense) {
+  simplecpp::SlotMap<int> m{};
+  simplecpp::Vector<simplecpp::SlotHandle> handles{};
+  for (int i = 0; i < 100; ++i) {
+    handles.push_back(m.insert(i));
+  }
+  for (int i = 0; i < 100; i += 2) {
+    m.erase(handles[i]);
+  }
+
+  EXPECT_EQ(m.end() - m.begin(), 50);
+  int sum = 0;
+  for (int value : m) {
+    EXPECT_EQ(value % 2, 1);
+    sum += value;
+  }
+  EXPECT_EQ(sum, 2500);
+  for (size_t i = 0; i < m.size(); ++i) {
+    EXPECT_EQ(m[m.handle_at(i)], m.begin()[i]);
+  }
+  for (int i = 1; i < 100; i += 2) {
+    EXPECT_EQ(m.at(handles[i]), i);
+  }
+}
+
+TEST(SlotMapTest, Extract) {
+  slot_map m{};
+  auto a = m.insert("shared");
+  auto pointer = m.extract(a);
+
+  EXPECT_TRUE(pointer.is_valid());
+  EXPECT_EQ(*pointer, "shared");
+  EXPECT_TRUE(m.empty());
+  EXPECT_FALSE(m.extract(a).is_valid());
+}
+
+TEST(SlotMapTest, Clear) {
+  slot_map m{};
+  auto a = m.insert("a");
+  m.insert("b");
+  m.clear();
+
+  EXPECT_TRUE(m.empty());
+  EXPECT_FALSE(m.contains(a));
+  auto c = m.insert("c");
+  EXPECT_EQ(m.size(), 1);
+  EXPECT_EQ(m.at(c), "c");
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/small_vector.h>
+
+#include <string>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using vec = simplecpp::SmallVector<int, 8, alloc, dealloc>;
+
+class SmallVectorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(SmallVectorTest, InlineStorage) {
+  vec v{};
+  for (int i = 0; i < 8; ++i) {
+    v.push_back(i);
+  }
+
+  EXPECT_EQ(alloc_count, 0);
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(v.size(), 8);
+  EXPECT_EQ(v.capacity(), 8);
+  EXPECT_EQ(v.back(), 7);
+}
+
+TEST_F(SmallVectorTest, Spill) {
+  {
+    vec v{};
+    for (int i = 0; i < 100; ++i) {
+      v.push_back(i);
+    }
+
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(v.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(v[i], i);
+    }
+  }
+  EXPECT_GE(alloc_count, 1);
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(SmallVectorTest, ShrinkToFit) {
+  vec v(20, 1);
+  v.resize(3);
+  v.shrink_to_fit();
+
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(v, (vec{1, 1, 1}));
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(SmallVectorTest, MoveInline) {
+  simplecpp::SmallVector<std::string, 4> v{"a", "b"};
+  simplecpp::SmallVector<std::string, 4> moved{std::move(v)};
+
+  EXPECT_TRUE(moved.is_inline());
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(moved.size(), 2);
+  EXPECT_EQ(moved[1], "b");
+}
+
+TEST_F(SmallVectorTest, MoveHeap) {
+  vec v(20, 1);
+  const int* data = v.data();
+  vec moved{std::move(v)};
+
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(alloc_count, 1);
+}
+
+TEST_F(SmallVectorTest, Copy) {
+  simplecpp::SmallVector<std::string, 2> v{"a", "b", "c"};
+  simplecpp::SmallVector<std::string, 2> copy{};
+  copy = v;
+  copy.push_back(copy[0]);
+
+  EXPECT_EQ(copy.size(), 4);
+  EXPECT_EQ(copy.back(), "a");
+  EXPECT_EQ(v.size(), 3);
+}
+
+TEST_F(SmallVectorTest, InsertErase) {
+  vec v{1, 2, 4};
+  v.insert(v.begin() + 2, 3);
+  v.erase(v.begin());
+
+  EXPECT_EQ(v, (vec{2, 3, 4}));
+  EXPECT_THROW(v.at(3), std::out_of_range);
+}
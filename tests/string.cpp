@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/pointer.h>
+#include <SimpleCPP/string.h>
+#include <SimpleCPP/vector.h>
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using string = simplecpp::BasicString<23, alloc, dealloc>;
+
+class StringTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(StringTest, Layout) {
+  EXPECT_EQ(sizeof(simplecpp::String), 24);
+  EXPECT_EQ(sizeof(simplecpp::BasicString<31>), 32);
+  EXPECT_TRUE(simplecpp::is_trivially_relocatable_v<simplecpp::String>);
+}
+
+TEST_F(StringTest, ShortStringsStayInline) {
+  {
+    string empty{};
+    string full("abcdefghijklmnopqrstuvw");
+
+    EXPECT_TRUE(empty.empty());
+    EXPECT_STREQ(empty.c_str(), "");
+    EXPECT_TRUE(full.is_inline());
+    EXPECT_EQ(full.size(), 23);
+    EXPECT_EQ(full.c_str()[23], '\0');
+    EXPECT_EQ(full, "abcdefghijklmnopqrstuvw");
+  }
+  EXPECT_EQ(alloc_count, 0);
+}
+
+TEST_F(StringTest, GrowsOntoTheHeap) {
+  {
+    string s("abcdefghijklmnopqrstuvw");
+    s.push_back('x');
+
+    EXPECT_FALSE(s.is_inline());
+    EXPECT_EQ(s, "abcdefghijklmnopqrstuvwx");
+    EXPECT_EQ(alloc_count, 1);
+
+    std::string reference = "abcdefghijklmnopqrstuvwx";
+    for (int i = 0; i < 100; ++i) {
+      s += "0123456789";
+      reference += "0123456789";
+    }
+    EXPECT_EQ(std::string_view(s), reference);
+    EXPECT_GE(s.capacity(), s.size());
+    EXPECT_EQ(s.c_str()[s.size()], '\0');
+
+    s.resize(5);
+    s.shrink_to_fit();
+    EXPECT_TRUE(s.is_inline());
+    EXPECT_EQ(s, "abcde");
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(StringTest, AppendSelf) {
+  string s("0123456789");
+  for (int i = 0; i < 4; ++i) {
+    s.append(s);
+  }
+
+  EXPECT_EQ(s.size(), 160);
+  EXPECT_EQ(s.substr(150), "0123456789");
+  s.assign(std::string_view(s).substr(10, 5));
+  EXPECT_EQ(s, "01234");
+}
+
+TEST_F(StringTest, CopyMove) {
+  {
+    string s(40, 'a');
+    string copy = s;
+    string moved = std::move(s);
+
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(copy, moved);
+    EXPECT_EQ(copy.size(), 40);
+
+    copy = string("short");
+    moved = copy;
+    EXPECT_EQ(moved, "short");
+    copy.swap(moved);
+    EXPECT_EQ(copy, "short");
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(StringTest, Compare) {
+  simplecpp::String a("apple");
+  simplecpp::String b("banana");
+
+  EXPECT_LT(a, b);
+  EXPECT_EQ(a + "s", "apples");
+  EXPECT_NE(a, b);
+  EXPECT_THROW(a.at(5), std::out_of_range);
+
+  std::unordered_set<simplecpp::String> set{a, b};
+  EXPECT_TRUE(set.contains("apple"));
+}
+
+TEST_F(StringTest, Shared) {
+  simplecpp::Vector<simplecpp::String> strings{};
+  for (int i = 0; i < 100; ++i) {
+    strings.push_back(simplecpp::String(std::to_string(i) + std::string(30, 'x')));
+  }
+  simplecpp::Pointer<simplecpp::String> shared(std::move(strings[42]));
+  auto other = shared;
+
+  EXPECT_EQ(other->substr(0, 2), "42");
+  EXPECT_EQ(shared.get_ref_count(), 2);
+  EXPECT_EQ(strings[99].substr(0, 2), "99");
+}
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/thread_pool.h>
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+std::atomic<size_t> alloc_count;
+std::atomic<size_t> dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using thread_pool = simplecpp::BasicThreadPool<alloc, dealloc>;
+using deque = simplecpp::detail::WorkStealingDeque<int*, alloc, dealloc>;
+
+class ThreadPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+long fib(thread_pool& pool, int n) {
+  if (n < 2) {
+    return n;
+  }
+  long left = 0;
+  thread_pool::Group group(pool);
+  group.run([&pool, &left, n] { left = fib(pool, n - 1); });
+  const long right = fib(pool, n - 2);
+  group.wait();
+  return left + right;
+}
+
+TEST_F(ThreadPoolTest, DequeOwner) {
+  deque tasks(2);
+  int values[100];
+  EXPECT_TRUE(tasks.empty());
+  EXPECT_EQ(tasks.pop(), nullptr);
+  EXPECT_EQ(tasks.steal(), nullptr);
+  for (int& value : values) {
+    tasks.push(&value);
+  }
+  EXPECT_FALSE(tasks.empty());
+  EXPECT_EQ(tasks.steal(), &values[0]);
+  EXPECT_EQ(tasks.pop(), &values[99]);
+  EXPECT_EQ(tasks.pop(), &values[98]);
+  EXPECT_EQ(tasks.steal(), &values[1]);
+}
+
+TEST_F(ThreadPoolTest, DequeStealsEveryValueOnce) {
+  constexpr int kCount = 100000;
+  std::vector<int> values(kCount);
+  std::vector<std::atomic<int>> seen(kCount);
+  deque tasks;
+  std::atomic<bool> done(false);
+  auto take = [&](int* value) { seen[value - values.data()].fetch_add(1); };
+
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; ++t) {
+    thieves.emplace_back([&] {
+      while (!done.load() || !tasks.empty()) {
+        if (int* value = tasks.steal()) {
+          take(value);
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kCount; ++i) {
+    tasks.push(&values[i]);
+    if (i % 3 == 0) {
+      if (int* value = tasks.pop()) {
+        take(value);
+      }
+    }
+  }
+  while (int* value = tasks.pop()) {
+    take(value);
+  }
+  done = true;
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_EQ(seen[i].load(), 1) << i;
+  }
+}
+
+TEST_F(ThreadPoolTest, Submit) {
+  std::atomic<int> count(0);
+  {
+    thread_pool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    for (int i = 0; i < 10000; ++i) {
+      pool.submit([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+    }
+  }
+  EXPECT_EQ(count.load(), 10000);
+  EXPECT_EQ(alloc_count.load(), dealloc_count.load());
+}
+
+TEST_F(ThreadPoolTest, GroupFromOutside) {
+  thread_pool pool(4);
+  std::vector<int> squares(1000);
+  thread_pool::Group group(pool);
+  for (int i = 0; i < 1000; ++i) {
+    group.run([&squares, i] { squares[i] = i * i; });
+  }
+  group.wait();
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(squares[i], i * i);
+  }
+}
+
+TEST_F(ThreadPoolTest, ForkJoin) {
+  thread_pool pool(4);
+  long result = 0;
+  thread_pool::Group group(pool);
+  group.run([&] { result = fib(pool, 22); });
+  group.wait();
+  EXPECT_EQ(result, 17711);
+}
+
+TEST_F(ThreadPoolTest, SingleWorkerForkJoin) {
+  thread_pool pool(1);
+  long result = 0;
+  thread_pool::Group group(pool);
+  group.run([&] { result = fib(pool, 15); });
+  group.wait();
+  EXPECT_EQ(result, 610);
+}
+
+TEST_F(ThreadPoolTest, SmallTasksDoNotAllocate) {
+  thread_pool pool(2);
+  auto burst = [&] {
+    thread_pool::Group outer(pool);
+    outer.run([&] {
+      thread_pool::Group inner(pool);
+      for (int i = 0; i < 1000; ++i) {
+        inner.run([] {});
+      }
+      inner.wait();
+    });
+    outer.wait();
+  };
+  for (int i = 0; i < 10; ++i) {
+    burst();
+  }
+  const size_t allocated = alloc_count.load();
+  for (int i = 0; i < 10; ++i) {
+    burst();
+  }
+  // Only the chunks of a Pool or deque that grows allocate, never a task on its own.
+  EXPECT_LT(alloc_count.load() - allocated, 10);
+}
+
+TEST_F(ThreadPoolTest, LargeCallables) {
+  std::atomic<int> sum(0);
+  {
+    thread_pool pool(2);
+    thread_pool::Group group(pool);
+    for (int i = 0; i < 100; ++i) {
+      std::array<int, 64> values{};
+      values.fill(i);
+      group.run([&sum, values] { sum.fetch_add(values[63]); });
+    }
+    group.wait();
+  }
+  EXPECT_EQ(sum.load(), 4950);
+  EXPECT_EQ(alloc_count.load(), dealloc_count.load());
+}
+
+TEST_F(ThreadPoolTest, GroupRethrows) {
+  thread_pool pool(2);
+  thread_pool::Group group(pool);
+  std::atomic<int> count(0);
+  for (int i = 0; i < 100; ++i) {
+    group.run([&count, i] {
+      count.fetch_add(1);
+      if (i == 50) {
+        throw std::runtime_error("task failed");
+      }
+    });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(count.load(), 100);
+  EXPECT_NO_THROW(group.wait());
+}
+
+TEST_F(ThreadPoolTest, WakesParkedWorkers) {
+  thread_pool pool(4);
+  for (int round = 0; round < 20; ++round) {
+    // Gives the workers time to park between rounds.
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::atomic<int> count(0);
+    thread_pool::Group group(pool);
+    for (int i = 0; i < 8; ++i) {
+      group.run([&count] { count.fetch_add(1); });
+    }
+    group.wait();
+    ASSERT_EQ(count.load(), 8);
+  }
+}
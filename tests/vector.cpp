@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+#include <SimpleCPP/vector.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+size_t alloc_count;
+size_t dealloc_count;
+
+void* alloc(const size_t& size) {
+  ++alloc_count;
+  auto data = malloc(size);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+void dealloc(void* data) noexcept {
+  ++dealloc_count;
+  free(data);
+}
+
+using vec = simplecpp::Vector<int, alloc, dealloc>;
+
+class VectorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    alloc_count = 0;
+    dealloc_count = 0;
+  }
+};
+
+TEST_F(VectorTest, DefaultConstructor) {
+  vec v{};
+
+  EXPECT_EQ(alloc_count, 0);
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.capacity(), 0);
+  EXPECT_EQ(v.data(), nullptr);
+}
+
+TEST_F(VectorTest, PushBack) {
+  {
+    vec v{};
+    for (int i = 0; i < 100; ++i) {
+      v.push_back(i);
+    }
+
+    EXPECT_EQ(v.size(), 100);
+    EXPECT_GE(v.capacity(), 100);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(v[i], i);
+    }
+  }
+  EXPECT_EQ(alloc_count, dealloc_count);
+}
+
+TEST_F(VectorTest, PushBackOwnElement) {
+  simplecpp::Vector<std::string> v{"a"};
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(v[0]);
+  }
+
+  EXPECT_EQ(v.size(), 11);
+  for (const auto& s : v) {
+    EXPECT_EQ(s, "a");
+  }
+}
+
+TEST_F(VectorTest, ReserveExact) {
+  vec v{};
+  v.reserve_exact(7);
+
+  EXPECT_EQ(v.capacity(), 7);
+  EXPECT_EQ(alloc_count, 1);
+  for (int i = 0; i < 7; ++i) {
+    v.push_back_unchecked(i);
+  }
+  EXPECT_EQ(v.size(), 7);
+  EXPECT_EQ(alloc_count, 1);
+  EXPECT_EQ(v.back(), 6);
+}
+
+TEST_F(VectorTest, GrowthFactor) {
+  simplecpp::Vector<int, alloc, dealloc, std::ratio<2>> v{};
+  v.reserve_exact(4);
+  v.resize(4);
+  v.push_back(0);
+
+  EXPECT_EQ(v.capacity(), 8);
+}
+
+TEST_F(VectorTest, Realloc) {
+  simplecpp::Vector<int> v{};
+  for (int i = 0; i < 10000; ++i) {
+    v.push_back(i);
+  }
+  v.shrink_to_fit();
+
+  EXPECT_EQ(v.capacity(), v.size());
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(v[i], i);
+  }
+}
+
+TEST_F(VectorTest, NonTrivialElements) {
+  simplecpp::Vector<std::string, alloc, dealloc> v{};
+  for (int i = 0; i < 50; ++i) {
+    v.emplace_back(std::to_string(i));
+  }
+  v.insert(v.begin(), "first");
+  v.erase(v.begin() + 1);
+
+  EXPECT_EQ(v.size(), 50);
+  EXPECT_EQ(v.front(), "first");
+  EXPECT_EQ(v[1], "1");
+  EXPECT_EQ(v.back(), "49");
+}
+
+TEST_F(VectorTest, CopyAndMove) {
+  vec v{1, 2, 3};
+  vec copy{v};
+  vec moved{std::move(v)};
+
+  EXPECT_EQ(copy, moved);
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.data(), nullptr);
+}
+
+TEST_F(VectorTest, At) {
+  vec v{1, 2, 3};
+
+  EXPECT_EQ(v.at(2), 3);
+  EXPECT_THROW(v.at(3), std::out_of_range);
+}
+
+struct ThrowingCopy {
+  static inline int copies_left = 0;
+  static inline int alive = 0;
+
+  explicit ThrowingCopy(int value) : value(value) { ++alive; }
+  ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("copy failed");
+    }
+    ++alive;
+  }
+  // Not noexcept, so growing must copy and keep the old elements.
+  ThrowingCopy(ThrowingCopy&& other) : ThrowingCopy(static_cast<const ThrowingCopy&>(other)) {}
+  ~ThrowingCopy() { --alive; }
+
+  int value;
+};
+
+TEST_F(VectorTest, ThrowingCopyLeavesVectorUnchanged) {
+  {
+    simplecpp::Vector<ThrowingCopy, alloc, dealloc> v{};
+    ThrowingCopy::copies_left = 1000;
+    v.reserve_exact(4);
+    for (int i = 0; i < 4; ++i) {
+      v.emplace_back(i);
+    }
+    ThrowingCopy::copies_left = 2;
+    EXPECT_THROW(v.emplace_back(4), std::runtime_error);
+    ThrowingCopy::copies_left = 2;
+    EXPECT_THROW(v.insert(v.begin() + 1, ThrowingCopy(9)), std::runtime_error);
+
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(v[i].value, i);
+    }
+    EXPECT_EQ(ThrowingCopy::alive, 4);
+  }
+  EXPECT_EQ(ThrowingCopy::alive, 0);
+  EXPECT_EQ(alloc_count, dealloc_count);
+}